@@ -0,0 +1,85 @@
+#include <common/Audio.hpp>
+
+#include <array>
+#include <chrono>
+#include <print>
+#include <string_view>
+#include <vector>
+
+static constexpr size_t SECTORS = 200'000;
+
+/** \brief A sector of sound groups with valid parameters, the samples are a pseudo-random sequence. */
+static constexpr std::array<uint8_t, Audio::SECTOR_DATA_SIZE> SECTOR = [] {
+    std::array<uint8_t, Audio::SECTOR_DATA_SIZE> sector{};
+    uint32_t seed = 1;
+    for(size_t i = 0; i < sector.size(); ++i)
+    {
+        seed = seed * 1'103'515'245 + 12'345;
+        sector[i] = seed >> 16;
+        if(i % 128 < 16) // Filter 0-3, range 0-7.
+            sector[i] &= 0x37;
+    }
+    return sector;
+}();
+
+/** \brief The sample by sample decoder, that appends to std::vector. */
+static void benchmarkReference(std::string_view name, const bool levelA, const bool stereo)
+{
+    Audio::SamplesDelay delay{};
+    std::vector<int16_t> left;
+    std::vector<int16_t> right;
+
+    // Benchmark
+    const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for(size_t s = 0; s < SECTORS; ++s)
+    {
+        left.clear();
+        right.clear();
+        Audio::decodeAudioSector(delay, levelA, stereo, SECTOR.data(), left, right);
+    }
+    const std::chrono::high_resolution_clock::time_point finish = std::chrono::high_resolution_clock::now();
+    const std::chrono::nanoseconds delta = finish - start;
+
+    std::println("{} {}  {}/sector  {}",
+        name,
+        std::chrono::duration_cast<std::chrono::microseconds>(delta),
+        delta / SECTORS,
+        std::chrono::duration_cast<std::chrono::milliseconds>(delta)
+    );
+}
+
+/** \brief The decoder that writes to std::span. */
+static void benchmarkSpan(std::string_view name, const bool levelA, const bool stereo)
+{
+    Audio::SamplesDelay delay{};
+    std::array<int16_t, Audio::LEVEL_BC_SECTOR_SAMPLES> left;
+    std::array<int16_t, Audio::LEVEL_BC_SECTOR_SAMPLES> right;
+
+    // Benchmark
+    const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for(size_t s = 0; s < SECTORS; ++s)
+    {
+        Audio::decodeAudioSector(delay, levelA, stereo, SECTOR, left, right);
+    }
+    const std::chrono::high_resolution_clock::time_point finish = std::chrono::high_resolution_clock::now();
+    const std::chrono::nanoseconds delta = finish - start;
+
+    std::println("{} {}  {}/sector  {}",
+        name,
+        std::chrono::duration_cast<std::chrono::microseconds>(delta),
+        delta / SECTORS,
+        std::chrono::duration_cast<std::chrono::milliseconds>(delta)
+    );
+}
+
+int main()
+{
+    benchmarkReference("Level A  mono   vector", true, false);
+    benchmarkSpan(     "Level A  mono   span  ", true, false);
+    benchmarkReference("Level A  stereo vector", true, true);
+    benchmarkSpan(     "Level A  stereo span  ", true, true);
+    benchmarkReference("Level BC mono   vector", false, false);
+    benchmarkSpan(     "Level BC mono   span  ", false, false);
+    benchmarkReference("Level BC stereo vector", false, true);
+    benchmarkSpan(     "Level BC stereo span  ", false, true);
+}
@@ -0,0 +1,90 @@
+#include <Video/PixelFormats.hpp>
+
+#include <chrono>
+#include <print>
+#include <string_view>
+#include <vector>
+
+static constexpr size_t WIDTH = 768;
+static constexpr size_t HEIGHT = 560;
+static constexpr size_t FRAMES = 2000;
+
+static const Video::Plane PLANE = [] {
+    Video::Plane plane{WIDTH, HEIGHT};
+    for(size_t i = 0; i < plane.size(); ++i)
+    {
+        plane[i] = i * 0x0102'0304;
+    }
+    return plane;
+}();
+
+/** \brief The byte loop splitARGB used before the converters, as a reference. */
+static void convertToRGB24Bytes(const Video::Plane& plane, std::vector<uint8_t>& dst)
+{
+    uint8_t* rgb = dst.data();
+    for(const Video::Pixel& pixel : plane.GetSpan())
+    {
+        *rgb++ = pixel.r;
+        *rgb++ = pixel.g;
+        *rgb++ = pixel.b;
+    }
+}
+
+static void benchmarkReference(std::string_view name)
+{
+    std::vector<uint8_t> dst(Video::getConvertedPlaneSize(Video::PixelFormat::RGB24, WIDTH, HEIGHT));
+
+    // Benchmark
+    const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for(size_t f = 0; f < FRAMES; ++f)
+    {
+        convertToRGB24Bytes(PLANE, dst);
+    }
+    const std::chrono::high_resolution_clock::time_point finish = std::chrono::high_resolution_clock::now();
+    const std::chrono::nanoseconds delta = finish - start;
+
+    std::println("{} {}  {}/f  {}",
+        name,
+        std::chrono::duration_cast<std::chrono::microseconds>(delta),
+        std::chrono::duration_cast<std::chrono::microseconds>(delta / FRAMES),
+        std::chrono::duration_cast<std::chrono::milliseconds>(delta)
+    );
+}
+
+static void benchmarkConversion(std::string_view name, const Video::PixelFormat format, const uint8_t scale)
+{
+    std::vector<uint8_t> dst(Video::getConvertedPlaneSize(format, WIDTH, HEIGHT, scale));
+    const size_t frames = FRAMES / (scale * scale);
+
+    // Benchmark
+    const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for(size_t f = 0; f < frames; ++f)
+    {
+        Video::convertPlane(PLANE, format, dst, scale);
+    }
+    const std::chrono::high_resolution_clock::time_point finish = std::chrono::high_resolution_clock::now();
+    const std::chrono::nanoseconds delta = finish - start;
+
+    std::println("{} x{} {}  {}/f  {}",
+        name,
+        scale,
+        std::chrono::duration_cast<std::chrono::microseconds>(delta),
+        std::chrono::duration_cast<std::chrono::microseconds>(delta / frames),
+        std::chrono::duration_cast<std::chrono::milliseconds>(delta)
+    );
+}
+
+int main()
+{
+    benchmarkReference("RGB24  bytes");
+
+    for(uint8_t scale = 1; scale <= Video::MAX_CONVERSION_SCALE; scale *= 2)
+    {
+        benchmarkConversion("RGB24 ", Video::PixelFormat::RGB24, scale);
+        benchmarkConversion("RGBA32", Video::PixelFormat::RGBA32, scale);
+        benchmarkConversion("BGRA32", Video::PixelFormat::BGRA32, scale);
+        benchmarkConversion("RGB565", Video::PixelFormat::RGB565, scale);
+        benchmarkConversion("YUV420", Video::PixelFormat::YUV420, scale);
+        benchmarkConversion("NV12  ", Video::PixelFormat::NV12, scale);
+    }
+}
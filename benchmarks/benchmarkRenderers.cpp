@@ -1,3 +1,4 @@
+#include <Video/RendererNull.hpp>
 #include <Video/RendererSIMD.hpp>
 #include <Video/RendererSoftware.hpp>
 
@@ -98,6 +99,7 @@ int main()
 
     benchmarkRenderer<Video::RendererSoftware, NORMAL_8, ICM(DYUV), ICM(DYUV)>("Normal Soft DYUV");
     IF_SIMD((benchmarkRenderer<Video::RendererSIMD, NORMAL_8, ICM(DYUV), ICM(DYUV)>("Normal SIMD DYUV")));
+    benchmarkRenderer<Video::RendererNull, NORMAL_8, ICM(DYUV), ICM(DYUV)>("Normal Null DYUV");
 
     benchmarkRenderer<Video::RendererSoftware, DOUBLE_4, ICM(DYUV), ICM(DYUV)>("Double Soft DYUV");
     IF_SIMD((benchmarkRenderer<Video::RendererSIMD, DOUBLE_4, ICM(DYUV), ICM(DYUV)>("Double SIMD DYUV")));
@@ -91,7 +91,7 @@ static void benchmarkDYUVLine(std::string_view name)
 }
 
 template<uint16_t (*DECODE)(Video::Pixel*, const uint8_t*, const uint32_t*, Video::ImageCodingMethod) noexcept>
-static void benchmarkCLUTLine(std::string_view name)
+static void benchmarkCLUTLine(std::string_view name, Video::ImageCodingMethod icm)
 {
     // Benchmark
     const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
@@ -99,7 +99,7 @@ static void benchmarkCLUTLine(std::string_view name)
     {
         for(size_t y = 0; y < HEIGHT; ++y)
         {
-            DECODE(DST.data(), SRCA.data(), CLUT.data(), ICM(CLUT8));
+            DECODE(DST.data(), SRCA.data(), CLUT.data(), icm);
         }
     }
     const std::chrono::high_resolution_clock::time_point finish = std::chrono::high_resolution_clock::now();
@@ -153,12 +153,27 @@ int main()
     benchmarkDYUVLine<Video::decodeDYUVLineLUT<HALF_WIDTH>>("DYUV  LUT");
     IF_SIMD(benchmarkDYUVLine<Video::decodeDYUVLineSIMD<HALF_WIDTH>>("DYUV SIMD"));
 
-    benchmarkCLUTLine<Video::decodeCLUTLine<WIDTH>>("CLUT Soft");
+    benchmarkCLUTLine<Video::decodeCLUTLine<360>>("CLUT8 360 Soft", ICM(CLUT8));
+    IF_SIMD(benchmarkCLUTLine<Video::decodeCLUTLineSIMD<360>>("CLUT8 360 SIMD", ICM(CLUT8)));
+    benchmarkCLUTLine<Video::decodeCLUTLine<384>>("CLUT8 384 Soft", ICM(CLUT8));
+    IF_SIMD(benchmarkCLUTLine<Video::decodeCLUTLineSIMD<384>>("CLUT8 384 SIMD", ICM(CLUT8)));
+    benchmarkCLUTLine<Video::decodeCLUTLine<720>>("CLUT7 720 Soft", ICM(CLUT7));
+    IF_SIMD(benchmarkCLUTLine<Video::decodeCLUTLineSIMD<720>>("CLUT7 720 SIMD", ICM(CLUT7)));
+    benchmarkCLUTLine<Video::decodeCLUTLine<WIDTH>>("CLUT8 768 Soft", ICM(CLUT8));
+    IF_SIMD(benchmarkCLUTLine<Video::decodeCLUTLineSIMD<WIDTH>>("CLUT8 768 SIMD", ICM(CLUT8)));
+    benchmarkCLUTLine<Video::decodeCLUTLine<WIDTH>>("CLUT4 768 Soft", ICM(CLUT4));
+    IF_SIMD(benchmarkCLUTLine<Video::decodeCLUTLineSIMD<WIDTH>>("CLUT4 768 SIMD", ICM(CLUT4)));
 
     benchmarkRunLength<Video::decodeRunLengthLine<360, false>>("RL7 normal   1 pixel ", SRC_RL_1_PIXEL.data());
+    IF_SIMD((benchmarkRunLength<Video::decodeRunLengthLineSIMD<360, false>>("RL7 normal   1 pixel  SIMD", SRC_RL_1_PIXEL.data()));
     benchmarkRunLength<Video::decodeRunLengthLine<360, false>>("RL7 normal 384 pixels", SRC_RL7_384_PIXEL_384.data());
+    IF_SIMD((benchmarkRunLength<Video::decodeRunLengthLineSIMD<360, false>>("RL7 normal 384 pixels SIMD", SRC_RL7_384_PIXEL_384.data()));
     benchmarkRunLength<Video::decodeRunLengthLine<720, false>>("RL7 high     1 pixel ", SRC_RL_1_PIXEL.data());
+    IF_SIMD((benchmarkRunLength<Video::decodeRunLengthLineSIMD<720, false>>("RL7 high     1 pixel  SIMD", SRC_RL_1_PIXEL.data()));
     benchmarkRunLength<Video::decodeRunLengthLine<720, false>>("RL7 high   768 pixels", SRC_RL7_768_PIXEL_768.data());
+    IF_SIMD((benchmarkRunLength<Video::decodeRunLengthLineSIMD<720, false>>("RL7 high   768 pixels SIMD", SRC_RL7_768_PIXEL_768.data()));
     benchmarkRunLength<Video::decodeRunLengthLine<720, true>>("RL3 double   1 pixel ", SRC_RL_1_PIXEL.data());
+    IF_SIMD((benchmarkRunLength<Video::decodeRunLengthLineSIMD<720, true>>("RL3 double   1 pixel  SIMD", SRC_RL_1_PIXEL.data()));
     benchmarkRunLength<Video::decodeRunLengthLine<720, true>>("RL3 double 384 pixels", SRC_RL3_768_PIXEL.data());
+    IF_SIMD((benchmarkRunLength<Video::decodeRunLengthLineSIMD<720, true>>("RL3 double 384 pixels SIMD", SRC_RL3_768_PIXEL.data()));
 }
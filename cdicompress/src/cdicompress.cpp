@@ -0,0 +1,102 @@
+#include "DiscImage.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <print>
+#include <string_view>
+#include <vector>
+
+static void usage()
+{
+    std::println("Usage: cdicompress <command> <command parameters>");
+    std::println("Commands:");
+    std::println("    compress [-s <sectors per hunk>] <input> <output>");
+    std::println("    decompress <input> <output>");
+}
+
+static int compress(const std::vector<std::string_view>& args)
+{
+    uint32_t hunkSectors = DiscImage::DEFAULT_HUNK_SECTORS;
+    size_t i = 0;
+    if(args.size() == 4 && args[0] == "-s")
+    {
+        const std::from_chars_result res = std::from_chars(args[1].data(), args[1].data() + args[1].size(), hunkSectors);
+        if(res.ec != std::errc{} || hunkSectors == 0)
+        {
+            std::println(stderr, "Invalid number of sectors per hunk: {}", args[1]);
+            return 1;
+        }
+        i = 2;
+    }
+    else if(args.size() != 2)
+    {
+        usage();
+        return 1;
+    }
+
+    if(!compressDiscImage(args[i], args[i + 1], hunkSectors))
+    {
+        std::println(stderr, "Failed to compress {} to {}", args[i], args[i + 1]);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int decompress(const std::vector<std::string_view>& args)
+{
+    if(args.size() != 2)
+    {
+        usage();
+        return 1;
+    }
+
+    DiscImage image;
+    if(!image.Open(args[0]) || !image.IsCompressed())
+    {
+        std::println(stderr, "Failed to open compressed image {}", args[0]);
+        return 1;
+    }
+
+    std::ofstream out(std::string(args[1]), std::ios::out | std::ios::binary);
+    std::vector<uint8_t> buffer(SECTOR_SIZE * DiscImage::DEFAULT_HUNK_SECTORS);
+    for(uint64_t offset = 0; offset < image.GetSize() && out; offset += buffer.size())
+    {
+        buffer.resize(std::min<uint64_t>(buffer.size(), image.GetSize() - offset));
+        if(!image.Read(offset, buffer))
+        {
+            std::println(stderr, "Corrupted compressed image at offset {}", offset);
+            return 1;
+        }
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    }
+
+    if(!out)
+    {
+        std::println(stderr, "Failed to write {}", args[1]);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2)
+    {
+        usage();
+        return 1;
+    }
+
+    const std::string_view command = argv[1];
+    const std::vector<std::string_view> args(argv + 2, argv + argc);
+    if(command == "compress")
+        return compress(args);
+    if(command == "decompress")
+        return decompress(args);
+
+    usage();
+    return 1;
+}
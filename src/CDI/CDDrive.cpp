@@ -0,0 +1,199 @@
+#include "CDDrive.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <utility>
+
+CDDrive::CDDrive()
+{
+    for(size_t i = 0; i < RING_SIZE; ++i)
+        m_freeSectors.TryPush(std::make_unique<DriveSector>());
+}
+
+CDDrive::~CDDrive() noexcept
+{
+    Close();
+}
+
+/** \brief Opens a disc image and starts the reader thread, closing the image previously opened.
+ * \param path The raw or compressed disc image.
+ * \return true if opened successfully, false otherwise.
+ */
+bool CDDrive::Open(const std::filesystem::path& path)
+{
+    Close();
+
+    if(!m_image.Open(path))
+        return false;
+
+    m_sectorCount = m_image.GetSectorCount();
+    m_thread = std::thread(&CDDrive::ReadLoop, this);
+    return true;
+}
+
+/** \brief Stops the reader thread and closes the disc image. */
+void CDDrive::Close() noexcept
+{
+    if(m_thread.joinable())
+    {
+        m_stop.store(true, std::memory_order_release);
+        Signal();
+        m_thread.join();
+        m_stop.store(false, std::memory_order_relaxed);
+    }
+
+    while(std::optional<std::unique_ptr<DriveSector>> sector = m_readySectors.TryPop())
+        Recycle(std::move(*sector));
+    if(m_currentSector)
+        Recycle(std::move(m_currentSector));
+
+    m_image.Close();
+    m_sectorCount = 0;
+    m_request.store(0, std::memory_order_relaxed);
+    m_seek = 0;
+    m_nextLbn = 0;
+    m_playing = false;
+    m_late = false;
+    m_sectorTime = 0.0;
+}
+
+/** \brief Starts delivering the sectors from the given one.
+ * \param lbn The Logical Block Number of the first sector to deliver.
+ *
+ * Resuming from where the drive has been paused keeps the sectors already read ahead, any other position is a seek
+ * that discards them.
+ */
+void CDDrive::Play(const uint32_t lbn) noexcept
+{
+    if(!IsOpen())
+        return;
+
+    m_playing = true;
+    if(m_seek != 0 && lbn == m_nextLbn)
+        return;
+
+    while(std::optional<std::unique_ptr<DriveSector>> sector = m_readySectors.TryPop())
+        Recycle(std::move(*sector));
+    if(m_currentSector)
+        Recycle(std::move(m_currentSector));
+
+    if(++m_seek == 0) // 0 means that nothing has been requested yet.
+        m_seek = 1;
+    m_nextLbn = lbn;
+    m_late = false;
+    m_sectorTime = 0.0;
+
+    m_request.store(static_cast<uint64_t>(m_seek) << 32 | lbn, std::memory_order_release);
+    Signal();
+}
+
+/** \brief Stops delivering the sectors. The reader thread keeps filling the ring. */
+void CDDrive::Pause() noexcept
+{
+    m_playing = false;
+}
+
+/** \brief Sets the speed at which the sectors are delivered. */
+void CDDrive::SetSpeed(const DriveSpeed speed) noexcept
+{
+    m_speed = speed;
+}
+
+/** \brief Advances the time of the drive.
+ * \param ns The emulated time in nanoseconds.
+ * \return true if a new sector has been delivered, see \ref GetCurrentSector.
+ *
+ * Never waits on the reader thread. The drive stops playing after the last sector of the disc.
+ */
+bool CDDrive::IncrementTime(const double ns) noexcept
+{
+    if(!m_playing)
+        return false;
+
+    m_sectorTime += ns;
+    const double period = SECTOR_PERIOD / static_cast<uint8_t>(m_speed);
+    if(m_sectorTime < period)
+        return false;
+
+    if(m_nextLbn >= m_sectorCount)
+    {
+        m_playing = false;
+        return false;
+    }
+
+    std::optional<std::unique_ptr<DriveSector>> sector;
+    while((sector = m_readySectors.TryPop()) && (*sector)->seek != m_seek)
+        Recycle(std::move(*sector));
+
+    if(!sector)
+    {
+        if(!m_late)
+            m_underruns++;
+        m_late = true;
+        return false;
+    }
+
+    // A late sector starts a new period, the following ones are not delivered faster to catch up.
+    m_sectorTime = m_late ? 0.0 : m_sectorTime - period;
+    m_late = false;
+
+    if(m_currentSector)
+        Recycle(std::move(m_currentSector));
+    m_currentSector = std::move(*sector);
+    m_nextLbn++;
+
+    Signal();
+    return true;
+}
+
+void CDDrive::Signal() noexcept
+{
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+}
+
+/** \brief Gives back a sector buffer to the reader thread.
+ * There are only RING_SIZE buffers, so the free queue cannot be full.
+ */
+void CDDrive::Recycle(std::unique_ptr<DriveSector> sector) noexcept
+{
+    m_freeSectors.TryPush(std::move(sector));
+}
+
+void CDDrive::ReadLoop() noexcept
+{
+    uint32_t seek = 0;
+    uint32_t lbn = 0;
+
+    while(!m_stop.load(std::memory_order_acquire))
+    {
+        const uint32_t signal = m_signal.load(std::memory_order_acquire);
+        const uint64_t request = m_request.load(std::memory_order_acquire);
+        if(request >> 32 != seek)
+        {
+            seek = request >> 32;
+            lbn = request;
+        }
+
+        if(seek != 0 && lbn < m_sectorCount)
+        {
+            std::optional<std::unique_ptr<DriveSector>> sector = m_freeSectors.TryPop();
+            if(sector)
+            {
+                const std::span<const uint8_t> raw = m_image.GetSector(lbn);
+                if(raw.empty()) // Corrupted compressed hunk.
+                    (*sector)->data.fill(0);
+                else
+                    std::copy(raw.begin(), raw.end(), (*sector)->data.begin());
+                (*sector)->lbn = lbn++;
+                (*sector)->seek = seek;
+
+                m_readySectors.TryPush(std::move(*sector));
+                continue;
+            }
+        }
+
+        m_signal.wait(signal, std::memory_order_acquire);
+    }
+}
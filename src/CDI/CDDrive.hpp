@@ -0,0 +1,97 @@
+#ifndef CDI_CDDRIVE_HPP
+#define CDI_CDDRIVE_HPP
+
+#include "DiscImage.hpp"
+#include "common/SPSCQueue.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+/** \brief The reading speed of \ref CDDrive. */
+enum class DriveSpeed : uint8_t
+{
+    Single = 1, /**< 75 sectors per second. */
+    Double = 2, /**< 150 sectors per second. */
+};
+
+/** \brief A raw sector read by \ref CDDrive. */
+struct DriveSector
+{
+    std::array<uint8_t, SECTOR_SIZE> data;
+    uint32_t lbn;
+    uint32_t seek; /**< The seek it has been read after, to discard the sectors read before a seek. */
+};
+
+/** \brief Emulated CD drive that streams the sectors of a disc image.
+ *
+ * A reader thread fills a ring of the upcoming sectors. The emulation thread advances the time of the drive, which
+ * delivers a sector every 1/75 second (or 1/150 at double speed) by popping it from the ring, so it never waits on
+ * file I/O or decompression. When the reader thread is late, the sector is delivered as soon as it is ready and the
+ * underrun is counted in \ref GetUnderruns.
+ *
+ * The drive opens its own \ref DiscImage, so it does not share the cursor of \ref CDIDisc.
+ *
+ * Except for the reader thread, the drive must only be used by a single thread.
+ */
+class CDDrive
+{
+public:
+    static constexpr size_t RING_SIZE = 32; /**< Number of sectors that can be read ahead. */
+    static constexpr double SECTOR_PERIOD = 1'000'000'000.0 / 75.0; /**< The time to read a sector at single speed in ns. */
+
+    CDDrive();
+    ~CDDrive() noexcept;
+
+    CDDrive(const CDDrive&) = delete;
+    CDDrive& operator=(const CDDrive&) = delete;
+    CDDrive(CDDrive&&) = delete;
+    CDDrive& operator=(CDDrive&&) = delete;
+
+    bool Open(const std::filesystem::path& path);
+    void Close() noexcept;
+    /** \brief Returns true if a disc image is opened. */
+    bool IsOpen() const noexcept { return m_thread.joinable(); }
+
+    void Play(uint32_t lbn) noexcept;
+    void Pause() noexcept;
+    void SetSpeed(DriveSpeed speed) noexcept;
+    /** \brief Returns true if the drive is delivering sectors. */
+    bool IsPlaying() const noexcept { return m_playing; }
+
+    bool IncrementTime(double ns) noexcept;
+    /** \brief Returns the last sector delivered by \ref IncrementTime, or nullptr if none since the last seek. */
+    const DriveSector* GetCurrentSector() const noexcept { return m_currentSector.get(); }
+    /** \brief Returns the number of sectors that were not read in time. */
+    uint64_t GetUnderruns() const noexcept { return m_underruns; }
+
+private:
+    DiscImage m_image; /**< Only used by the reader thread while it runs. */
+    uint32_t m_sectorCount{0};
+
+    SPSCQueue<std::unique_ptr<DriveSector>, RING_SIZE> m_readySectors{}; /**< Reader thread to emulation thread. */
+    SPSCQueue<std::unique_ptr<DriveSector>, RING_SIZE> m_freeSectors{}; /**< Emulation thread to reader thread. */
+    std::atomic<uint64_t> m_request{0}; /**< The seek number in the high 32 bits and its LBN in the low 32 bits. */
+    std::atomic<uint32_t> m_signal{0}; /**< Incremented to wake the reader thread up. */
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+
+    // Emulation thread state.
+    uint32_t m_seek{0};
+    uint32_t m_nextLbn{0};
+    bool m_playing{false};
+    bool m_late{false};
+    DriveSpeed m_speed{DriveSpeed::Single};
+    double m_sectorTime{0.0};
+    std::unique_ptr<DriveSector> m_currentSector{};
+    uint64_t m_underruns{0};
+
+    void Signal() noexcept;
+    void Recycle(std::unique_ptr<DriveSector> sector) noexcept;
+    void ReadLoop() noexcept;
+};
+
+#endif // CDI_CDDRIVE_HPP
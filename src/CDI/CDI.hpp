@@ -8,6 +8,7 @@
 #include "cores/ISlave.hpp"
 #include "cores/SCC68070/SCC68070.hpp"
 #include "OS9/BIOS.hpp"
+#include "Video/FrameExchange.hpp"
 
 #include <memory>
 #include <span>
@@ -24,6 +25,7 @@ public:
     const CDIConfig m_config; /**< Configuration of the CDI context. */
     CDIDisc m_disc; /**< CDI disc. */
     Callbacks m_callbacks; /**< The user callbacks. */
+    Video::FrameExchange m_frames; /**< The completed frames, for a consumer thread. */
 
     SCC68070 m_cpu; /**< The main CPU. */
     std::unique_ptr<ISlave> m_slave; /**< The slave processor. */
@@ -57,11 +59,17 @@ public:
 
     virtual std::vector<InternalRegister> GetVDSCInternalRegisters() = 0;
     virtual std::vector<InternalRegister> GetVDSCControlRegisters() = 0;
-    virtual const Video::Plane& GetScreen() = 0;
-    virtual const Video::Plane& GetPlaneA() = 0;
-    virtual const Video::Plane& GetPlaneB() = 0;
-    virtual const Video::Plane& GetBackground() = 0;
-    virtual const Video::Plane& GetCursor() = 0;
+    // The planes are copies of the last completed frame taken when asked for, so they stay valid while the emulation
+    // is running. The first call may return empty planes.
+    virtual Video::Plane GetScreen() = 0;
+    virtual Video::Plane GetPlaneA() = 0;
+    virtual Video::Plane GetPlaneB() = 0;
+    virtual Video::Plane GetBackground() = 0;
+    virtual Video::Plane GetCursor() = 0;
+    /** \brief Keeps the whole planes A and B of the VDSC, so \ref GetPlaneA and \ref GetPlaneB return the full image.
+     * By default only the line being drawn is kept. Does nothing if the VDSC always keeps the whole planes.
+     */
+    virtual void SetVDSCPlanesRetained(bool) {}
 
 protected:
     friend Mono3;
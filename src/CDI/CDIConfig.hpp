@@ -2,6 +2,7 @@
 #define CDI_CDICONFIG_HPP
 
 #include "cores/IRTC.hpp"
+#include "Video/VideoCommon.hpp"
 
 #include <ctime>
 #include <optional>
@@ -14,12 +15,16 @@ struct CDIConfig
     bool PAL; /**< true for PAL, false for NTSC. */
     std::optional<std::time_t> initialTime; /**< initial time used by the timekeeper, or nullopt to use the stored time. */
     bool has32KBNVRAM; /**< True if the board has 32KB of NVRAM, false for 8KB. */
+    Video::RendererBackend renderer = Video::RendererBackend::SIMD; /**< The video renderer to use. */
+    bool asyncVideo = false; /**< True to decode and mix the video on a separate thread. */
 };
 
 constexpr CDIConfig defaultConfig = {
     true,
     IRTC::defaultTime,
     false,
+    Video::RendererBackend::SIMD,
+    false,
 }; /**< Default configuration used by CDI if no one is provided. */
 
 #endif // CDI_CDICONFIG_HPP
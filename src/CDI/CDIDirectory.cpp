@@ -80,45 +80,13 @@ void CDIDirectory::LoadContent(CDIDisc& disc)
                 files.emplace(name, CDIFile(disc, lbn, filesize, namesize, name, attributes, filenumber, relOffset));
             }
         }
-        if(!(disc.m_subheader.submode & cdieof))
-            disc.GotoNextSector();
-    } while(!(disc.m_subheader.submode & cdieof)); // in case the directory structure is spreaded over several sectors
+        if(disc.m_subheader.submode & cdieof)
+            break;
+    } while(disc.GotoNextSector()); // in case the directory structure is spreaded over several sectors, stops at the end of a corrupted disc
 
     disc.Seek(pos);
 }
 
-/** \brief Get file from its path in the directory.
- *
- * \param  filename The path from the current directory to the file.
- * \return A pointer to the file, or nullptr is not found.
- *
- * The path must not start with a '/'.
- * e.g. "CMDS/cdi_gate" for file "cdi_gate" in the "CMDS" folder inside this directory.
- */
-const CDIFile* CDIDirectory::GetFile(std::string filename)
-{
-    const size_t pos = filename.find('/');
-    if(pos == std::string::npos)
-    {
-        std::map<std::string, CDIFile>::iterator it = files.find(filename);
-        if(it == files.end())
-            return nullptr;
-
-        return &it->second;
-    }
-    else
-    {
-        std::string dir = filename.substr(0, pos);
-        filename = filename.substr(pos + 1);
-
-        std::map<std::string, CDIDirectory>::iterator it = subdirectories.find(dir);
-        if(it == subdirectories.end())
-            return nullptr;
-
-        return it->second.GetFile(filename);
-    }
-}
-
 /** \brief Clear the directory content.
  *
  * Delete the loaded files and subdirectories of this directory (does not delete them from the disc).
@@ -166,26 +134,27 @@ std::stringstream CDIDirectory::GetChildrenTree() const
     return ss;
 }
 
-/** \brief Export the audio data from each file in the directory and its subdirectories recursively.
+/** \brief Gets the audio of each file in the directory and its subdirectories recursively.
  *
- * \param  basePath The directory where the files will be written.
+ * \param  basePath The directory where the files will be written, created by this function.
+ * \param  streams Where the audio streams are appended, see \ref CDIFile::GetAudioStreams.
  * \throw std::filesystem::filesystem_error if it cannot create directories.
  */
-void CDIDirectory::ExportAudio(std::string basePath) const
+void CDIDirectory::GetAudioStreams(std::string basePath, std::vector<AudioStream>& streams) const
 {
     if(name != "/")
         basePath += name + "/";
 
     std::filesystem::create_directories(basePath);
 
-    for(std::pair<std::string, CDIFile> file : files)
+    for(const std::pair<const std::string, CDIFile>& file : files)
     {
-        file.second.ExportAudio(basePath);
+        file.second.GetAudioStreams(basePath, streams);
     }
 
-    for(std::pair<std::string, CDIDirectory> subdir : subdirectories)
+    for(const std::pair<const std::string, CDIDirectory>& subdir : subdirectories)
     {
-        subdir.second.ExportAudio(basePath);
+        subdir.second.GetAudioStreams(basePath, streams);
     }
 }
 
@@ -8,6 +8,7 @@ class CDIDisc;
 #include <map>
 #include <string>
 #include <string_view>
+#include <vector>
 
 /** \brief CD-I directory on disc.
  *
@@ -27,10 +28,9 @@ public:
 
     void Clear();
     void LoadContent(CDIDisc& disc);
-    const CDIFile* GetFile(std::string filename);
 
     std::stringstream GetChildrenTree() const;
-    void ExportAudio(std::string basePath) const;
+    void GetAudioStreams(std::string basePath, std::vector<AudioStream>& streams) const;
     void ExportFiles(std::string basePath) const;
     void ExportRawVideo(std::string basePath) const;
 
@@ -1,12 +1,14 @@
 #include "CDIDisc.hpp"
 #include "common/utils.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <filesystem>
 
 CDIDisc::CDIDisc()
     : m_mainModule()
     , m_gameName()
-    , m_disc()
+    , m_image()
     , m_header()
     , m_subheader()
     , m_rootDirectory(0, "", 0, 1, 1)
@@ -28,10 +30,15 @@ bool CDIDisc::Open(const std::string& filename)
 {
     Close();
 
-    m_disc.open(filename, std::ios::in | std::ios::binary);
-    if(!m_disc.is_open())
+    if(!m_image.Open(filename))
         return false;
 
+    m_imagePath = filename;
+    m_sectorIndexPath = filename + ".sectors";
+    std::error_code error;
+    if(std::filesystem::exists(m_sectorIndexPath, error))
+        m_sectorIndex.Load(m_sectorIndexPath, SectorIndex::ComputeImageHash(m_image, m_imagePath));
+
     if(!LoadFileSystem())
     {
         Close();
@@ -47,14 +54,18 @@ bool CDIDisc::Open(const std::string& filename)
  */
 bool CDIDisc::IsOpen() const
 {
-    return m_disc.is_open();
+    return m_image.IsOpen();
 }
 
 /** \brief Close the opened disc.
  */
 void CDIDisc::Close()
 {
-    m_disc.close();
+    m_image.Close();
+    m_position = 0;
+    m_fail = false;
+    m_sectorIndex.Clear();
+    m_files.clear();
     m_rootDirectory.Clear();
     m_mainModule = "";
     m_gameName = "";
@@ -68,10 +79,7 @@ void CDIDisc::Close()
  */
 bool CDIDisc::Good()
 {
-    if(m_disc.peek() == EOF)
-        return false;
-
-    return m_disc.good();
+    return !m_fail && m_position < m_image.GetSize();
 }
 
 /** \brief Get the location on the disc of the current sector.
@@ -95,10 +103,15 @@ DiscTime CDIDisc::GetTime()
  *
  * The path must not start with a '/'.
  * e.g. "CMDS/cdi_gate" for file "cdi_gate" in the "CMDS" folder in the root directory.
+ * The paths are hashed when the disc is opened, so the lookup does not walk the directories.
  */
-const CDIFile* CDIDisc::GetFile(std::string path)
+const CDIFile* CDIDisc::GetFile(const std::string_view path) const noexcept
 {
-    return m_rootDirectory.GetFile(path);
+    const auto it = m_files.find(path);
+    if(it == m_files.end())
+        return nullptr;
+
+    return it->second;
 }
 
 /** \brief Calls the given function on each file of the root directory of the disc.
@@ -111,64 +124,88 @@ void CDIDisc::ForEachFile(std::function<void(std::string_view, const CDIFile&)>
     m_rootDirectory.ForEachFile("", std::move(f));
 }
 
-/** \brief Calls the given function on each sector of the disc.
- * \param f The function to call.
+/** \brief Returns the raw sector at the given Logical Block Number.
+ * \param lbn The Logical Block Number.
+ * \return The \ref SECTOR_SIZE bytes of the sector, or an empty span if it is outside of the disc.
+ *
+ * The data is valid until the disc is closed, see \ref DiscImage::GetSector for compressed images.
  */
-void CDIDisc::ForEachSector(std::function<void(const CDISector&)> f)
+std::span<const uint8_t> CDIDisc::GetRawSector(const uint32_t lbn)
 {
-    uint32_t lbn = 0;
+    return m_image.GetSector(lbn);
+}
+
+/** \brief Returns the index of the sectors of the disc.
+ * \param save If true, the index built by this call is saved to the file next to the disc image.
+ *
+ * The index is loaded from the file next to the disc image (its name with `.sectors` appended) when the disc is
+ * opened. Otherwise it is built from the whole disc on the first call and saved to that file if requested and possible.
+ */
+const SectorIndex& CDIDisc::GetSectorIndex(const bool save)
+{
+    if(m_sectorIndex.IsEmpty() && IsOpen())
+    {
+        m_sectorIndex.Build(m_image);
+        if(save)
+            m_sectorIndex.Save(m_sectorIndexPath, SectorIndex::ComputeImageHash(m_image, m_imagePath));
+    }
+
+    return m_sectorIndex;
+}
 
-    while(GotoLBN(lbn++))
-        f(m_currentSector);
+/** \brief Parses the header and subheader of a raw sector. */
+static void parseSectorHeaders(std::span<const uint8_t> sector, DiscHeader& header, DiscSubheader& subheader) noexcept
+{
+    header.minute = PBCDToByte(sector[12]);
+    header.second = PBCDToByte(sector[13]);
+    header.sector = PBCDToByte(sector[14]);
+    header.mode = sector[15];
+    subheader.fileNumber = sector[16];
+    subheader.channelNumber = sector[17];
+    subheader.submode = sector[18];
+    subheader.codingInformation = sector[19];
+}
 
-    m_disc.clear(); // Here we are at the end of the disc so we clear all errors for the next use.
+/** \brief Returns the sector at the given Logical Block Number.
+ * \param lbn The Logical Block Number.
+ * \return The sector, with an empty payload if it is outside of the disc.
+ *
+ * The headers are parsed from the disc image, the payload is not copied.
+ */
+SectorView CDIDisc::GetSector(const uint32_t lbn)
+{
+    SectorView view{};
+    view.lbn = lbn;
+    const std::span<const uint8_t> sector = GetRawSector(lbn);
+    if(sector.empty())
+        return view;
+
+    parseSectorHeaders(sector, view.header, view.subheader);
+    view.data = sector.subspan(24, view.GetSectorDataSize());
+    return view;
 }
 
 /** \brief Update header and subheader with the current sector info.
  */
 void CDIDisc::UpdateSectorInfo()
 {
-    const uint32_t tmp = m_disc.tellg();
-    m_disc.seekg(tmp - (tmp % 2352) + 12);
-    char s[8];
-    m_disc.read(s, 8);
-
-    m_header.minute = PBCDToByte(s[0]);
-    m_header.second = PBCDToByte(s[1]);
-    m_header.sector = PBCDToByte(s[2]);
-    m_header.mode = s[3];
-    m_subheader.fileNumber = s[4];
-    m_subheader.channelNumber = s[5];
-    m_subheader.submode = s[6];
-    m_subheader.codingInformation = s[7];
-
-    m_disc.seekg(tmp);
+    const std::span<const uint8_t> sector = GetRawSector(m_position / SECTOR_SIZE);
+    if(sector.empty())
+    {
+        m_fail = true;
+        return;
+    }
+
+    parseSectorHeaders(sector, m_header, m_subheader);
 }
 
-/** \brief Update header and subheader with the current sector info.
+/** \brief Update the current sector with the sector at the file cursor position.
  */
 void CDIDisc::UpdateCurrentSector()
 {
-    const uint32_t pos = m_disc.tellg();
-    m_disc.seekg(pos - (pos % 2352) + 12);
-    char s[12];
-    m_disc.read(s, 12);
-
-    m_currentSector.header.minute = PBCDToByte(s[0]);
-    m_currentSector.header.second = PBCDToByte(s[1]);
-    m_currentSector.header.sector = PBCDToByte(s[2]);
-    m_currentSector.header.mode = s[3];
-
-    m_currentSector.subheader.fileNumber = s[4];
-    m_currentSector.subheader.channelNumber = s[5];
-    m_currentSector.subheader.submode = s[6];
-    m_currentSector.subheader.codingInformation = s[7];
-
-    const uint16_t size = m_currentSector.GetSectorDataSize();
-    m_currentSector.data.resize(size);
-    m_disc.read(reinterpret_cast<char*>(m_currentSector.data.data()), size);
-
-    m_disc.seekg(pos);
+    m_currentSector = GetSector(m_position / SECTOR_SIZE);
+    if(m_currentSector.data.empty())
+        m_fail = true;
 }
 
 /** \brief Load every file and directory from the disc.
@@ -194,7 +231,7 @@ bool CDIDisc::LoadFileSystem()
 
     while((Tell() % 2352) < 2072) // read the directories on the whole sector
     {
-        if(m_disc.fail())
+        if(m_fail)
             return false;
         uint8_t nameSize = GetByte();
         if(nameSize == 0)
@@ -217,9 +254,15 @@ bool CDIDisc::LoadFileSystem()
     }
     m_rootDirectory.LoadContent(*this);
 
+    // The files are stored in std::map, so their address does not change.
+    m_rootDirectory.ForEachFile("", [this] (std::string_view directory, const CDIFile& file) {
+        directory.remove_prefix(1); // The paths do not start with '/'.
+        m_files.emplace(std::string(directory) + file.name, &file);
+    });
+
     Seek(pos);
 
-    if((m_rootDirectory.GetFile(m_mainModule)) == nullptr)
+    if(GetFile(m_mainModule) == nullptr)
         return false;
 
     return true;
@@ -231,7 +274,7 @@ bool CDIDisc::LoadFileSystem()
  */
 uint32_t CDIDisc::Tell()
 {
-    return m_disc.tellg();
+    return m_position;
 }
 
 /** \brief Set the file cursor position.
@@ -242,8 +285,13 @@ uint32_t CDIDisc::Tell()
  */
 bool CDIDisc::Seek(const uint32_t offset, std::ios::seekdir direction)
 {
-    m_disc.clear();
-    m_disc.seekg(offset, direction);
+    m_fail = false;
+    if(direction == std::ios::cur)
+        m_position += offset;
+    else if(direction == std::ios::end)
+        m_position = m_image.GetSize() + offset;
+    else
+        m_position = offset;
     UpdateSectorInfo();
     return Good();
 }
@@ -259,8 +307,8 @@ bool CDIDisc::Seek(const uint32_t offset, std::ios::seekdir direction)
  */
 bool CDIDisc::GotoLBN(const uint32_t lbn, const uint32_t offset)
 {
-    m_disc.clear();
-    m_disc.seekg(lbn * 2352 + 24 + offset);
+    m_fail = false;
+    m_position = lbn * SECTOR_SIZE + 24 + offset;
     UpdateSectorInfo();
     UpdateCurrentSector();
     return Good();
@@ -279,18 +327,24 @@ bool CDIDisc::GotoLBN(const uint32_t lbn, const uint32_t offset)
  */
 bool CDIDisc::GotoNextSector(uint8_t submodeMask)
 {
-    if(submodeMask &= 0x0E)
+    if((submodeMask &= 0x0E) && !m_sectorIndex.IsEmpty())
+    {
+        const std::optional<uint32_t> lbn = m_sectorIndex.NextSector(m_position / SECTOR_SIZE, std::nullopt, std::nullopt, submodeMask);
+        m_position = lbn.value_or(m_sectorIndex.GetSectorCount()) * SECTOR_SIZE + 24;
+        UpdateSectorInfo();
+    }
+    else if(submodeMask)
     {
         do
         {
             // 2376 = 2352 + 24 (sector size + offset to sector data).
-            m_disc.seekg(2376 - m_disc.tellg() % 2352, std::ios::cur);
+            m_position += 2376 - m_position % SECTOR_SIZE;
             UpdateSectorInfo();
         } while(!(m_subheader.submode & submodeMask) && Good());
     }
     else
     {
-        m_disc.seekg(2376 - m_disc.tellg() % 2352, std::ios::cur);
+        m_position += 2376 - m_position % SECTOR_SIZE;
         UpdateSectorInfo();
     }
     return Good();
@@ -302,10 +356,24 @@ bool CDIDisc::GotoNextSector(uint8_t submodeMask)
  */
 bool CDIDisc::GotoNextFileSector(uint8_t fileNumber)
 {
+    if(!m_sectorIndex.IsEmpty())
+    {
+        // Like the scan below, the EOF sector of any file also stops the search.
+        const uint32_t lbn = m_position / SECTOR_SIZE;
+        uint32_t next = m_sectorIndex.NextSector(lbn, fileNumber).value_or(m_sectorIndex.GetSectorCount());
+        if(lbn < m_sectorIndex.GetSectorCount())
+            next = std::min(next, m_sectorIndex.NextEndOfFile(lbn).value_or(next));
+
+        m_position = next * SECTOR_SIZE + 24;
+        UpdateSectorInfo();
+        UpdateCurrentSector();
+        return Good();
+    }
+
     do
     {
         // 2376 = 2352 + 24 (sector size + offset to sector data).
-        m_disc.seekg(2376 - m_disc.tellg() % 2352, std::ios::cur);
+        m_position += 2376 - m_position % SECTOR_SIZE;
         UpdateSectorInfo();
         UpdateCurrentSector();
         // EOF should not be happening.
@@ -314,6 +382,39 @@ bool CDIDisc::GotoNextFileSector(uint8_t fileNumber)
     return Good();
 }
 
+/** \brief Returns the next bytes of the disc and advances the file cursor.
+ *
+ * \param size The number of bytes to read.
+ * \return The bytes, or an empty span if the disc is not that long. Valid until the next read.
+ */
+std::span<const uint8_t> CDIDisc::Read(const size_t size)
+{
+    const size_t position = m_position;
+    m_position += size;
+    if(m_fail || position + size > m_image.GetSize())
+    {
+        m_fail = true;
+        return {};
+    }
+
+    const size_t offset = position % SECTOR_SIZE;
+    if(offset + size <= SECTOR_SIZE)
+    {
+        const std::span<const uint8_t> sector = m_image.GetSector(position / SECTOR_SIZE);
+        if(!sector.empty()) // Empty for the trailing partial sector.
+            return sector.subspan(offset, size);
+    }
+
+    // The sectors are not contiguous in memory in compressed images.
+    m_readBuffer.resize(size);
+    if(!m_image.Read(position, m_readBuffer))
+    {
+        m_fail = true;
+        return {};
+    }
+    return m_readBuffer;
+}
+
 /** \brief Read raw data from the disc.
  *
  * \param dst The destination buffer.
@@ -323,51 +424,43 @@ bool CDIDisc::GotoNextFileSector(uint8_t fileNumber)
  */
 bool CDIDisc::GetRaw(std::span<uint8_t> dst)
 {
-    m_disc.read(reinterpret_cast<char*>(dst.data()), dst.size());
-    return m_disc.good();
+    const std::span<const uint8_t> src = Read(dst.size());
+    std::copy(src.begin(), src.end(), dst.begin());
+    return !src.empty() || dst.empty();
 }
 
 /** \brief Get the next byte value.
  *
- * \return The byte value read.
+ * \return The byte value read, or 0 past the end of the disc.
  */
 uint8_t CDIDisc::GetByte()
 {
-    char c;
-    m_disc.get(c);
-    return c;
+    const std::span<const uint8_t> src = Read(1);
+    return src.empty() ? 0 : src[0];
 }
 
 /** \brief Get the word value in big endian format.
  *
- * \return The word value read.
+ * \return The word value read, or 0 past the end of the disc.
  *
  * Word is a 2-bytes value.
  */
 uint16_t CDIDisc::GetWord()
 {
-    uint16_t var = 0;
-    char c;
-    m_disc.get(c); var |= zeroExtend<uint8_t, uint16_t>(c) << 8;
-    m_disc.get(c); var |= zeroExtend<uint8_t, uint16_t>(c);
-    return var;
+    const std::span<const uint8_t> src = Read(2);
+    return src.empty() ? 0 : GET_ARRAY16(src, 0);
 }
 
 /** \brief Get the next long value in big endian format.
  *
- * \return The long value read.
+ * \return The long value read, or 0 past the end of the disc.
  *
  * Long is a 4-bytes value.
  */
 uint32_t CDIDisc::GetLong()
 {
-    uint32_t var = 0;
-    char c;
-    m_disc.get(c); var |= zeroExtend<uint8_t, uint32_t>(c) << 24;
-    m_disc.get(c); var |= zeroExtend<uint8_t, uint32_t>(c) << 16;
-    m_disc.get(c); var |= zeroExtend<uint8_t, uint32_t>(c) << 8;
-    m_disc.get(c); var |= zeroExtend<uint8_t, uint32_t>(c);
-    return var;
+    const std::span<const uint8_t> src = Read(4);
+    return src.empty() ? 0 : GET_ARRAY32(src, 0);
 }
 
 /** \brief Get the string at the current file cursor.
@@ -384,30 +477,13 @@ uint32_t CDIDisc::GetLong()
  */
 std::string CDIDisc::GetString(uint16_t length, const char delim)
 {
-    char* str = new (std::nothrow) char[length];
-
-    m_disc.read(str, length);
-    for(; str[--length] == delim && length;);
-
-    return std::string(str, length+1);
-}
-
-/** \brief Calls the given function for each sector of the given file LBN.
- * \param lbn The Logical Block Number where to start.
- * \param f The function to call.
- *
- * This function selects each sector based on the file number of the first sector and stops at the EOF sector.
- */
-void CDIDisc::ForEachFileSector(const uint32_t lbn, std::function<void(const CDISector&)> f)
-{
-    GotoLBN(lbn);
+    const std::span<const uint8_t> src = Read(length);
+    const char* str = reinterpret_cast<const char*>(src.data());
+    if(src.empty())
+        return "";
 
-    const uint8_t fileNumber = m_currentSector.subheader.fileNumber;
-
-    do
-    {
-        f(m_currentSector);
-    } while(!(m_currentSector.subheader.submode & cdieof) && GotoNextFileSector(fileNumber));
+    // The first character is always kept.
+    for(; length > 1 && str[length - 1] == delim; length--);
 
-    m_disc.clear(); // In case the last file sector is also the last sector of the disc.
+    return std::string(str, length);
 }
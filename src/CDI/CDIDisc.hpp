@@ -3,12 +3,17 @@
 
 #include "CDIDirectory.hpp"
 #include "CDIFile.hpp"
+#include "DiscImage.hpp"
+#include "SectorIndex.hpp"
 
-#include <fstream>
 #include <functional>
+#include <ios>
 #include <span>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 /** \brief The max number of channels (Green book Appendix II.1.2). */
 static constexpr size_t MAX_CHANNEL_NUMBER = 32;
@@ -56,16 +61,42 @@ enum SubmodeBits : uint8_t
     cdiany  = 0b00001110, // Any type of sector
 };
 
-struct CDISector
+/** \brief A sector of the disc, that points into the disc image.
+ * It is valid until the disc is closed, or for compressed images until its hunk is evicted from the cache.
+ */
+struct SectorView
 {
+    uint32_t lbn;
     DiscHeader header;
     DiscSubheader subheader;
-    std::vector<uint8_t> data;
+    std::span<const uint8_t> data; /**< The payload, \ref GetSectorDataSize bytes. */
 
     uint16_t GetSectorDataSize() const { return (subheader.submode & cdiform) ? 2324 : 2048; }
 };
 
+/** \brief The audio sectors of a channel of a file, see \ref CDIFile::GetAudioStreams. */
+struct AudioStream
+{
+    /** \brief A logical record, exported to its own WAV file. */
+    struct Record
+    {
+        uint8_t bps;
+        uint8_t sf;
+        uint8_t ms;
+        std::vector<uint32_t> sectors; /**< The LBN of each sector of the record. */
+    };
+
+    std::string basename; /**< The WAV files are named after it. */
+    uint8_t channel;
+    std::vector<Record> records;
+};
+
+void exportAudioStreams(DiscImage& image, std::span<const AudioStream> streams);
+
 /** \brief Encapsulates an ISO of a CD-I disc.
+ *
+ * The disc image is memory-mapped, the sectors are read straight from memory. Compressed images are decompressed
+ * on the fly, see \ref DiscImage.
  *
  * This class is not thread-safe.
  *
@@ -86,7 +117,13 @@ public:
     bool Good();
     DiscTime GetTime();
 
-    const CDIFile* GetFile(std::string path);
+    /** \brief Returns the number of whole sectors in the disc image. */
+    uint32_t GetSectorCount() const noexcept { return m_image.GetSectorCount(); }
+    std::span<const uint8_t> GetRawSector(uint32_t lbn);
+    SectorView GetSector(uint32_t lbn);
+    const SectorIndex& GetSectorIndex(bool save = true);
+
+    const CDIFile* GetFile(std::string_view path) const noexcept;
 
     bool ExportAudio(const std::string& path);
     bool ExportFiles(const std::string& path);
@@ -95,20 +132,36 @@ public:
     bool ExportSectorsInfo(const std::string& path);
 
     void ForEachFile(std::function<void(std::string_view, const CDIFile&)> f);
-    void ForEachSector(std::function<void(const CDISector&)> f);
+    template<typename F>
+    void ForEachSector(F&& f);
 
 private:
     friend CDIFile;
     friend CDIDirectory;
 
-    std::ifstream m_disc;
-    CDISector m_currentSector;
+    /** \brief Allows looking up the std::string keys with std::string_view without allocating. */
+    struct PathHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view path) const noexcept { return std::hash<std::string_view>{}(path); }
+    };
+
+    DiscImage m_image;
+    std::vector<uint8_t> m_readBuffer; /**< Holds the reads that span several sectors of compressed images. */
+    uint32_t m_position{0}; /**< The read cursor in the disc image. */
+    bool m_fail{false}; /**< Set when reading past the end of the disc, cleared when seeking. */
+    std::string m_imagePath;
+    std::string m_sectorIndexPath;
+    SectorIndex m_sectorIndex; /**< Empty until loaded or built, the sector searches then use it. */
+    SectorView m_currentSector;
     DiscHeader m_header;
     DiscSubheader m_subheader;
     CDIDirectory m_rootDirectory;
+    std::unordered_map<std::string, const CDIFile*, PathHash, std::equal_to<>> m_files{}; /**< Every file of \ref m_rootDirectory by path. */
 
     void UpdateSectorInfo();
     void UpdateCurrentSector();
+    std::span<const uint8_t> Read(size_t size);
 
     bool LoadFileSystem();
 
@@ -124,7 +177,49 @@ private:
     uint32_t GetLong();
     std::string GetString(uint16_t length = 128, const char delim = ' ');
 
-    void ForEachFileSector(uint32_t lbn, std::function<void(const CDISector&)> f);
+    template<typename F>
+    void ForEachFileSector(uint32_t lbn, F&& f);
 };
 
+/** \brief Calls the given function on each sector of the disc.
+ * \param f The function to call, with a `const SectorView&`.
+ */
+template<typename F>
+void CDIDisc::ForEachSector(F&& f)
+{
+    const uint32_t count = GetSectorCount();
+    for(uint32_t lbn = 0; lbn < count; lbn++)
+        f(GetSector(lbn));
+}
+
+/** \brief Calls the given function for each sector of the given file LBN.
+ * \param lbn The Logical Block Number where to start.
+ * \param f The function to call, with a `const SectorView&`.
+ *
+ * This function selects each sector based on the file number of the first sector and stops at the EOF sector.
+ */
+template<typename F>
+void CDIDisc::ForEachFileSector(const uint32_t lbn, F&& f)
+{
+    GotoLBN(lbn);
+
+    const uint8_t fileNumber = m_currentSector.subheader.fileNumber;
+
+    do
+    {
+        f(m_currentSector);
+    } while(!(m_currentSector.subheader.submode & cdieof) && GotoNextFileSector(fileNumber));
+
+    m_fail = false; // In case the last file sector is also the last sector of the disc.
+}
+
+/** \brief Calls the given function on each sector or the file.
+ * \param f The function to call, with a `const SectorView&`.
+ */
+template<typename F>
+void CDIFile::ForEachSector(F&& f) const
+{
+    disc.ForEachFileSector(LBN, std::forward<F>(f));
+}
+
 #endif // CDI_CDIDISC_HPP
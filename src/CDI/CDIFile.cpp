@@ -1,6 +1,5 @@
 #include "CDIFile.hpp"
 #include "CDIDisc.hpp"
-#include "common/Audio.hpp"
 #include "common/utils.hpp"
 
 #include <array>
@@ -72,58 +71,68 @@ static void writeRawVideo(std::vector<uint8_t>& data, const std::string& basenam
  * \param  directoryPath Path to the directory where the files will be written. Must end with a '/' (or '\' on Windows).
  *
  * Converts and writes the audio data from the disc to 16-bit PCM.
- * Each channel and logical records are exported individualy.
+ * Each channel and logical records are exported individualy, the channels are decoded in parallel.
  */
 void CDIFile::ExportAudio(const std::string& directoryPath) const
 {
-    struct AudioInfo
-    {
-        uint8_t bps;
-        uint8_t sf;
-        uint8_t ms;
-        uint8_t record;
-        Audio::SamplesDelay delay;
-        std::vector<int16_t> left; // If left if empty, right must be empty.
-        std::vector<int16_t> right;
-    };
-    std::array<AudioInfo, MAX_AUDIO_CHANNEL_NUMBER> audio{};
+    std::vector<AudioStream> streams;
+    GetAudioStreams(directoryPath, streams);
+    exportAudioStreams(disc.m_image, streams);
+}
 
-    ForEachSector([&] (const CDISector& sector) {
-        if((sector.subheader.submode & cdia) == 0)
+/** \brief Finds the audio records of each channel of the file, without decoding them.
+ *
+ * \param  directoryPath Path to the directory where the files will be written. Must end with a '/' (or '\' on Windows).
+ * \param  streams Where the channels that contain audio are appended.
+ *
+ * A record ends at an End Of Record sector or when the coding of the channel changes.
+ */
+void CDIFile::GetAudioStreams(const std::string& directoryPath, std::vector<AudioStream>& streams) const
+{
+    std::array<AudioStream, MAX_AUDIO_CHANNEL_NUMBER> audio{};
+    std::array<bool, MAX_AUDIO_CHANNEL_NUMBER> inRecord{};
+
+    ForEachSector([&] (const SectorView& sector) {
+        if((sector.subheader.submode & cdia) == 0 || sector.subheader.channelNumber >= MAX_AUDIO_CHANNEL_NUMBER)
             return;
 
         // Green Book IV.3.2.4
-//         const bool emph  = bit<6>(disc.m_subheader.codingInformation);
-        const uint8_t bps = bits<4, 5>(disc.m_subheader.codingInformation);
-        const uint8_t sf = bits<2, 3>(disc.m_subheader.codingInformation);
-        const uint8_t ms = bits<0, 1>(disc.m_subheader.codingInformation);
+//         const bool emph  = bit<6>(sector.subheader.codingInformation);
+        const uint8_t bps = bits<4, 5>(sector.subheader.codingInformation);
+        const uint8_t sf = bits<2, 3>(sector.subheader.codingInformation);
+        const uint8_t ms = bits<0, 1>(sector.subheader.codingInformation);
 
         if(bps > 1 || sf > 1 || ms > 1) // ignore reserved values.
             return;
 
-        AudioInfo& a = audio[sector.subheader.channelNumber];
-        if(!a.left.empty() &&
-           (a.bps != bps ||
-            a.sf != sf ||
-            a.ms != ms))
-            Audio::writeWAV(directoryPath + name, a.left, a.right, sector.subheader.channelNumber, a.record++, a.bps, a.sf, a.ms);
+        const uint8_t channel = sector.subheader.channelNumber;
+        std::vector<AudioStream::Record>& records = audio[channel].records;
+        if(inRecord[channel] &&
+           (records.back().bps != bps ||
+            records.back().sf != sf ||
+            records.back().ms != ms))
+            inRecord[channel] = false;
 
-        a.bps = bps;
-        a.sf = sf;
-        a.ms = ms;
+        if(!inRecord[channel])
+        {
+            records.push_back({bps, sf, ms, {}});
+            inRecord[channel] = true;
+        }
 
-        Audio::decodeAudioSector(a.delay, bps, ms, sector.data.data(), a.left, a.right);
+        records.back().sectors.push_back(sector.lbn);
 
         if(sector.subheader.submode & cdieor)
-            Audio::writeWAV(directoryPath + name, a.left, a.right, sector.subheader.channelNumber, a.record++, a.bps, a.sf, a.ms);
+            inRecord[channel] = false;
     });
 
-    int channel = 0;
-    for(AudioInfo& a : audio)
+    for(uint8_t channel = 0; channel < audio.size(); channel++)
     {
-        if(!a.left.empty())
-            Audio::writeWAV(directoryPath + name, a.left, a.right, channel, a.record++, a.bps, a.sf, a.ms);
-        channel++;
+        if(!audio[channel].records.empty())
+        {
+            audio[channel].basename = directoryPath + name;
+            audio[channel].channel = channel;
+            streams.push_back(std::move(audio[channel]));
+        }
     }
 }
 
@@ -165,7 +174,7 @@ void CDIFile::ExportRawVideo(const std::string& directoryPath) const
     };
     std::array<VideoInfo, MAX_CHANNEL_NUMBER> video{};
 
-    ForEachSector([&] (const CDISector& sector) {
+    ForEachSector([&] (const SectorView& sector) {
         if((sector.subheader.submode & cdiv) == 0)
             return;
 
@@ -212,22 +221,11 @@ std::vector<uint8_t> CDIFile::GetContent() const
     data.reserve(readSize);
 
     readSize = size;
-    ForEachSector([&] (const CDISector& sector) {
+    ForEachSector([&] (const SectorView& sector) {
         const uint16_t sectorSize = sector.GetSectorDataSize();
         const uint32_t sz = readSize < sectorSize ? readSize : sectorSize;
-        // std::vector<uint8_t>::const_iterator begin = sector.data.begin();
-        decltype(sector.data)::const_iterator begin = sector.data.begin();
-
-        data.insert(data.end(), begin, begin + sz);
+        data.insert(data.end(), sector.data.begin(), sector.data.begin() + sz);
     });
 
     return data;
 }
-
-/** \brief Calls the given function on each sector or the file.
- * \param f The function to call.
- */
-void CDIFile::ForEachSector(std::function<void(const CDISector&)> f) const
-{
-    disc.ForEachFileSector(LBN, std::move(f));
-}
@@ -2,10 +2,10 @@
 #define CDI_CDIFILE_HPP
 
 class CDIDisc;
-struct CDISector;
+struct AudioStream;
+struct SectorView;
 
 #include <cstdint>
-#include <functional>
 #include <string>
 #include <vector>
 
@@ -24,11 +24,14 @@ public:
     CDIFile(CDIDisc& cdidisc, uint32_t lbn, uint32_t filesize, uint8_t namesize, std::string filename, uint16_t attr, uint8_t filenumber, uint16_t parentRelpos);
 
     void ExportAudio(const std::string& directoryPath) const;
+    void GetAudioStreams(const std::string& directoryPath, std::vector<AudioStream>& streams) const;
     void ExportFile(const std::string& directoryPath) const;
     void ExportRawVideo(const std::string& directoryPath) const;
     std::vector<uint8_t> GetContent() const;
 
-    void ForEachSector(std::function<void(const CDISector&)> f) const;
+    // Defined in CDIDisc.hpp.
+    template<typename F>
+    void ForEachSector(F&& f) const;
 
 private:
     CDIDisc& disc;
@@ -0,0 +1,424 @@
+#include "DiscImage.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef LIBCEDIMU_ENABLE_ZLIB
+#include <zlib.h>
+#endif // LIBCEDIMU_ENABLE_ZLIB
+
+static constexpr size_t HEADER_SIZE = DiscImage::COMPRESSED_MAGIC.size() + 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+static constexpr size_t HUNK_ENTRY_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+static constexpr uint32_t NO_HUNK = UINT32_MAX;
+
+template<typename T>
+static T getLE(const uint8_t* data) noexcept
+{
+    T value = 0;
+    for(size_t i = 0; i < sizeof(T); ++i)
+        value |= static_cast<T>(data[i]) << (i * 8);
+    return value;
+}
+
+template<typename T>
+static void writeLE(std::ostream& out, const T value)
+{
+    std::array<char, sizeof(T)> bytes;
+    for(size_t i = 0; i < sizeof(T); ++i)
+        bytes[i] = value >> (i * 8);
+    out.write(bytes.data(), bytes.size());
+}
+
+struct HunkEntry
+{
+    uint64_t offset;
+    uint32_t size;
+};
+
+/** \brief The state of an opened compressed image. */
+struct DiscImage::Compressed
+{
+    std::span<const uint8_t> file; /**< The compressed image. */
+    uint32_t hunkSectors;
+    size_t hunkSize; /**< Uncompressed size of a hunk, in bytes. */
+    uint64_t imageSize; /**< Uncompressed size of the image, in bytes. */
+    std::vector<HunkEntry> table;
+
+    // LRU cache, only used by the thread reading the image.
+    struct CachedHunk
+    {
+        std::vector<uint8_t> data;
+        std::list<uint32_t>::iterator lruPosition;
+    };
+    size_t cacheCapacity; /**< In hunks. */
+    std::unordered_map<uint32_t, CachedHunk> cache{};
+    std::list<uint32_t> lru{}; /**< Most recently used first. */
+    uint32_t lastHunk{NO_HUNK};
+
+    // Read-ahead, shared with the worker thread.
+    std::mutex mutex{};
+    std::condition_variable condition{};
+    std::deque<uint32_t> requests{};
+    std::unordered_map<uint32_t, std::vector<uint8_t>> prefetched{};
+    uint32_t pendingHunk{NO_HUNK}; /**< The hunk being decompressed by the worker thread. */
+    bool stop{false};
+    std::thread thread;
+
+    Compressed(std::span<const uint8_t> compressedFile, uint32_t sectors, uint64_t size, std::vector<HunkEntry> hunks, size_t cacheSizeMB)
+        : file{compressedFile}
+        , hunkSectors{sectors}
+        , hunkSize{sectors * SECTOR_SIZE}
+        , imageSize{size}
+        , table{std::move(hunks)}
+        , cacheCapacity{std::max<size_t>(READ_AHEAD_HUNKS, cacheSizeMB * 1024 * 1024 / hunkSize)}
+        , thread{&Compressed::ReadAheadLoop, this}
+    {}
+
+    ~Compressed() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        thread.join();
+    }
+
+    bool Decompress(uint32_t hunk, std::vector<uint8_t>& data) const;
+    std::span<const uint8_t> GetHunk(uint32_t hunk);
+    void ReadAheadLoop();
+};
+
+/** \brief Decompresses a hunk.
+ * \param hunk The hunk number.
+ * \param data Receives the uncompressed hunk.
+ * \return false if the hunk is corrupted.
+ */
+bool DiscImage::Compressed::Decompress(const uint32_t hunk, std::vector<uint8_t>& data) const
+{
+    const HunkEntry& entry = table[hunk];
+    const size_t size = std::min<uint64_t>(hunkSize, imageSize - static_cast<uint64_t>(hunk) * hunkSize);
+    data.resize(size);
+
+    if(entry.size == size)
+    {
+        std::copy_n(&file[entry.offset], size, data.begin());
+        return true;
+    }
+
+#ifdef LIBCEDIMU_ENABLE_ZLIB
+    uLongf length = size;
+    return uncompress(data.data(), &length, &file[entry.offset], entry.size) == Z_OK && length == size;
+#else
+    return false;
+#endif // LIBCEDIMU_ENABLE_ZLIB
+}
+
+/** \brief Returns the given uncompressed hunk from the cache, decompressing it if needed.
+ * \return The hunk, or an empty span if it is corrupted.
+ *
+ * The hunk stays valid until \ref cacheCapacity other hunks are read. When hunks are read in order, the next
+ * \ref READ_AHEAD_HUNKS ones are requested to the worker thread.
+ */
+std::span<const uint8_t> DiscImage::Compressed::GetHunk(const uint32_t hunk)
+{
+    if(auto it = cache.find(hunk); it != cache.end())
+    {
+        lru.splice(lru.begin(), lru, it->second.lruPosition);
+        return it->second.data;
+    }
+
+    const bool sequential = hunk == lastHunk + 1;
+    lastHunk = hunk;
+
+    std::vector<uint8_t> data;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] { return pendingHunk != hunk; });
+
+        if(auto it = prefetched.find(hunk); it != prefetched.end())
+            data = std::move(it->second);
+
+        // Drop what will not be read, the reads are no longer in order.
+        std::erase_if(prefetched, [hunk] (const auto& entry) { return entry.first <= hunk || entry.first > hunk + READ_AHEAD_HUNKS; });
+        std::erase_if(requests, [hunk] (const uint32_t request) { return request <= hunk || request > hunk + READ_AHEAD_HUNKS; });
+
+        if(sequential)
+        {
+            for(uint32_t next = hunk + 1; next <= hunk + READ_AHEAD_HUNKS && next < table.size(); ++next)
+                if(!cache.contains(next) && !prefetched.contains(next) && next != pendingHunk && std::find(requests.begin(), requests.end(), next) == requests.end())
+                    requests.push_back(next);
+            condition.notify_all();
+        }
+    }
+
+    if(data.empty() && !Decompress(hunk, data))
+        return {};
+
+    while(cache.size() >= cacheCapacity)
+    {
+        cache.erase(lru.back());
+        lru.pop_back();
+    }
+
+    lru.push_front(hunk);
+    return cache.emplace(hunk, CachedHunk{std::move(data), lru.begin()}).first->second.data;
+}
+
+void DiscImage::Compressed::ReadAheadLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true)
+    {
+        condition.wait(lock, [this] { return stop || !requests.empty(); });
+        if(stop)
+            return;
+
+        pendingHunk = requests.front();
+        requests.pop_front();
+        lock.unlock();
+
+        std::vector<uint8_t> data;
+        const bool decompressed = Decompress(pendingHunk, data);
+
+        lock.lock();
+        if(decompressed)
+            prefetched.emplace(pendingHunk, std::move(data));
+        pendingHunk = NO_HUNK;
+        condition.notify_all();
+    }
+}
+
+DiscImage::DiscImage() = default;
+
+DiscImage::~DiscImage() noexcept
+{
+    Close();
+}
+
+DiscImage::DiscImage(DiscImage&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+DiscImage& DiscImage::operator=(DiscImage&& other) noexcept
+{
+    if(this != &other)
+    {
+        Close(); // Stop the worker thread before unmapping the file it reads.
+        m_file = std::move(other.m_file);
+        m_compressed = std::move(other.m_compressed);
+    }
+    return *this;
+}
+
+/** \brief Opens a disc image, closing the one previously opened.
+ * \param path The raw or compressed disc image.
+ * \param cacheSizeMB The size of the cache of decompressed hunks, in MiB. Unused for raw images.
+ * \return true if opened successfully, false otherwise.
+ */
+bool DiscImage::Open(const std::filesystem::path& path, const size_t cacheSizeMB)
+{
+    Close();
+
+    if(!m_file.Open(path))
+        return false;
+
+    const std::span<const uint8_t> data = m_file.GetData();
+    if(data.size() < HEADER_SIZE || !std::equal(COMPRESSED_MAGIC.begin(), COMPRESSED_MAGIC.end(), data.begin()))
+    {
+        if(data.size() / SECTOR_SIZE <= MAX_SECTORS)
+            return true;
+
+        Close();
+        return false;
+    }
+
+#ifdef LIBCEDIMU_ENABLE_ZLIB
+    const uint8_t* header = &data[COMPRESSED_MAGIC.size()];
+    const uint32_t hunkSectors = getLE<uint32_t>(header);
+    const uint32_t hunkCount = getLE<uint32_t>(header + 4);
+    const uint64_t imageSize = getLE<uint64_t>(header + 8);
+    const uint64_t tableOffset = getLE<uint64_t>(header + 16);
+
+    const uint64_t hunkSize = static_cast<uint64_t>(hunkSectors) * SECTOR_SIZE;
+    if(hunkSectors == 0 || hunkSectors > MAX_HUNK_SECTORS || imageSize / SECTOR_SIZE > MAX_SECTORS ||
+       hunkCount != (imageSize + hunkSize - 1) / hunkSize ||
+       tableOffset > data.size() || (data.size() - tableOffset) / HUNK_ENTRY_SIZE < hunkCount)
+    {
+        Close();
+        return false;
+    }
+
+    std::vector<HunkEntry> table(hunkCount);
+    for(uint32_t hunk = 0; hunk < hunkCount; ++hunk)
+    {
+        const uint8_t* entry = &data[tableOffset + hunk * HUNK_ENTRY_SIZE];
+        table[hunk] = {getLE<uint64_t>(entry), getLE<uint32_t>(entry + 8)};
+
+        // A hunk is never stored bigger than uncompressed, so the image size is bounded by the file size.
+        const uint64_t uncompressedSize = std::min(hunkSize, imageSize - hunk * hunkSize);
+        if(table[hunk].offset > tableOffset || table[hunk].size > tableOffset - table[hunk].offset ||
+           table[hunk].size == 0 || table[hunk].size > uncompressedSize)
+        {
+            Close();
+            return false;
+        }
+    }
+
+    m_compressed = std::make_unique<Compressed>(data, hunkSectors, imageSize, std::move(table), cacheSizeMB);
+    return true;
+#else
+    static_cast<void>(cacheSizeMB);
+    Close();
+    return false;
+#endif // LIBCEDIMU_ENABLE_ZLIB
+}
+
+/** \brief Closes the image, invalidating the data previously returned. */
+void DiscImage::Close() noexcept
+{
+    m_compressed.reset();
+    m_file.Close();
+}
+
+/** \brief Returns the uncompressed size of the image in bytes. */
+uint64_t DiscImage::GetSize() const noexcept
+{
+    return m_compressed ? m_compressed->imageSize : m_file.GetSize();
+}
+
+/** \brief Returns the raw sector at the given Logical Block Number.
+ * \return The 2352 bytes of the sector, or an empty span if it is outside the image or cannot be decompressed.
+ *
+ * For raw images the sector is valid until the image is closed. For compressed images it is only valid until a few
+ * other sectors are read, as its hunk may be evicted from the cache.
+ */
+std::span<const uint8_t> DiscImage::GetSector(const uint32_t lbn)
+{
+    if(lbn >= GetSectorCount())
+        return {};
+
+    if(!m_compressed)
+        return m_file.GetData().subspan(lbn * SECTOR_SIZE, SECTOR_SIZE);
+
+    const std::span<const uint8_t> hunk = m_compressed->GetHunk(lbn / m_compressed->hunkSectors);
+    const size_t offset = lbn % m_compressed->hunkSectors * SECTOR_SIZE;
+    if(hunk.size() < offset + SECTOR_SIZE)
+        return {};
+    return hunk.subspan(offset, SECTOR_SIZE);
+}
+
+/** \brief Copies bytes of the uncompressed image.
+ * \param offset The offset of the first byte in the image.
+ * \param dst Receives the bytes.
+ * \return false if the bytes are outside the image or cannot be decompressed.
+ */
+bool DiscImage::Read(const uint64_t offset, std::span<uint8_t> dst)
+{
+    if(offset > GetSize() || dst.size() > GetSize() - offset)
+        return false;
+
+    if(!m_compressed)
+    {
+        std::copy_n(&m_file.GetData()[offset], dst.size(), dst.begin());
+        return true;
+    }
+
+    uint64_t position = offset;
+    while(!dst.empty())
+    {
+        const std::span<const uint8_t> hunk = m_compressed->GetHunk(position / m_compressed->hunkSize);
+        const size_t hunkOffset = position % m_compressed->hunkSize;
+        if(hunk.size() <= hunkOffset)
+            return false;
+
+        const size_t size = std::min(dst.size(), hunk.size() - hunkOffset);
+        std::copy_n(&hunk[hunkOffset], size, dst.begin());
+        dst = dst.subspan(size);
+        position += size;
+    }
+
+    return true;
+}
+
+/** \brief Compresses a raw disc image.
+ * \param input The raw disc image.
+ * \param output The compressed image to write.
+ * \param hunkSectors The number of sectors per hunk, at most \ref DiscImage::MAX_HUNK_SECTORS. Bigger hunks compress
+ * better, smaller ones are faster to seek.
+ * \return true if the compressed image has been written, false otherwise.
+ *
+ * Requires LIBCEDIMU_ENABLE_ZLIB, always returns false without it.
+ */
+bool compressDiscImage(const std::filesystem::path& input, const std::filesystem::path& output, const uint32_t hunkSectors)
+{
+#ifdef LIBCEDIMU_ENABLE_ZLIB
+    if(hunkSectors == 0 || hunkSectors > DiscImage::MAX_HUNK_SECTORS)
+        return false;
+
+    MappedFile in(input);
+    std::ofstream out(output, std::ios::out | std::ios::binary);
+    if(!in.IsOpen() || !out.is_open())
+        return false;
+
+    const std::span<const uint8_t> image = in.GetData();
+    const size_t hunkSize = hunkSectors * SECTOR_SIZE;
+    const size_t hunkCount = (image.size() + hunkSize - 1) / hunkSize;
+    if(image.size() / SECTOR_SIZE > DiscImage::MAX_SECTORS)
+        return false;
+
+    const auto writeHeader = [&] (const uint64_t tableOffset) {
+        out.write(DiscImage::COMPRESSED_MAGIC.data(), DiscImage::COMPRESSED_MAGIC.size());
+        writeLE<uint32_t>(out, hunkSectors);
+        writeLE<uint32_t>(out, hunkCount);
+        writeLE<uint64_t>(out, image.size());
+        writeLE<uint64_t>(out, tableOffset);
+    };
+    writeHeader(0);
+
+    std::vector<HunkEntry> table(hunkCount);
+    std::vector<uint8_t> buffer(compressBound(hunkSize));
+    uint64_t offset = HEADER_SIZE;
+    for(size_t hunk = 0; hunk < hunkCount; ++hunk)
+    {
+        const std::span<const uint8_t> data = image.subspan(hunk * hunkSize, std::min(hunkSize, image.size() - hunk * hunkSize));
+
+        uLongf size = buffer.size();
+        if(compress2(buffer.data(), &size, data.data(), data.size(), Z_BEST_COMPRESSION) == Z_OK && size < data.size())
+            out.write(reinterpret_cast<const char*>(buffer.data()), size);
+        else // Store the hunk uncompressed.
+        {
+            size = data.size();
+            out.write(reinterpret_cast<const char*>(data.data()), size);
+        }
+
+        table[hunk] = {offset, static_cast<uint32_t>(size)};
+        offset += size;
+    }
+
+    for(const HunkEntry& entry : table)
+    {
+        writeLE<uint64_t>(out, entry.offset);
+        writeLE<uint32_t>(out, entry.size);
+    }
+
+    out.seekp(0);
+    writeHeader(offset);
+    return out.good();
+#else
+    static_cast<void>(input);
+    static_cast<void>(output);
+    static_cast<void>(hunkSectors);
+    return false;
+#endif // LIBCEDIMU_ENABLE_ZLIB
+}
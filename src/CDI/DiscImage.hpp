@@ -0,0 +1,75 @@
+#ifndef CDI_DISCIMAGE_HPP
+#define CDI_DISCIMAGE_HPP
+
+#include "common/MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+
+/** \brief The size of a raw sector in a disc image. */
+static constexpr size_t SECTOR_SIZE = 2352;
+
+/** \brief A raw disc image (2352 bytes per sector), either a plain BIN file or a compressed image.
+ *
+ * Compressed images are made of hunks of consecutive sectors compressed with zlib, each of them can be decompressed
+ * on its own. The decompressed hunks are kept in an LRU cache. When the hunks are read in order, a worker thread
+ * decompresses the next ones ahead of time.
+ *
+ * Compressed image format (little-endian):
+ * - header: the magic number, uint32_t sectors per hunk, uint32_t hunk count, uint64_t uncompressed size,
+ *   uint64_t offset of the hunk table.
+ * - the compressed hunks.
+ * - the hunk table: for each hunk its uint64_t offset and uint32_t size. A hunk stored with its uncompressed size is
+ *   not compressed.
+ *
+ * Compressed images can only be read when the library is built with LIBCEDIMU_ENABLE_ZLIB. Images bigger than
+ * \ref MAX_SECTORS or with hunks bigger than \ref MAX_HUNK_SECTORS are rejected.
+ *
+ * This class is not thread-safe.
+ */
+class DiscImage
+{
+public:
+    static constexpr std::string_view COMPRESSED_MAGIC{"CDIZIMG1"};
+    static constexpr uint32_t DEFAULT_HUNK_SECTORS = 8;
+    static constexpr size_t DEFAULT_CACHE_SIZE_MB = 32;
+    static constexpr uint32_t READ_AHEAD_HUNKS = 4;
+    static constexpr uint32_t MAX_HUNK_SECTORS = 1024;
+    static constexpr uint32_t MAX_SECTORS = 100 * 60 * 75; /**< The sectors addressable by a disc time (100 minutes). */
+
+    DiscImage();
+    ~DiscImage() noexcept;
+
+    DiscImage(const DiscImage&) = delete;
+    DiscImage& operator=(const DiscImage&) = delete;
+    DiscImage(DiscImage&& other) noexcept;
+    DiscImage& operator=(DiscImage&& other) noexcept;
+
+    bool Open(const std::filesystem::path& path, size_t cacheSizeMB = DEFAULT_CACHE_SIZE_MB);
+    void Close() noexcept;
+    /** \brief Returns true if an image is opened. */
+    bool IsOpen() const noexcept { return m_file.IsOpen(); }
+    /** \brief Returns true if the opened image is compressed. */
+    bool IsCompressed() const noexcept { return m_compressed != nullptr; }
+
+    uint64_t GetSize() const noexcept;
+    /** \brief Returns the number of whole sectors in the image. */
+    uint32_t GetSectorCount() const noexcept { return static_cast<uint32_t>(GetSize() / SECTOR_SIZE); }
+
+    std::span<const uint8_t> GetSector(uint32_t lbn);
+    bool Read(uint64_t offset, std::span<uint8_t> dst);
+
+private:
+    struct Compressed;
+
+    MappedFile m_file;
+    std::unique_ptr<Compressed> m_compressed; /**< On the heap so the worker thread keeps its address on move. */
+};
+
+bool compressDiscImage(const std::filesystem::path& input, const std::filesystem::path& output, uint32_t hunkSectors = DiscImage::DEFAULT_HUNK_SECTORS);
+
+#endif // CDI_DISCIMAGE_HPP
@@ -0,0 +1,298 @@
+#include "DiscScanner.hpp"
+#include "CDIDisc.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <map>
+#include <string_view>
+#include <thread>
+
+/** \brief Opens a disc image and gathers its catalogue entry.
+ * \param path The raw or compressed disc image.
+ * \param saveSectorIndex If true, the sector index built by the scan is saved next to the image.
+ *
+ * The sector statistics come from the sector index of the disc. When it has not been saved, the whole image is read to
+ * build it. Nothing is written next to the image unless \p saveSectorIndex is true, in which case scanning the disc
+ * again reads the saved index instead of the whole image.
+ */
+DiscCatalogueEntry scanDisc(const std::filesystem::path& path, const bool saveSectorIndex)
+{
+    DiscCatalogueEntry entry{};
+    entry.path = path;
+
+    std::error_code error;
+    entry.fileSize = std::filesystem::file_size(path, error);
+    if(error)
+        entry.fileSize = 0;
+
+    CDIDisc disc;
+    if(!disc.Open(path.string()))
+        return entry;
+
+    entry.opened = true;
+    entry.gameName = disc.m_gameName;
+    entry.mainModule = disc.m_mainModule;
+
+    disc.ForEachFile([&entry] (std::string_view directory, const CDIFile& file) {
+        directory.remove_prefix(1); // The paths do not start with '/'.
+        entry.files.push_back({std::string(directory) + file.name, file.LBN, file.size, file.attributes, file.number});
+    });
+
+    const SectorIndex& index = disc.GetSectorIndex(saveSectorIndex);
+    DiscSectorStats& stats = entry.sectors;
+    stats.total = index.GetSectorCount();
+    for(uint32_t lbn = 0; lbn < stats.total; lbn++)
+    {
+        const uint8_t submode = index[lbn].submode;
+        stats.data += (submode & cdid) != 0;
+        stats.audio += (submode & cdia) != 0;
+        stats.video += (submode & cdiv) != 0;
+        stats.empty += (submode & cdiany) == 0;
+        stats.form2 += (submode & cdiform) != 0;
+        stats.realTime += (submode & cdirt) != 0;
+        stats.endOfRecord += (submode & cdieor) != 0;
+        stats.endOfFile += (submode & cdieof) != 0;
+    }
+
+    return entry;
+}
+
+/** \brief Scans many disc images concurrently.
+ * \param paths The raw or compressed disc images.
+ * \param threadCount The number of threads, or 0 for one per hardware thread.
+ * \param saveSectorIndex If true, the sector index of each image is saved next to it, see \ref scanDisc.
+ * \return The catalogue entry of each image, in the same order as \p paths.
+ *
+ * Each thread opens its own \ref CDIDisc on a memory-mapped image, so the discs are read in parallel without any
+ * lock. See \ref scanDisc. An image given several times is only scanned once. An image that throws while being
+ * scanned is reported as not opened.
+ */
+std::vector<DiscCatalogueEntry> scanDiscLibrary(std::span<const std::filesystem::path> paths, size_t threadCount, const bool saveSectorIndex)
+{
+    // Each image is scanned once, so two threads never write the same sector index file.
+    std::vector<size_t> uniquePaths; // Index in paths of the first occurrence of each image.
+    std::vector<size_t> uniqueIndex(paths.size()); // Index in uniquePaths of each path.
+    std::map<std::filesystem::path, size_t> seen;
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        std::error_code error;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(paths[i], error);
+        if(error)
+            canonical = paths[i].lexically_normal();
+
+        const auto [it, inserted] = seen.try_emplace(std::move(canonical), uniquePaths.size());
+        if(inserted)
+            uniquePaths.push_back(i);
+        uniqueIndex[i] = it->second;
+    }
+
+    std::vector<DiscCatalogueEntry> uniqueCatalogue(uniquePaths.size());
+    std::atomic<size_t> nextDisc{0};
+
+    const auto scan = [&] {
+        for(size_t i = nextDisc++; i < uniquePaths.size(); i = nextDisc++)
+        {
+            const std::filesystem::path& path = paths[uniquePaths[i]];
+            try
+            {
+                uniqueCatalogue[i] = scanDisc(path, saveSectorIndex);
+            }
+            catch(const std::exception&) // Corrupted disc, the other ones are still scanned.
+            {
+                uniqueCatalogue[i] = DiscCatalogueEntry{};
+                uniqueCatalogue[i].path = path;
+                std::error_code error;
+                uniqueCatalogue[i].fileSize = std::filesystem::file_size(path, error);
+                if(error)
+                    uniqueCatalogue[i].fileSize = 0;
+            }
+        }
+    };
+
+    if(threadCount == 0)
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = std::min(threadCount, uniquePaths.size());
+
+    std::vector<std::thread> threads;
+    for(size_t i = 1; i < threadCount; i++)
+        threads.emplace_back(scan);
+
+    scan();
+
+    for(std::thread& thread : threads)
+        thread.join();
+
+    std::vector<DiscCatalogueEntry> catalogue(paths.size());
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        catalogue[i] = uniqueCatalogue[uniqueIndex[i]];
+        catalogue[i].path = paths[i];
+    }
+
+    return catalogue;
+}
+
+/** \brief Returns the length of the UTF-8 sequence at the start of \p str, or 0 if it is not valid UTF-8. */
+static size_t getUTF8SequenceLength(const std::string_view str) noexcept
+{
+    const uint8_t lead = str[0];
+    size_t length;
+    uint32_t codePoint;
+    if(lead < 0x80)
+        return 1;
+    else if(lead >= 0xC2 && lead <= 0xDF)
+    {
+        length = 2;
+        codePoint = lead & 0x1F;
+    }
+    else if(lead >= 0xE0 && lead <= 0xEF)
+    {
+        length = 3;
+        codePoint = lead & 0x0F;
+    }
+    else if(lead >= 0xF0 && lead <= 0xF4)
+    {
+        length = 4;
+        codePoint = lead & 0x07;
+    }
+    else
+        return 0;
+
+    if(str.size() < length)
+        return 0;
+
+    for(size_t i = 1; i < length; i++)
+    {
+        const uint8_t byte = str[i];
+        if((byte & 0xC0) != 0x80)
+            return 0;
+        codePoint = codePoint << 6 | (byte & 0x3F);
+    }
+
+    // Overlong encodings, surrogates and code points above U+10FFFF.
+    if((length == 3 && codePoint < 0x800) || (length == 4 && codePoint < 0x10000) ||
+       (codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+        return 0;
+
+    return length;
+}
+
+/** \brief Writes a JSON string.
+ *
+ * Valid UTF-8 is written as is. The bytes that are not valid UTF-8 are escaped as ISO 8859-1 characters, which is
+ * what the disc names are usually encoded with.
+ */
+static void writeJSONString(std::ostream& out, std::string_view str)
+{
+    out << '"';
+    while(!str.empty())
+    {
+        const char c = str[0];
+        const uint8_t byte = c;
+        const size_t length = getUTF8SequenceLength(str);
+        if(c == '"' || c == '\\')
+            out << '\\' << c;
+        else if(byte < 0x20 || length == 0)
+        {
+            char escaped[7];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04X", byte);
+            out << escaped;
+        }
+        else
+            out << str.substr(0, length);
+
+        str.remove_prefix(std::max<size_t>(length, 1));
+    }
+    out << '"';
+}
+
+/** \brief Writes a CSV field, quoted if needed. */
+static void writeCSVField(std::ostream& out, const std::string_view str)
+{
+    if(str.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        out << str;
+        return;
+    }
+
+    out << '"';
+    for(const char c : str)
+    {
+        if(c == '"')
+            out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+/** \brief Writes the catalogue as a JSON array, with an object for each disc that includes its files. */
+void writeCatalogueJSON(std::ostream& out, std::span<const DiscCatalogueEntry> catalogue)
+{
+    out << "[";
+    for(size_t i = 0; i < catalogue.size(); i++)
+    {
+        const DiscCatalogueEntry& entry = catalogue[i];
+        const DiscSectorStats& stats = entry.sectors;
+
+        out << (i ? ",\n" : "\n") << "  {\n    \"path\": ";
+        writeJSONString(out, entry.path.string());
+        out << ",\n    \"fileSize\": " << entry.fileSize;
+        out << ",\n    \"opened\": " << (entry.opened ? "true" : "false");
+        out << ",\n    \"gameName\": ";
+        writeJSONString(out, entry.gameName);
+        out << ",\n    \"mainModule\": ";
+        writeJSONString(out, entry.mainModule);
+        out << ",\n    \"sectors\": {"
+            << "\"total\": " << stats.total
+            << ", \"data\": " << stats.data
+            << ", \"audio\": " << stats.audio
+            << ", \"video\": " << stats.video
+            << ", \"empty\": " << stats.empty
+            << ", \"form2\": " << stats.form2
+            << ", \"realTime\": " << stats.realTime
+            << ", \"endOfRecord\": " << stats.endOfRecord
+            << ", \"endOfFile\": " << stats.endOfFile << "}";
+
+        out << ",\n    \"files\": [";
+        for(size_t f = 0; f < entry.files.size(); f++)
+        {
+            const DiscCatalogueFile& file = entry.files[f];
+            out << (f ? ",\n" : "\n") << "      {\"path\": ";
+            writeJSONString(out, file.path);
+            out << ", \"lbn\": " << file.lbn
+                << ", \"size\": " << file.size
+                << ", \"attributes\": " << file.attributes
+                << ", \"number\": " << +file.number << "}";
+        }
+        out << (entry.files.empty() ? "]" : "\n    ]") << "\n  }";
+    }
+    out << (catalogue.empty() ? "]\n" : "\n]\n");
+}
+
+/** \brief Writes the catalogue as CSV, with a line for each disc. The files are not listed. */
+void writeCatalogueCSV(std::ostream& out, std::span<const DiscCatalogueEntry> catalogue)
+{
+    out << "path,fileSize,opened,gameName,mainModule,files,sectors,data,audio,video,empty,form2,realTime,endOfRecord,endOfFile\n";
+    for(const DiscCatalogueEntry& entry : catalogue)
+    {
+        const DiscSectorStats& stats = entry.sectors;
+
+        writeCSVField(out, entry.path.string());
+        out << ',' << entry.fileSize << ',' << entry.opened << ',';
+        writeCSVField(out, entry.gameName);
+        out << ',';
+        writeCSVField(out, entry.mainModule);
+        out << ',' << entry.files.size()
+            << ',' << stats.total
+            << ',' << stats.data
+            << ',' << stats.audio
+            << ',' << stats.video
+            << ',' << stats.empty
+            << ',' << stats.form2
+            << ',' << stats.realTime
+            << ',' << stats.endOfRecord
+            << ',' << stats.endOfFile << '\n';
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef CDI_DISCSCANNER_HPP
+#define CDI_DISCSCANNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+/** \brief The number of sectors of each kind on a disc, from their submode. */
+struct DiscSectorStats
+{
+    uint32_t total;
+    uint32_t data;
+    uint32_t audio;
+    uint32_t video;
+    uint32_t empty; /**< No data, audio or video bit. */
+    uint32_t form2;
+    uint32_t realTime;
+    uint32_t endOfRecord;
+    uint32_t endOfFile;
+};
+
+/** \brief A file of a disc in \ref DiscCatalogueEntry. */
+struct DiscCatalogueFile
+{
+    std::string path; /**< From the root directory, without a leading '/', see \ref CDIDisc::GetFile. */
+    uint32_t lbn;
+    uint32_t size;
+    uint16_t attributes;
+    uint8_t number;
+};
+
+/** \brief What \ref scanDiscLibrary has found about a disc image. */
+struct DiscCatalogueEntry
+{
+    std::filesystem::path path;
+    uint64_t fileSize; /**< The size of the image file, which may be compressed, or 0 if it does not exist. */
+    bool opened; /**< false if the image cannot be read or is not a CD-I disc, the members below are then empty. */
+    std::string gameName;
+    std::string mainModule;
+    DiscSectorStats sectors;
+    std::vector<DiscCatalogueFile> files;
+};
+
+DiscCatalogueEntry scanDisc(const std::filesystem::path& path, bool saveSectorIndex = false);
+std::vector<DiscCatalogueEntry> scanDiscLibrary(std::span<const std::filesystem::path> paths, size_t threadCount = 0, bool saveSectorIndex = false);
+
+void writeCatalogueJSON(std::ostream& out, std::span<const DiscCatalogueEntry> catalogue);
+void writeCatalogueCSV(std::ostream& out, std::span<const DiscCatalogueEntry> catalogue);
+
+#endif // CDI_DISCSCANNER_HPP
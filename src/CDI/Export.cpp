@@ -1,14 +1,24 @@
 #include "CDIDisc.hpp"
+#include "common/Audio.hpp"
 #include "common/utils.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 /** \brief Exports the audio data in the disc.
  * \param path The directory where to write the data.
  * \return true if the disc was opened, false if no disc was opened.
- * \throw std::filesystem::filesystem_error if it cannot create directories.
+ * \throw std::filesystem::filesystem_error if it cannot create directories or files.
  */
 bool CDIDisc::ExportAudio(const std::string& path)
 {
@@ -17,11 +27,117 @@ bool CDIDisc::ExportAudio(const std::string& path)
 
     std::string currentPath = path + "/" + m_gameName + "/audio/";
 
-    m_rootDirectory.ExportAudio(currentPath);
+    GetSectorIndex(); // The files are read sector by sector, the index avoids scanning the interleaved files.
+    std::vector<AudioStream> streams;
+    m_rootDirectory.GetAudioStreams(currentPath, streams);
+    exportAudioStreams(m_image, streams);
 
     return true;
 }
 
+/** \brief Decodes the given audio streams and writes their records to WAV files.
+ * \param image The disc image that contains the sectors of the streams.
+ * \param streams The audio streams.
+ * \throw std::filesystem::filesystem_error if a WAV file cannot be created or written.
+ *
+ * The streams are decoded in parallel, one thread per stream. The sectors of a stream are decoded in order because
+ * the ADPCM decoder depends on the previous samples. The disc image is not thread-safe, so the sectors are copied
+ * under a lock. The samples are written every few sectors, so the memory used does not depend on the length of the
+ * records.
+ *
+ * The first exception thrown by a thread stops the other ones, and is rethrown once they have all been joined.
+ */
+void exportAudioStreams(DiscImage& image, std::span<const AudioStream> streams)
+{
+    static constexpr size_t BLOCK_SECTORS = 16; /**< Number of sectors decoded before being written. */
+
+    std::mutex imageMutex;
+    std::atomic<size_t> nextStream{0};
+    std::exception_ptr exception;
+
+    const auto decodeStream = [&] (const AudioStream& stream, std::array<uint8_t, Audio::SECTOR_DATA_SIZE>& data, std::vector<int16_t>& left, std::vector<int16_t>& right, Audio::WAVWriter& wav) {
+        Audio::SamplesDelay delay{};
+
+        for(size_t record = 0; record < stream.records.size(); record++)
+        {
+            const AudioStream::Record& r = stream.records[record];
+            const Audio::WAVHeader header{static_cast<uint16_t>(r.ms + 1), r.sf ? 18900u : 37800u};
+            const std::string path = Audio::getWAVPath(stream.basename, stream.channel, record, r.bps, r.sf);
+            if(!wav.Open(path, header))
+                throw std::filesystem::filesystem_error("Failed to create WAV file", path, std::make_error_code(std::errc::io_error));
+            size_t position = 0;
+
+            for(const uint32_t lbn : r.sectors)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(imageMutex);
+                    const std::span<const uint8_t> sector = image.GetSector(lbn);
+                    if(sector.empty())
+                        data.fill(0);
+                    else
+                        std::copy_n(sector.begin() + 24, data.size(), data.begin());
+                }
+
+                if(position + Audio::LEVEL_BC_SECTOR_SAMPLES > left.size())
+                {
+                    if(!wav.Write(std::span(left).first(position), std::span(right).first(position)))
+                        throw std::filesystem::filesystem_error("Failed to write WAV file", path, std::make_error_code(std::errc::io_error));
+                    position = 0;
+                }
+
+                position += Audio::decodeAudioSector(delay, r.bps, r.ms, data, std::span(left).subspan(position), std::span(right).subspan(position));
+            }
+
+            if(!wav.Write(std::span(left).first(position), std::span(right).first(position)) || !wav.Close())
+                throw std::filesystem::filesystem_error("Failed to write WAV file", path, std::make_error_code(std::errc::io_error));
+        }
+    };
+
+    const auto decode = [&] {
+        try
+        {
+            std::array<uint8_t, Audio::SECTOR_DATA_SIZE> data;
+            std::vector<int16_t> left(BLOCK_SECTORS * Audio::LEVEL_BC_SECTOR_SAMPLES);
+            std::vector<int16_t> right(BLOCK_SECTORS * Audio::LEVEL_BC_SECTOR_SAMPLES);
+            Audio::WAVWriter wav;
+
+            for(size_t i = nextStream++; i < streams.size(); i = nextStream++)
+                decodeStream(streams[i], data, left, right, wav);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(imageMutex);
+            if(!exception)
+                exception = std::current_exception();
+            nextStream = streams.size();
+        }
+    };
+
+    const size_t threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), streams.size());
+    std::vector<std::thread> threads;
+    try
+    {
+        threads.reserve(threadCount);
+        for(size_t i = 1; i < threadCount; i++)
+            threads.emplace_back(decode);
+    }
+    catch(...) // The threads already started are stopped after their current stream.
+    {
+        nextStream = streams.size();
+        for(std::thread& thread : threads)
+            thread.join();
+        throw;
+    }
+
+    decode();
+
+    for(std::thread& thread : threads)
+        thread.join();
+
+    if(exception)
+        std::rethrow_exception(exception);
+}
+
 /** \brief Exports the files contained in the disc.
  * \param path The directory where to write the data.
  * \return true if the disc was opened, false if no disc was opened.
@@ -37,6 +153,7 @@ bool CDIDisc::ExportFiles(const std::string& path)
 
     std::string currentPath = path + "/" + m_gameName + "/files/";
 
+    GetSectorIndex();
     m_rootDirectory.ExportFiles(currentPath);
 
     return true;
@@ -76,6 +193,7 @@ bool CDIDisc::ExportRawVideo(const std::string& path)
 
     std::string currentPath = path + "/" + m_gameName + "/rawvideo/";
 
+    GetSectorIndex();
     m_rootDirectory.ExportRawVideo(currentPath);
 
     return true;
@@ -98,7 +216,7 @@ bool CDIDisc::ExportSectorsInfo(const std::string& path)
     out << "   LBN Min secs sect mode file channel  submode codingInfo" << std::endl;
 
     uint32_t LBN = 0;
-    ForEachSector([&] (const CDISector& sector) {
+    ForEachSector([&] (const SectorView& sector) {
         out << std::right << std::setw(6) << std::to_string(LBN++)
             << std::setw(4) << std::to_string(sector.header.minute)
             << std::setw(5) << std::to_string(sector.header.second)
@@ -0,0 +1,232 @@
+#include "SectorIndex.hpp"
+#include "CDIDisc.hpp"
+#include "DiscImage.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <memory>
+#include <span>
+
+static constexpr size_t SUBHEADER_OFFSET = 16;
+static constexpr size_t HASHED_SECTORS = 32; /**< The first sectors, that contain the volume descriptors. */
+
+template<typename T>
+static void writeLE(std::ostream& out, const T value)
+{
+    std::array<char, sizeof(T)> bytes;
+    for(size_t i = 0; i < sizeof(T); ++i)
+        bytes[i] = value >> (i * 8);
+    out.write(bytes.data(), bytes.size());
+}
+
+template<typename T>
+static T readLE(std::istream& in)
+{
+    std::array<char, sizeof(T)> bytes{};
+    in.read(bytes.data(), bytes.size());
+
+    T value = 0;
+    for(size_t i = 0; i < sizeof(T); ++i)
+        value |= static_cast<T>(static_cast<uint8_t>(bytes[i])) << (i * 8);
+    return value;
+}
+
+/** \brief Builds the index from a disc image.
+ * \param image The disc image. A trailing partial sector is ignored.
+ */
+void SectorIndex::Build(DiscImage& image)
+{
+    const uint32_t count = image.GetSectorCount();
+    m_sectors.resize(count);
+    for(uint32_t lbn = 0; lbn < count; ++lbn)
+    {
+        const std::span<const uint8_t> sector = image.GetSector(lbn);
+        if(sector.empty()) // Corrupted compressed hunk.
+            m_sectors[lbn] = {};
+        else
+            m_sectors[lbn] = {sector[SUBHEADER_OFFSET], sector[SUBHEADER_OFFSET + 1], sector[SUBHEADER_OFFSET + 2], sector[SUBHEADER_OFFSET + 3]};
+    }
+
+    BuildLinks();
+}
+
+/** \brief Loads an index saved by \ref Save.
+ * \param path The index file.
+ * \param imageHash The hash of the disc image, see \ref ComputeImageHash.
+ * \return false if the file cannot be read or has been made for another image, in which case the index is empty.
+ */
+bool SectorIndex::Load(const std::filesystem::path& path, const uint64_t imageHash)
+{
+    Clear();
+
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    std::array<char, MAGIC.size()> magic{};
+    in.read(magic.data(), magic.size());
+    if(!in || !std::equal(magic.begin(), magic.end(), MAGIC.begin()) || readLE<uint64_t>(in) != imageHash)
+        return false;
+
+    const uint32_t count = readLE<uint32_t>(in);
+    std::error_code error;
+    if(std::filesystem::file_size(path, error) != MAGIC.size() + sizeof(uint64_t) + sizeof(uint32_t) + count * sizeof(SectorInfo))
+        return false;
+
+    m_sectors.resize(count);
+    in.read(reinterpret_cast<char*>(m_sectors.data()), m_sectors.size() * sizeof(SectorInfo));
+    if(!in)
+    {
+        Clear();
+        return false;
+    }
+
+    BuildLinks();
+    return true;
+}
+
+/** \brief Saves the index to a file.
+ * \param path The index file.
+ * \param imageHash The hash of the disc image, see \ref ComputeImageHash.
+ * \return true if the file has been written, false otherwise.
+ *
+ * The format is the magic number, the image hash (uint64_t LE), the sector count (uint32_t LE), then the 4 bytes of
+ * \ref SectorInfo of each sector. The links are built again on load.
+ */
+bool SectorIndex::Save(const std::filesystem::path& path, const uint64_t imageHash) const
+{
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    out.write(MAGIC.data(), MAGIC.size());
+    writeLE<uint64_t>(out, imageHash);
+    writeLE<uint32_t>(out, m_sectors.size());
+    out.write(reinterpret_cast<const char*>(m_sectors.data()), m_sectors.size() * sizeof(SectorInfo));
+    return out.good();
+}
+
+/** \brief Empties the index. */
+void SectorIndex::Clear() noexcept
+{
+    m_sectors.clear();
+    m_nextInFile.clear();
+    m_nextInChannel.clear();
+    m_nextEndOfFile.clear();
+}
+
+void SectorIndex::BuildLinks()
+{
+    m_nextInFile.resize(m_sectors.size());
+    m_nextInChannel.resize(m_sectors.size());
+    m_nextEndOfFile.resize(m_sectors.size());
+
+    std::array<uint32_t, 256> lastInFile;
+    std::unique_ptr<std::array<uint32_t, 256 * 256>> lastInChannel = std::make_unique<std::array<uint32_t, 256 * 256>>();
+    lastInFile.fill(NO_SECTOR);
+    lastInChannel->fill(NO_SECTOR);
+    uint32_t lastEndOfFile = NO_SECTOR;
+
+    for(size_t lbn = m_sectors.size(); lbn-- > 0;)
+    {
+        const SectorInfo& sector = m_sectors[lbn];
+        const size_t channel = sector.fileNumber << 8 | sector.channelNumber;
+
+        m_nextInFile[lbn] = lastInFile[sector.fileNumber];
+        m_nextInChannel[lbn] = (*lastInChannel)[channel];
+        m_nextEndOfFile[lbn] = lastEndOfFile;
+        lastInFile[sector.fileNumber] = lbn;
+        (*lastInChannel)[channel] = lbn;
+        if(sector.submode & cdieof)
+            lastEndOfFile = lbn;
+    }
+}
+
+/** \brief Returns the next sector that matches the given file, channel and submode.
+ * \param lbn The sector to search from (excluded).
+ * \param fileNumber The file number, or nullopt for any file.
+ * \param channelNumber The channel number, or nullopt for any channel.
+ * \param submodeMask At least one of these submode bits must be set, or 0 for any submode.
+ * \return The Logical Block Number of the sector, or nullopt if there is none.
+ *
+ * When \p lbn is a sector of the file (and channel), the next one is found without scanning the sectors in between.
+ */
+std::optional<uint32_t> SectorIndex::NextSector(const uint32_t lbn, const std::optional<uint8_t> fileNumber, const std::optional<uint8_t> channelNumber, const uint8_t submodeMask) const noexcept
+{
+    const auto isInChannel = [&] (const SectorInfo& sector) {
+        return !channelNumber || sector.channelNumber == *channelNumber;
+    };
+    const auto matches = [&] (const SectorInfo& sector) {
+        return (!fileNumber || sector.fileNumber == *fileNumber) && isInChannel(sector) && (submodeMask == 0 || (sector.submode & submodeMask));
+    };
+
+    uint32_t next = lbn;
+    if(!fileNumber || next >= m_sectors.size() || m_sectors[next].fileNumber != *fileNumber)
+    {
+        // Scan up to the first sector of the file to follow its links.
+        for(next = lbn + 1; next < m_sectors.size(); next++)
+        {
+            if(matches(m_sectors[next]))
+                return next;
+            if(fileNumber && m_sectors[next].fileNumber == *fileNumber)
+                break;
+        }
+
+        if(next >= m_sectors.size())
+            return std::nullopt;
+    }
+
+    // Follow the file until a sector of the channel is found, then follow the channel.
+    const std::vector<uint32_t>* links = channelNumber && isInChannel(m_sectors[next]) ? &m_nextInChannel : &m_nextInFile;
+    for(next = (*links)[next]; next != NO_SECTOR; next = (*links)[next])
+    {
+        const SectorInfo& sector = m_sectors[next];
+        if(matches(sector))
+            return next;
+        if(channelNumber && isInChannel(sector))
+            links = &m_nextInChannel;
+    }
+
+    return std::nullopt;
+}
+
+/** \brief Returns the next sector of any file that has the EOF submode bit set.
+ * \param lbn The sector to search from (excluded), which must be in the index.
+ * \return The Logical Block Number of the sector, or nullopt if there is none.
+ */
+std::optional<uint32_t> SectorIndex::NextEndOfFile(const uint32_t lbn) const noexcept
+{
+    const uint32_t next = m_nextEndOfFile[lbn];
+    if(next == NO_SECTOR)
+        return std::nullopt;
+    return next;
+}
+
+/** \brief Returns the hash that identifies a disc image in the saved index.
+ * \param image The opened disc image.
+ * \param imagePath The file of the disc image.
+ *
+ * The size, the last modification time of the file and the first sectors are hashed, so it only costs a few reads and
+ * the index is not built again each time the disc is opened. The sectors are not all read, so a modification that
+ * keeps the size and the modification time of the file is not detected.
+ */
+uint64_t SectorIndex::ComputeImageHash(DiscImage& image, const std::filesystem::path& imagePath)
+{
+    uint64_t hash = 0xCBF2'9CE4'8422'2325; // FNV-1a
+    const auto add = [&hash] (const uint64_t value, const size_t size) {
+        for(size_t i = 0; i < size; ++i)
+        {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 0x0000'0100'0000'01B3;
+        }
+    };
+
+    const uint64_t size = image.GetSize();
+    add(size, sizeof(uint64_t));
+
+    std::error_code error;
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time(imagePath, error);
+    add(error ? 0 : time.time_since_epoch().count(), sizeof(uint64_t));
+
+    std::vector<uint8_t> firstSectors(std::min<uint64_t>(size, HASHED_SECTORS * SECTOR_SIZE));
+    if(image.Read(0, firstSectors))
+        for(const uint8_t byte : firstSectors)
+            add(byte, 1);
+
+    return hash;
+}
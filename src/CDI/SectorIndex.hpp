@@ -0,0 +1,63 @@
+#ifndef CDI_SECTORINDEX_HPP
+#define CDI_SECTORINDEX_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+class DiscImage;
+
+/** \brief The subheader of a sector, as stored in \ref SectorIndex. */
+struct SectorInfo
+{
+    uint8_t fileNumber;
+    uint8_t channelNumber;
+    uint8_t submode;
+    uint8_t codingInformation;
+};
+
+/** \brief Index of the subheaders of every sector of a disc image.
+ *
+ * It is built in one pass over the image and can be saved next to it, so the next time the disc is opened the sectors
+ * of a file or of a channel are found without reading the disc.
+ *
+ * Each sector is linked to the next sector of the same file and to the next sector of the same file and channel, so
+ * following an interleaved stream is O(1) per sector. Each sector is also linked to the next EOF sector of any file.
+ */
+class SectorIndex
+{
+public:
+    static constexpr std::string_view MAGIC{"CDISIDX1"};
+    static constexpr uint32_t NO_SECTOR = UINT32_MAX; /**< End of the links. */
+
+    SectorIndex() = default;
+
+    void Build(DiscImage& image);
+    bool Load(const std::filesystem::path& path, uint64_t imageHash);
+    bool Save(const std::filesystem::path& path, uint64_t imageHash) const;
+    void Clear() noexcept;
+
+    /** \brief Returns true if the index has not been built or loaded. */
+    bool IsEmpty() const noexcept { return m_sectors.empty(); }
+    /** \brief Returns the number of sectors in the index. */
+    uint32_t GetSectorCount() const noexcept { return m_sectors.size(); }
+    /** \brief Returns the subheader of the given sector, which must be in the index. */
+    const SectorInfo& operator[](const uint32_t lbn) const noexcept { return m_sectors[lbn]; }
+
+    std::optional<uint32_t> NextSector(uint32_t lbn, std::optional<uint8_t> fileNumber, std::optional<uint8_t> channelNumber = std::nullopt, uint8_t submodeMask = 0) const noexcept;
+    std::optional<uint32_t> NextEndOfFile(uint32_t lbn) const noexcept;
+
+    static uint64_t ComputeImageHash(DiscImage& image, const std::filesystem::path& imagePath);
+
+private:
+    std::vector<SectorInfo> m_sectors{};
+    std::vector<uint32_t> m_nextInFile{}; /**< The next sector with the same file number. */
+    std::vector<uint32_t> m_nextInChannel{}; /**< The next sector with the same file and channel numbers. */
+    std::vector<uint32_t> m_nextEndOfFile{}; /**< The next sector of any file with the EOF submode bit. */
+
+    void BuildLinks();
+};
+
+#endif // CDI_SECTORINDEX_HPP
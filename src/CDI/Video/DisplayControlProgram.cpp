@@ -257,12 +257,18 @@ bool DisplayParameters::ExecuteDCPInstruction(const uint32_t instruction) noexce
 
     case LoadImageContributionFactorA: // Load image contribution factor for A.
         if constexpr(PLANE == A)
+        {
             m_icf[A] = bits<0, 5>(instruction);
+            m_icfLoadCount[A]++;
+        }
         return false;
 
     case LoadImageContributionFactorB: // Load image contribution factor for B.
         if constexpr(PLANE == B)
+        {
             m_icf[B] = bits<0, 5>(instruction);
+            m_icfLoadCount[B]++;
+        }
         return false;
 
     default:
@@ -104,7 +104,8 @@ public:
     uint8_t m_cursorBlinkOff : 3{}; /**< OFF period (if zero, blink is disabled). */
 
     // Image Contribution Factor.
-    std::array<uint8_t, 2> m_icf{};
+    std::array<uint8_t, 2> m_icf{}; /**< Loaded by the DCP, and modified by the matte commands while drawing a line. */
+    std::array<uint8_t, 2> m_icfLoadCount{}; /**< Incremented on each DCP load of \ref m_icf, see \ref RenderThread. */
 
     // Transparency.
     bool m_mix{true}; /**< true when mixing is enabled. */
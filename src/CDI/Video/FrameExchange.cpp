@@ -0,0 +1,44 @@
+/** \file FrameExchange.cpp
+ * \brief FrameExchange implementation file.
+ */
+
+#include "FrameExchange.hpp"
+
+#include <algorithm>
+
+namespace Video
+{
+
+/** \brief Publishes a completed frame, to be called by the producer thread.
+ * \param frame The frame to publish, which is left unchanged.
+ *
+ * The pixels are copied once in the producer buffer. The renderer keeps its own screen and draws the next frame
+ * over this one, so the lines it does not draw again (the other field in interlaced mode, or when the display is
+ * disabled) keep their last content.
+ */
+void FrameExchange::Publish(const Plane& frame) noexcept
+{
+    Plane& back = m_buffers[m_back];
+    if(back.size() < frame.size()) [[unlikely]] // The first frames get the empty initial buffers.
+        back.resize(frame.size(), 0);
+
+    back.m_width = frame.m_width;
+    back.m_height = frame.m_height;
+    std::copy_n(frame.data(), frame.PixelCount(), back.data());
+
+    m_back = m_middle.exchange(m_back | NEW_FRAME, std::memory_order_acq_rel) & INDEX_MASK;
+}
+
+/** \brief Returns the latest published frame, to be called by the consumer thread.
+ * \return The frame, which stays valid and unchanged until the next call. It is empty if no frame has been
+ * published yet.
+ */
+const Plane& FrameExchange::Acquire() noexcept
+{
+    if(HasNewFrame())
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+
+    return m_buffers[m_front];
+}
+
+} // namespace Video
@@ -0,0 +1,57 @@
+/** \file FrameExchange.hpp
+ * \brief Lock-free hand-off of the completed frames to another thread.
+ */
+
+#ifndef CDI_VIDEO_FRAMEEXCHANGE_HPP
+#define CDI_VIDEO_FRAMEEXCHANGE_HPP
+
+#include "VideoCommon.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Video
+{
+
+/** \brief Triple buffer that hands off the completed frames from the emulation thread to a consumer thread.
+ *
+ * The producer publishes the screen it has just rendered, and the consumer acquires the latest published frame.
+ * Neither of them ever waits on the other: when the consumer is slower than the producer, the intermediate frames
+ * are dropped.
+ *
+ * A published frame is copied once in the producer buffer, then the buffers are exchanged by index, so the acquired
+ * frame is never copied again. The renderer keeps its screen, like the persistent screen of the hardware.
+ *
+ * There must only be one producer thread and one consumer thread.
+ */
+class FrameExchange
+{
+public:
+    FrameExchange() {}
+
+    FrameExchange(const FrameExchange&) = delete;
+    FrameExchange& operator=(const FrameExchange&) = delete;
+    FrameExchange(FrameExchange&&) = delete;
+    FrameExchange& operator=(FrameExchange&&) = delete;
+
+    void Publish(const Plane& frame) noexcept;
+
+    const Plane& Acquire() noexcept;
+    /** \brief Returns true if a frame has been published since the last call to \ref Acquire. */
+    bool HasNewFrame() const noexcept { return m_middle.load(std::memory_order_relaxed) & NEW_FRAME; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0b011;
+    static constexpr uint8_t NEW_FRAME = 0b100;
+
+    /** \brief Only the middle buffer is shared, the two others are owned by the producer and the consumer. */
+    std::array<Plane, 3> m_buffers{Plane{0, 0, 0}, Plane{0, 0, 0}, Plane{0, 0, 0}};
+    uint8_t m_back{0}; /**< Index of the producer buffer. */
+    std::atomic<uint8_t> m_middle{1}; /**< Index of the latest published frame, with NEW_FRAME if not acquired yet. */
+    uint8_t m_front{2}; /**< Index of the consumer buffer. */
+};
+
+} // namespace Video
+
+#endif // CDI_VIDEO_FRAMEEXCHANGE_HPP
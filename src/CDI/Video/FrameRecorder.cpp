@@ -0,0 +1,318 @@
+/** \file FrameRecorder.cpp
+ * \brief FrameRecorder implementation file.
+ */
+
+#include "FrameRecorder.hpp"
+#include "PixelFormats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+
+namespace Video
+{
+
+/** \brief Writes the given value in little-endian. */
+template<typename T>
+static void writeLE(std::ostream& out, const T value)
+{
+    std::array<char, sizeof(T)> bytes;
+    for(size_t i = 0; i < sizeof(T); ++i)
+        bytes[i] = value >> (i * 8);
+    out.write(bytes.data(), bytes.size());
+}
+
+/** \brief Creates the output file and starts the writer thread.
+ * \param path The output file. The Raw format also creates the file with `.idx` appended.
+ * \param format The container format.
+ * \param frameRateNumerator The numerator of the frame rate, written in the header.
+ * \param frameRateDenominator The denominator of the frame rate, written in the header.
+ *
+ * If the files cannot be created, \ref IsGood returns false and the frames are discarded.
+ */
+FrameRecorder::FrameRecorder(const std::filesystem::path& path, const RecordingFormat format, const uint32_t frameRateNumerator, const uint32_t frameRateDenominator)
+    : m_format(format)
+    , m_frameRateNumerator(frameRateNumerator)
+    , m_frameRateDenominator(frameRateDenominator)
+    , m_out(path, std::ios::out | std::ios::binary)
+    , m_previous(std::make_unique<Plane>(0, 0))
+{
+    if(m_format == RecordingFormat::Raw)
+    {
+        std::filesystem::path indexPath{path};
+        m_index.open(indexPath += ".idx", std::ios::out);
+        m_index << "# frame offset width height\n";
+    }
+    else if(m_format == RecordingFormat::DeltaRLE)
+    {
+        m_out.write(DELTA_RLE_MAGIC.data(), DELTA_RLE_MAGIC.size());
+        writeLE<uint32_t>(m_out, m_frameRateNumerator);
+        writeLE<uint32_t>(m_out, m_frameRateDenominator);
+    }
+
+    m_good = m_out.good() && (m_format != RecordingFormat::Raw || m_index.good());
+
+    for(size_t i = 0; i < BUFFER_COUNT; ++i)
+        m_freeFrames.TryPush(std::make_unique<Plane>());
+
+    m_thread = std::thread(&FrameRecorder::Loop, this);
+}
+
+/** \brief Writes the pending frames and closes the files. */
+FrameRecorder::~FrameRecorder() noexcept
+{
+    Stop();
+}
+
+/** \brief Queues a frame to be written, to be called by the producer thread.
+ * \param frame The completed frame.
+ * \return false if the frame has been dropped.
+ *
+ * Never waits on the writer thread, the only work done on the calling thread is the copy of the pixels.
+ */
+bool FrameRecorder::PushFrame(const Plane& frame) noexcept
+{
+    if(m_stop.load(std::memory_order_relaxed) || frame.PixelCount() == 0)
+        return false;
+
+    std::optional<std::unique_ptr<Plane>> buffer = m_freeFrames.TryPop();
+    if(!buffer)
+    {
+        m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Plane& plane = **buffer;
+    plane.m_width = frame.m_width;
+    plane.m_height = frame.m_height;
+    std::copy_n(frame.data(), frame.PixelCount(), plane.data());
+
+    // There are only BUFFER_COUNT buffers, so the pending queue cannot be full.
+    m_pendingFrames.TryPush(std::move(*buffer));
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+    return true;
+}
+
+/** \brief Writes the pending frames, stops the writer thread and closes the files.
+ * The frames pushed after this call are discarded.
+ */
+void FrameRecorder::Stop() noexcept
+{
+    if(m_stop.exchange(true))
+        return;
+
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+    m_thread.join();
+
+    m_out.close();
+    if(m_index.is_open())
+        m_index.close();
+}
+
+void FrameRecorder::Loop() noexcept
+{
+    while(true)
+    {
+        const uint32_t signal = m_signal.load(std::memory_order_acquire);
+        std::optional<std::unique_ptr<Plane>> frame = m_pendingFrames.TryPop();
+        if(!frame)
+        {
+            if(m_stop.load(std::memory_order_acquire))
+                break;
+
+            m_signal.wait(signal, std::memory_order_acquire);
+            continue;
+        }
+
+        if(m_good.load(std::memory_order_relaxed))
+        {
+            switch(m_format)
+            {
+            case RecordingFormat::Y4M:      WriteY4M(**frame);     break;
+            case RecordingFormat::Raw:      WriteRaw(**frame);     break;
+            case RecordingFormat::DeltaRLE: WriteDeltaRLE(*frame); break;
+            }
+
+            if(m_out.good())
+                m_writtenFrames.fetch_add(1, std::memory_order_relaxed);
+            else
+                m_good.store(false, std::memory_order_relaxed);
+        }
+
+        m_freeFrames.TryPush(std::move(*frame));
+    }
+}
+
+void FrameRecorder::WriteY4M(const Plane& frame)
+{
+    Plane& canvas = *m_previous;
+    if(canvas.m_width == 0) // First frame, its resolution is the one of the whole stream.
+    {
+        canvas.m_width = frame.m_width;
+        canvas.m_height = frame.m_height;
+        m_out << "YUV4MPEG2 W" << canvas.m_width << " H" << canvas.m_height
+              << " F" << m_frameRateNumerator << ':' << m_frameRateDenominator
+              << " Ip A0:0 C420jpeg XCOLORRANGE=LIMITED\n";
+    }
+
+    const Plane* source = &frame;
+    if(frame.m_width != canvas.m_width || frame.m_height != canvas.m_height)
+    {
+        std::fill(canvas.begin(), canvas.end(), 0);
+        const size_t width = std::min(frame.m_width, canvas.m_width);
+        const size_t height = std::min(frame.m_height, canvas.m_height);
+        for(size_t y = 0; y < height; ++y)
+            std::copy_n(frame.GetLinePointer(y), width, canvas.GetLinePointer(y));
+        source = &canvas;
+    }
+
+    m_encoded.resize(getConvertedPlaneSize(PixelFormat::YUV420, canvas.m_width, canvas.m_height));
+    convertPlane(*source, PixelFormat::YUV420, m_encoded);
+    m_out << "FRAME\n";
+    m_out.write(reinterpret_cast<const char*>(m_encoded.data()), m_encoded.size());
+}
+
+void FrameRecorder::WriteRaw(const Plane& frame)
+{
+    const std::span<const Pixel> pixels = frame.GetSpan();
+    m_out.write(reinterpret_cast<const char*>(pixels.data()), pixels.size_bytes());
+    m_index << m_writtenFrames.load(std::memory_order_relaxed) << ' ' << m_offset << ' ' << frame.m_width << ' ' << frame.m_height << '\n';
+    m_offset += pixels.size_bytes();
+}
+
+/** \brief Writes the frame header (uint16_t width, uint16_t height, uint32_t data size), then the delta-RLE data.
+ * The frame is swapped with the previous one.
+ */
+void FrameRecorder::WriteDeltaRLE(std::unique_ptr<Plane>& frame)
+{
+    // A new resolution starts with a frame that does not depend on the previous one.
+    const bool sameSize = frame->m_width == m_previous->m_width && frame->m_height == m_previous->m_height;
+
+    m_encoded.clear();
+    encodeDeltaRLE(frame->GetSpan(), sameSize ? m_previous->GetSpan() : std::span<const Pixel>{}, m_encoded);
+
+    writeLE<uint16_t>(m_out, frame->m_width);
+    writeLE<uint16_t>(m_out, frame->m_height);
+    writeLE<uint32_t>(m_out, m_encoded.size());
+    m_out.write(reinterpret_cast<const char*>(m_encoded.data()), m_encoded.size());
+
+    std::swap(frame, m_previous);
+}
+
+// Delta-RLE tokens: a little-endian uint16_t with the type in the upper 2 bits and the pixel count minus 1 in the
+// lower 14 bits.
+static constexpr uint16_t DELTA_RLE_SKIP = 0 << 14; /**< The pixels are the same as in the previous frame. */
+static constexpr uint16_t DELTA_RLE_RUN = 1 << 14; /**< Followed by a single pixel repeated count times. */
+static constexpr uint16_t DELTA_RLE_LITERAL = 2 << 14; /**< Followed by count pixels. */
+static constexpr uint16_t DELTA_RLE_TYPE_MASK = 3 << 14;
+static constexpr size_t DELTA_RLE_MAX_COUNT = 1 << 14;
+static constexpr size_t DELTA_RLE_MIN_RUN = 3; /**< Shorter runs are stored as literals. */
+
+static void appendToken(std::vector<uint8_t>& out, const uint16_t type, const size_t count)
+{
+    const uint16_t token = type | (count - 1);
+    out.push_back(token);
+    out.push_back(token >> 8);
+}
+
+static void appendPixels(std::vector<uint8_t>& out, const Pixel* pixels, const size_t count)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(pixels);
+    out.insert(out.end(), bytes, bytes + count * sizeof(Pixel));
+}
+
+/** \brief Appends the delta-RLE encoding of a frame to a buffer.
+ * \param frame The pixels to encode.
+ * \param previous The pixels of the previous frame, or an empty span to encode the frame on its own.
+ * \param out The buffer to append the data to.
+ *
+ * The pixels are stored with their in-memory layout (B G R A). Sequences of pixels unchanged from the previous
+ * frame only take 2 bytes, which makes the mostly static CD-i screens very small.
+ */
+void encodeDeltaRLE(std::span<const Pixel> frame, std::span<const Pixel> previous, std::vector<uint8_t>& out)
+{
+    const size_t size = frame.size();
+    const auto isSame = [&] (const size_t i) { return i < previous.size() && frame[i] == previous[i]; };
+    const auto isRun = [&] (const size_t i) {
+        return i + DELTA_RLE_MIN_RUN <= size && std::all_of(frame.begin() + i + 1, frame.begin() + i + DELTA_RLE_MIN_RUN, [&] (const Pixel p) { return p == frame[i]; });
+    };
+
+    size_t i = 0;
+    while(i < size)
+    {
+        size_t count = 1;
+        if(isSame(i))
+        {
+            while(i + count < size && count < DELTA_RLE_MAX_COUNT && isSame(i + count))
+                count++;
+            appendToken(out, DELTA_RLE_SKIP, count);
+        }
+        else if(isRun(i))
+        {
+            while(i + count < size && count < DELTA_RLE_MAX_COUNT && frame[i + count] == frame[i])
+                count++;
+            appendToken(out, DELTA_RLE_RUN, count);
+            appendPixels(out, &frame[i], 1);
+        }
+        else
+        {
+            while(i + count < size && count < DELTA_RLE_MAX_COUNT && !isSame(i + count) && !isRun(i + count))
+                count++;
+            appendToken(out, DELTA_RLE_LITERAL, count);
+            appendPixels(out, &frame[i], count);
+        }
+
+        i += count;
+    }
+}
+
+/** \brief Decodes a delta-RLE frame.
+ * \param data The data created by \ref encodeDeltaRLE.
+ * \param frame Contains the previous frame, and receives the decoded frame.
+ * \return false if the data is invalid or does not match the frame size.
+ */
+bool decodeDeltaRLE(std::span<const uint8_t> data, std::span<Pixel> frame) noexcept
+{
+    size_t pos = 0;
+    size_t i = 0;
+    while(pos + 2 <= data.size())
+    {
+        const uint16_t token = data[pos] | data[pos + 1] << 8;
+        const uint16_t type = token & DELTA_RLE_TYPE_MASK;
+        const size_t count = (token & ~DELTA_RLE_TYPE_MASK) + 1;
+        pos += 2;
+
+        if(i + count > frame.size())
+            return false;
+
+        if(type == DELTA_RLE_RUN)
+        {
+            if(pos + sizeof(Pixel) > data.size())
+                return false;
+
+            Pixel pixel;
+            std::memcpy(&pixel, &data[pos], sizeof pixel);
+            std::fill_n(&frame[i], count, pixel);
+            pos += sizeof pixel;
+        }
+        else if(type == DELTA_RLE_LITERAL)
+        {
+            if(pos + count * sizeof(Pixel) > data.size())
+                return false;
+
+            std::memcpy(&frame[i], &data[pos], count * sizeof(Pixel));
+            pos += count * sizeof(Pixel);
+        }
+        else if(type != DELTA_RLE_SKIP)
+            return false;
+
+        i += count;
+    }
+
+    return pos == data.size() && i == frame.size();
+}
+
+} // namespace Video
@@ -0,0 +1,103 @@
+/** \file FrameRecorder.hpp
+ * \brief Lossless recording of the completed frames on a background thread.
+ */
+
+#ifndef CDI_VIDEO_FRAMERECORDER_HPP
+#define CDI_VIDEO_FRAMERECORDER_HPP
+
+#include "VideoCommon.hpp"
+#include "../common/SPSCQueue.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Video
+{
+
+/** \brief The container formats of \ref FrameRecorder. */
+enum class RecordingFormat
+{
+    /** YUV4MPEG2 stream of YUV420 frames, readable by most video tools. The resolution is the one of the first frame,
+     * later frames of a different resolution are cropped or padded with black. */
+    Y4M,
+    /** BGRA32 frames back to back, with a `.idx` sidecar text file that gives the offset and resolution of each
+     * frame. */
+    Raw,
+    /** Each frame is stored as the delta-RLE (see \ref encodeDeltaRLE) of the previous one. */
+    DeltaRLE,
+};
+
+/** \brief Records every completed frame to a file.
+ *
+ * The emulation thread (the producer) copies the frame into a free buffer and pushes it in a lock-free queue. The
+ * writer thread (the consumer) encodes and writes the frames, then gives the buffers back in another lock-free
+ * queue. The producer never waits: when no buffer is free because the writer is late, the frame is dropped and
+ * counted in \ref GetDroppedFrames.
+ *
+ * There must only be one producer thread.
+ */
+class FrameRecorder
+{
+public:
+    static constexpr size_t BUFFER_COUNT = 8; /**< Number of frames that can be pending. */
+
+    FrameRecorder(const std::filesystem::path& path, RecordingFormat format, uint32_t frameRateNumerator, uint32_t frameRateDenominator);
+    ~FrameRecorder() noexcept;
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+    FrameRecorder(FrameRecorder&&) = delete;
+    FrameRecorder& operator=(FrameRecorder&&) = delete;
+
+    bool PushFrame(const Plane& frame) noexcept;
+    void Stop() noexcept;
+
+    /** \brief Returns the number of frames written to the file. */
+    uint64_t GetWrittenFrames() const noexcept { return m_writtenFrames.load(std::memory_order_relaxed); }
+    /** \brief Returns the number of frames dropped because the writer thread was late. */
+    uint64_t GetDroppedFrames() const noexcept { return m_droppedFrames.load(std::memory_order_relaxed); }
+    /** \brief Returns false if the file could not be created or written to. */
+    bool IsGood() const noexcept { return m_good.load(std::memory_order_relaxed); }
+
+    static constexpr std::string_view DELTA_RLE_MAGIC{"CDIDRLE1"};
+
+private:
+    const RecordingFormat m_format;
+    const uint32_t m_frameRateNumerator;
+    const uint32_t m_frameRateDenominator;
+    std::ofstream m_out;
+    std::ofstream m_index; /**< Raw format sidecar file. */
+
+    SPSCQueue<std::unique_ptr<Plane>, BUFFER_COUNT> m_pendingFrames{}; /**< Emulation thread to writer thread. */
+    SPSCQueue<std::unique_ptr<Plane>, BUFFER_COUNT> m_freeFrames{}; /**< Writer thread to emulation thread. */
+    std::atomic<uint32_t> m_signal{0}; /**< Incremented to wake the writer thread up. */
+    std::atomic<uint64_t> m_writtenFrames{0};
+    std::atomic<uint64_t> m_droppedFrames{0};
+    std::atomic<bool> m_good{true};
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+
+    // Writer thread state.
+    std::unique_ptr<Plane> m_previous; /**< Previous frame for DeltaRLE, or the Y4M canvas. */
+    std::vector<uint8_t> m_encoded{};
+    uint64_t m_offset{0};
+
+    void Loop() noexcept;
+    void WriteY4M(const Plane& frame);
+    void WriteRaw(const Plane& frame);
+    void WriteDeltaRLE(std::unique_ptr<Plane>& frame);
+};
+
+void encodeDeltaRLE(std::span<const Pixel> frame, std::span<const Pixel> previous, std::vector<uint8_t>& out);
+bool decodeDeltaRLE(std::span<const uint8_t> data, std::span<Pixel> frame) noexcept;
+
+} // namespace Video
+
+#endif // CDI_VIDEO_FRAMERECORDER_HPP
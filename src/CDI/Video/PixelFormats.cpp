@@ -0,0 +1,296 @@
+/** \file PixelFormats.cpp
+ * \brief PixelFormats implementation file.
+ *
+ * The loops are branchless and work on whole 32-bit pixels so the compiler can vectorize them with the instruction
+ * set the library is built for.
+ */
+
+#include "PixelFormats.hpp"
+#include "../common/panic.hpp"
+
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace Video
+{
+
+/** \brief Returns the pixels as raw ARGB words, which unlike the Pixel struct copies can be vectorized. */
+static const uint32_t* asARGB32(std::span<const Pixel> pixels) noexcept
+{
+    return reinterpret_cast<const uint32_t*>(pixels.data());
+}
+
+/** \brief Convert ARGB pixels to RGB24.
+ * \param pixels The input pixels.
+ * \param dst Where the 3 * pixels.size() bytes will be written to.
+ */
+void convertToRGB24(std::span<const Pixel> pixels, uint8_t* dst) noexcept
+{
+    const uint32_t* src = asARGB32(pixels);
+    for(size_t i = 0; i < pixels.size(); ++i)
+    {
+        dst[i * 3] = src[i] >> 16;
+        dst[i * 3 + 1] = src[i] >> 8;
+        dst[i * 3 + 2] = src[i];
+    }
+}
+
+/** \brief Convert ARGB pixels to RGBA32.
+ * \param pixels The input pixels.
+ * \param dst Where the 4 * pixels.size() bytes will be written to.
+ */
+void convertToRGBA32(std::span<const Pixel> pixels, uint8_t* dst) noexcept
+{
+    const uint32_t* src = asARGB32(pixels);
+    for(size_t i = 0; i < pixels.size(); ++i)
+    {
+        const uint32_t argb = src[i];
+        const uint32_t abgr = (argb & 0xFF'00'FF'00) | (argb >> 16 & 0xFF) | (argb << 16 & 0xFF'00'00);
+        std::memcpy(dst + i * sizeof abgr, &abgr, sizeof abgr);
+    }
+}
+
+/** \brief Convert ARGB pixels to BGRA32, which is a plain copy of the pixels.
+ * \param pixels The input pixels.
+ * \param dst Where the 4 * pixels.size() bytes will be written to.
+ */
+void convertToBGRA32(std::span<const Pixel> pixels, uint8_t* dst) noexcept
+{
+    std::memcpy(dst, pixels.data(), pixels.size_bytes());
+}
+
+/** \brief Convert ARGB pixels to RGB565 (truncated). */
+static void convertToRGB565Bytes(std::span<const Pixel> pixels, uint8_t* dst) noexcept
+{
+    const uint32_t* src = asARGB32(pixels);
+    for(size_t i = 0; i < pixels.size(); ++i)
+    {
+        const uint32_t argb = src[i];
+        const uint16_t rgb = (argb >> 8 & 0xF800) | (argb >> 5 & 0x07E0) | (argb >> 3 & 0x001F);
+        std::memcpy(dst + i * sizeof rgb, &rgb, sizeof rgb);
+    }
+}
+
+/** \brief Convert ARGB pixels to RGB565 (truncated).
+ * \param pixels The input pixels.
+ * \param dst Where the pixels.size() pixels will be written to.
+ */
+void convertToRGB565(std::span<const Pixel> pixels, uint16_t* dst) noexcept
+{
+    convertToRGB565Bytes(pixels, reinterpret_cast<uint8_t*>(dst));
+}
+
+/** \brief Extracts the alpha channel of ARGB pixels.
+ * \param pixels The input pixels.
+ * \param dst Where the pixels.size() bytes will be written to.
+ */
+void convertToAlpha8(std::span<const Pixel> pixels, uint8_t* dst) noexcept
+{
+    const uint32_t* src = asARGB32(pixels);
+    for(size_t i = 0; i < pixels.size(); ++i)
+        dst[i] = src[i] >> 24;
+}
+
+/** \brief BT.601 limited range luma. */
+static void convertToLuma(std::span<const Pixel> pixels, uint8_t* dst) noexcept
+{
+    const uint32_t* src = asARGB32(pixels);
+    for(size_t i = 0; i < pixels.size(); ++i)
+    {
+        const uint32_t r = src[i] >> 16 & 0xFF;
+        const uint32_t g = src[i] >> 8 & 0xFF;
+        const uint32_t b = src[i] & 0xFF;
+        dst[i] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+    }
+}
+
+/** \brief BT.601 limited range chroma of the sums of 4 pixels. */
+static constexpr std::pair<uint8_t, uint8_t> chroma4(const int32_t r, const int32_t g, const int32_t b) noexcept
+{
+    return {
+        static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 512) >> 10) + 128),
+        static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 512) >> 10) + 128),
+    };
+}
+
+/** \brief BT.601 limited range chroma of each 2x2 block of two lines.
+ * \tparam INTERLEAVED true to write U and V to dstU only (NV12), false to write them to dstU and dstV (I420).
+ * \param line0 The upper line.
+ * \param line1 The lower line, may be the same as line0.
+ * \param width The number of pixels in each line, the last column is duplicated if odd.
+ */
+template<bool INTERLEAVED>
+static void convertToChroma(const Pixel* line0, const Pixel* line1, const size_t width, uint8_t* dstU, uint8_t* dstV) noexcept
+{
+    const uint32_t* src0 = asARGB32({line0, width});
+    const uint32_t* src1 = asARGB32({line1, width});
+
+    const auto write = [=] (const size_t i, const size_t x0, const size_t x1) {
+        // R and B, then A and G are summed in the 16-bit halves of the words.
+        const uint32_t rb = (src0[x0] & 0x00FF'00FF) + (src0[x1] & 0x00FF'00FF) + (src1[x0] & 0x00FF'00FF) + (src1[x1] & 0x00FF'00FF);
+        const uint32_t ag = (src0[x0] >> 8 & 0x00FF'00FF) + (src0[x1] >> 8 & 0x00FF'00FF) + (src1[x0] >> 8 & 0x00FF'00FF) + (src1[x1] >> 8 & 0x00FF'00FF);
+        const auto [u, v] = chroma4(rb >> 16, ag & 0xFFFF, rb & 0xFFFF);
+        if constexpr(INTERLEAVED)
+        {
+            dstU[2 * i] = u;
+            dstU[2 * i + 1] = v;
+        }
+        else
+        {
+            dstU[i] = u;
+            dstV[i] = v;
+        }
+    };
+
+    const size_t pairs = width / 2;
+    for(size_t i = 0; i < pairs; ++i)
+        write(i, 2 * i, 2 * i + 1);
+
+    if(width & 1)
+        write(pairs, width - 1, width - 1);
+}
+
+/** \brief Nearest neighbour horizontal up-scaling. */
+template<uint8_t SCALE>
+static void upscaleLine(const Pixel* src, Pixel* dst, const size_t width) noexcept
+{
+    const uint32_t* argb = asARGB32({src, width});
+    uint32_t* out = dst->AsU32Pointer();
+    for(size_t x = 0; x < width; ++x)
+        for(uint8_t i = 0; i < SCALE; ++i)
+            out[x * SCALE + i] = argb[x];
+}
+
+/** \brief Returns a pointer to the given line of the plane, up-scaled horizontally in buffer when needed. */
+static const Pixel* getScaledLine(const Plane& plane, const size_t line, const uint8_t scale, Pixel* buffer) noexcept
+{
+    const Pixel* src = plane.GetLinePointer(line);
+    switch(scale)
+    {
+    case 2: upscaleLine<2>(src, buffer, plane.m_width); return buffer;
+    case 3: upscaleLine<3>(src, buffer, plane.m_width); return buffer;
+    case 4: upscaleLine<4>(src, buffer, plane.m_width); return buffer;
+    default: return src;
+    }
+}
+
+/** \brief Returns the number of bytes per pixel of the packed formats, 0 for planar formats. */
+static constexpr size_t getBytesPerPixel(const PixelFormat format) noexcept
+{
+    switch(format)
+    {
+    case PixelFormat::RGB24:  return 3;
+    case PixelFormat::RGBA32: return 4;
+    case PixelFormat::BGRA32: return 4;
+    case PixelFormat::RGB565: return 2;
+    case PixelFormat::YUV420: return 0;
+    case PixelFormat::NV12:   return 0;
+    }
+
+    return 0;
+}
+
+/** \brief Returns the number of bytes written by \ref convertPlane.
+ * \param format The output pixel format.
+ * \param width The width of the input plane.
+ * \param height The height of the input plane.
+ * \param scale The up-scaling factor.
+ */
+size_t getConvertedPlaneSize(const PixelFormat format, const size_t width, const size_t height, const uint8_t scale) noexcept
+{
+    const size_t w = width * scale;
+    const size_t h = height * scale;
+
+    if(const size_t bpp = getBytesPerPixel(format); bpp != 0)
+        return w * h * bpp;
+
+    return w * h + 2 * ((w + 1) / 2) * ((h + 1) / 2);
+}
+
+/** \brief Converts the planar YUV formats, two output lines at a time. */
+template<bool INTERLEAVED>
+static void convertPlaneToYUV(const Plane& plane, uint8_t* dst, const uint8_t scale) noexcept
+{
+    std::array<Pixel, Plane::MAX_WIDTH * MAX_CONVERSION_SCALE> buffer0;
+    std::array<Pixel, Plane::MAX_WIDTH * MAX_CONVERSION_SCALE> buffer1;
+
+    const size_t width = plane.m_width * scale;
+    const size_t height = plane.m_height * scale;
+    const size_t chromaWidth = (width + 1) / 2;
+    const size_t chromaHeight = (height + 1) / 2;
+
+    uint8_t* dstY = dst;
+    uint8_t* dstU = dstY + width * height;
+    uint8_t* dstV = dstU + chromaWidth * chromaHeight; // Unused by NV12.
+
+    for(size_t y = 0; y < height; y += 2)
+    {
+        const Pixel* line0 = getScaledLine(plane, y / scale, scale, buffer0.data());
+        const Pixel* line1 = line0;
+        convertToLuma({line0, width}, dstY);
+        dstY += width;
+
+        if(y + 1 < height)
+        {
+            // Both output lines come from the same input line when the scale is even.
+            if((y + 1) / scale != y / scale)
+                line1 = getScaledLine(plane, (y + 1) / scale, scale, buffer1.data());
+            convertToLuma({line1, width}, dstY);
+            dstY += width;
+        }
+
+        convertToChroma<INTERLEAVED>(line0, line1, width, dstU, dstV);
+        dstU += INTERLEAVED ? chromaWidth * 2 : chromaWidth;
+        dstV += chromaWidth;
+    }
+}
+
+/** \brief Converts an ARGB plane to the given pixel format.
+ * \param plane The input plane.
+ * \param format The output pixel format.
+ * \param dst The destination buffer, must be at least \ref getConvertedPlaneSize bytes.
+ * \param scale The nearest neighbour up-scaling factor, from 1 to \ref MAX_CONVERSION_SCALE.
+ *
+ * The lines of the output are contiguous, without padding.
+ */
+void convertPlane(const Plane& plane, const PixelFormat format, std::span<uint8_t> dst, const uint8_t scale)
+{
+    if(scale < 1 || scale > MAX_CONVERSION_SCALE)
+        panic("Invalid conversion scale {}", scale);
+
+    if(dst.size() < getConvertedPlaneSize(format, plane.m_width, plane.m_height, scale))
+        panic("Conversion buffer too small ({} bytes)", dst.size());
+
+    if(format == PixelFormat::YUV420)
+        return convertPlaneToYUV<false>(plane, dst.data(), scale);
+    if(format == PixelFormat::NV12)
+        return convertPlaneToYUV<true>(plane, dst.data(), scale);
+
+    void (*const convert)(std::span<const Pixel>, uint8_t*) noexcept = [format] {
+        switch(format)
+        {
+        case PixelFormat::RGB24:  return convertToRGB24;
+        case PixelFormat::RGBA32: return convertToRGBA32;
+        case PixelFormat::RGB565: return convertToRGB565Bytes;
+        default:                  return convertToBGRA32;
+        }
+    }();
+
+    std::array<Pixel, Plane::MAX_WIDTH * MAX_CONVERSION_SCALE> buffer;
+    const size_t width = plane.m_width * scale;
+    const size_t lineSize = width * getBytesPerPixel(format);
+
+    uint8_t* line = dst.data();
+    for(size_t y = 0; y < plane.m_height; ++y)
+    {
+        convert({getScaledLine(plane, y, scale, buffer.data()), width}, line);
+
+        // The other lines are copies of the first one.
+        for(uint8_t i = 1; i < scale; ++i)
+            std::memcpy(line + lineSize * i, line, lineSize);
+        line += lineSize * scale;
+    }
+}
+
+} // namespace Video
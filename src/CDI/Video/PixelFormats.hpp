@@ -0,0 +1,43 @@
+/** \file PixelFormats.hpp
+ * \brief Conversion of the ARGB planes to the pixel formats used by the frame consumers.
+ */
+
+#ifndef CDI_VIDEO_PIXELFORMATS_HPP
+#define CDI_VIDEO_PIXELFORMATS_HPP
+
+#include "VideoCommon.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Video
+{
+
+/** \brief The output pixel formats. The byte order is the order in memory. */
+enum class PixelFormat
+{
+    RGB24, /**< 3 bytes per pixel, R G B. */
+    RGBA32, /**< 4 bytes per pixel, R G B A. */
+    BGRA32, /**< 4 bytes per pixel, B G R A, same as \ref Pixel. */
+    RGB565, /**< Native endian uint16_t per pixel. */
+    YUV420, /**< Planar BT.601 limited range: Y plane, then U and V planes subsampled 2x2 (I420). */
+    NV12, /**< Planar BT.601 limited range: Y plane, then an interleaved UV plane subsampled 2x2. */
+};
+
+/** \brief The maximum up-scaling factor of \ref convertPlane. */
+static constexpr uint8_t MAX_CONVERSION_SCALE = 4;
+
+size_t getConvertedPlaneSize(PixelFormat format, size_t width, size_t height, uint8_t scale = 1) noexcept;
+void convertPlane(const Plane& plane, PixelFormat format, std::span<uint8_t> dst, uint8_t scale = 1);
+
+// Line converters, dst must have room for pixels.size() output pixels.
+void convertToRGB24(std::span<const Pixel> pixels, uint8_t* dst) noexcept;
+void convertToRGBA32(std::span<const Pixel> pixels, uint8_t* dst) noexcept;
+void convertToBGRA32(std::span<const Pixel> pixels, uint8_t* dst) noexcept;
+void convertToRGB565(std::span<const Pixel> pixels, uint16_t* dst) noexcept;
+void convertToAlpha8(std::span<const Pixel> pixels, uint8_t* dst) noexcept;
+
+} // namespace Video
+
+#endif // CDI_VIDEO_PIXELFORMATS_HPP
@@ -0,0 +1,153 @@
+/** \file RenderThread.cpp
+ * \brief RenderThread implementation file.
+ */
+
+#include "RenderThread.hpp"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+
+namespace Video
+{
+
+/** \brief Creates the render thread and starts the worker.
+ * \param renderer The renderer used to draw the lines.
+ * \param onFrameCompleted Called on the worker thread with the final screen when a frame is completed.
+ */
+RenderThread::RenderThread(std::unique_ptr<Renderer> renderer, FrameCallback onFrameCompleted)
+    : m_renderer(std::move(renderer))
+    , m_onFrameCompleted(std::move(onFrameCompleted))
+    , m_commands(QUEUE_SIZE)
+    , m_thread(&RenderThread::Loop, this)
+{
+}
+
+/** \brief Stops the worker thread.
+ *
+ * Pending commands are discarded without being drawn, so the frame callback is never called during the destruction.
+ * Call \ref Flush before to draw them.
+ */
+RenderThread::~RenderThread() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_notEmpty.notify_one();
+    m_thread.join();
+}
+
+/** \brief Queues a line to be drawn.
+ * \param parameters The display parameters to use for this line.
+ * \param lineA Line A data.
+ * \param sizeA The number of bytes of line A (as returned by \ref Renderer::GetLineSize).
+ * \param lineB Line B data.
+ * \param sizeB The number of bytes of line B (as returned by \ref Renderer::GetLineSize).
+ * \param lineNumber The line number to draw (starting at 0).
+ *
+ * Blocks if the queue is full.
+ */
+void RenderThread::PushLine(const Renderer& parameters, const uint8_t* lineA, const uint16_t sizeA, const uint8_t* lineB, const uint16_t sizeB, const uint16_t lineNumber)
+{
+    Command& command = AcquireCommand();
+    command.type = CommandType::Line;
+    command.parameters = parameters;
+    command.lineNumber = lineNumber;
+    command.sizeA = std::min<size_t>(sizeA, MAX_LINE_SIZE);
+    const size_t sizeBClamped = std::min<size_t>(sizeB, MAX_LINE_SIZE);
+
+    command.lines.assign(command.sizeA + sizeBClamped + 2 * LINE_PADDING, 0);
+    std::copy_n(lineA, command.sizeA, command.lines.begin());
+    std::copy_n(lineB, sizeBClamped, command.lines.begin() + command.sizeA + LINE_PADDING);
+    SubmitCommand();
+}
+
+/** \brief Queues the end of the current frame.
+ * \param parameters The display parameters to use for the cursor.
+ *
+ * Blocks if the queue is full.
+ */
+void RenderThread::PushFrame(const Renderer& parameters)
+{
+    Command& command = AcquireCommand();
+    command.type = CommandType::Frame;
+    command.parameters = parameters;
+    command.cursorIsOn = parameters.m_cursorIsOn;
+    SubmitCommand();
+}
+
+/** \brief Waits until every queued command has been processed. */
+void RenderThread::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [this] { return m_count == 0 || m_stop; });
+}
+
+/** \brief Returns the next free command slot, waiting for one to be available if the queue is full.
+ *
+ * Only the producer writes to the slot after m_count, so it can be filled without holding the lock.
+ */
+RenderThread::Command& RenderThread::AcquireCommand()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [this] { return m_count < m_commands.size(); });
+    return m_commands[(m_head + m_count) % m_commands.size()];
+}
+
+/** \brief Makes the command returned by \ref AcquireCommand visible to the worker thread. */
+void RenderThread::SubmitCommand()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_count++;
+    }
+    m_notEmpty.notify_one();
+}
+
+void RenderThread::Loop()
+{
+    std::optional<std::array<uint8_t, 2>> producerICF{}; // ICF of the previous command.
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true)
+    {
+        m_notEmpty.wait(lock, [this] { return m_count > 0 || m_stop; });
+        if(m_stop)
+            break;
+
+        Command& command = m_commands[m_head];
+        lock.unlock();
+
+        // The ICF is also modified by the matte commands, which are only executed here. Like in the synchronous
+        // mode, the one of the producer only replaces it when it has been loaded since the previous command.
+        const std::array<uint8_t, 2> icf = m_renderer->m_icf;
+        const std::array<uint8_t, 2> icfLoadCount = m_renderer->m_icfLoadCount;
+        static_cast<DisplayParameters&>(*m_renderer) = command.parameters;
+        if(producerICF)
+            for(size_t plane = 0; plane < icf.size(); plane++)
+                if(command.parameters.m_icf[plane] == (*producerICF)[plane] && command.parameters.m_icfLoadCount[plane] == icfLoadCount[plane])
+                    m_renderer->m_icf[plane] = icf[plane];
+        producerICF = command.parameters.m_icf;
+
+        if(command.type == CommandType::Line)
+        {
+            const uint8_t* lineA = command.lines.data();
+            m_renderer->DrawLine(lineA, lineA + command.sizeA + LINE_PADDING, command.lineNumber);
+        }
+        else
+        {
+            m_renderer->m_cursorIsOn = command.cursorIsOn;
+            m_renderer->RenderFrame();
+            if(m_onFrameCompleted)
+                m_onFrameCompleted(m_renderer->m_screen);
+        }
+
+        lock.lock();
+        m_head = (m_head + 1) % m_commands.size();
+        m_count--;
+        m_notFull.notify_all();
+    }
+}
+
+} // namespace Video
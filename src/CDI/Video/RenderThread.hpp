@@ -0,0 +1,101 @@
+/** \file RenderThread.hpp
+ * \brief Asynchronous video renderer running on its own thread.
+ */
+
+#ifndef CDI_VIDEO_RENDERTHREAD_HPP
+#define CDI_VIDEO_RENDERTHREAD_HPP
+
+#include "Renderer.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Video
+{
+
+/** \brief Decodes and mixes the video lines on a worker thread.
+ *
+ * The emulation thread (the producer) only computes the number of bytes each line reads from memory, which is
+ * what the MCD212 needs to advance its VSR registers, and pushes a snapshot of the display parameters and of the
+ * line data in a bounded queue. The worker thread (the consumer) draws the lines with its own renderer and calls
+ * the frame callback with the final screen once a frame is completed.
+ *
+ * There must only be one producer thread.
+ */
+class RenderThread
+{
+public:
+    /** \brief Maximum number of bytes a single line can read from memory (RL7 high resolution with 1-pixel runs). */
+    static constexpr size_t MAX_LINE_SIZE = 2 * Plane::MAX_WIDTH;
+    /** \brief Zeroed bytes after each line, so the decoders can read whole vectors past its end. */
+    static constexpr size_t LINE_PADDING = 64;
+    /** \brief Number of commands that can be pending: the lines of a field and its frame command.
+     * The emulation thread is never more than a frame ahead of the worker.
+     */
+    static constexpr size_t QUEUE_SIZE = Plane::MAX_HEIGHT / 2 + 1;
+
+    /** \brief Called with the final screen, which can be given to \ref FrameExchange::Publish. */
+    using FrameCallback = std::function<void(const Plane&)>;
+
+    RenderThread(std::unique_ptr<Renderer> renderer, FrameCallback onFrameCompleted);
+    ~RenderThread() noexcept;
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+    RenderThread(RenderThread&&) = delete;
+    RenderThread& operator=(RenderThread&&) = delete;
+
+    void PushLine(const Renderer& parameters, const uint8_t* lineA, uint16_t sizeA, const uint8_t* lineB, uint16_t sizeB, uint16_t lineNumber);
+    void PushFrame(const Renderer& parameters);
+    void Flush();
+
+    /** \brief Returns the renderer used by the worker thread.
+     * Its planes are only guaranteed to be consistent after a call to \ref Flush.
+     */
+    const Renderer& GetRenderer() const noexcept { return *m_renderer; }
+    /** \brief Selects whether the renderer of the worker thread keeps the whole planes, see \ref Renderer::SetPlanesRetained. */
+    void SetPlanesRetained(const bool retained) noexcept { m_renderer->SetPlanesRetained(retained); }
+
+private:
+    enum class CommandType
+    {
+        Line,
+        Frame,
+    };
+
+    struct Command
+    {
+        CommandType type{CommandType::Line};
+        DisplayParameters parameters{};
+        uint16_t lineNumber{};
+        bool cursorIsOn{};
+        uint16_t sizeA{}; /**< Line B starts after line A and its padding. */
+        std::vector<uint8_t> lines{}; /**< Only the bytes actually read by the lines, so it stays small. */
+    };
+
+    std::unique_ptr<Renderer> m_renderer;
+    FrameCallback m_onFrameCompleted;
+
+    std::vector<Command> m_commands;
+    size_t m_head{0}; /**< Index of the next command to be processed. */
+    size_t m_count{0}; /**< Number of pending commands. */
+    bool m_stop{false};
+
+    std::mutex m_mutex{};
+    std::condition_variable m_notEmpty{};
+    std::condition_variable m_notFull{};
+    std::thread m_thread;
+
+    Command& AcquireCommand();
+    void SubmitCommand();
+    void Loop();
+};
+
+} // namespace Video
+
+#endif // CDI_VIDEO_RENDERTHREAD_HPP
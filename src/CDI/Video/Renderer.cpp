@@ -3,6 +3,8 @@
 
 #include "../common/panic.hpp"
 
+#include <algorithm>
+
 namespace Video
 {
 
@@ -36,8 +38,14 @@ std::pair<uint16_t, uint16_t> Renderer::DrawLine(const uint8_t* lineA, const uin
         const uint16_t width = getDisplayWidth(m_displayFormat);
         const uint16_t height = GetDisplayHeight();
 
-        m_screen.m_width = m_plane[A].m_width = m_plane[B].m_width = width * 2;
-        m_screen.m_height = m_plane[A].m_height = m_plane[B].m_height = m_backdropPlane.m_height = height;
+        ApplyPlanesRetention();
+        m_screen.m_width = width * 2;
+        m_screen.m_height = m_backdropPlane.m_height = height;
+        for(Plane& plane : m_plane)
+        {
+            plane.m_width = m_planesRetained ? m_screen.m_width : 0;
+            plane.m_height = m_planesRetained ? m_screen.m_height : 0;
+        }
     }
 
     ResetMatte();
@@ -47,23 +55,284 @@ std::pair<uint16_t, uint16_t> Renderer::DrawLine(const uint8_t* lineA, const uin
     return DrawLineImpl(lineA, lineB);
 }
 
+/** \brief Selects whether the whole planes A and B are kept in \ref m_plane or only the line being drawn.
+ * \param retained true to keep the whole planes, false to only keep the line buffers.
+ *
+ * The full planes are only needed to inspect them (e.g. in a debugger), the screen is the same in both modes.
+ * Retaining them costs two 768x560 ARGB buffers, so they are disabled by default.
+ *
+ * Can be called from any thread, it is applied at the beginning of the next frame.
+ */
+void Renderer::SetPlanesRetained(const bool retained) noexcept
+{
+    m_retainPlanesRequest.store(retained, std::memory_order_relaxed);
+}
+
+/** \brief Allocates or frees the full planes if the retention mode changed. */
+void Renderer::ApplyPlanesRetention() noexcept
+{
+    const bool retained = m_retainPlanesRequest.load(std::memory_order_relaxed);
+    if(retained == m_planesRetained)
+        return;
+
+    m_planesRetained = retained;
+    for(Plane& plane : m_plane)
+    {
+        if(retained)
+            plane.resize(Plane::MAX_SIZE, 0);
+        else
+        {
+            plane.clear();
+            plane.shrink_to_fit();
+        }
+    }
+}
+
+/** \brief Returns the number of bytes the next line will read from memory, without drawing it.
+ * \param lineA Line A data.
+ * \param lineB Line B data.
+ * \return The number of bytes read from memory for each plane `<plane A, plane B>`, same as \ref DrawLine.
+ *
+ * This only depends on the display parameters, so it can be called before the line is actually drawn.
+ */
+std::pair<uint16_t, uint16_t> Renderer::GetLineSize(const uint8_t* lineA, const uint8_t* lineB) const noexcept
+{
+    uint16_t bytesA = GetLinePlaneSize<A>(lineA);
+    const uint16_t bytesB = GetLinePlaneSize<B>(lineB);
+    if(m_codingMethod[B] == ImageCodingMethod::RGB555)
+        bytesA = bytesB;
+
+    return std::make_pair(bytesA, bytesB);
+}
+
+/** \brief Returns the number of bytes read from memory by the given plane on the next line.
+ * \param lineMain Line that would be decoded.
+ */
+template<ImagePlane PLANE>
+uint16_t Renderer::GetLinePlaneSize(const uint8_t* lineMain) const noexcept
+{
+    const ImageCodingMethod icm = m_codingMethod[PLANE];
+    if(icm == ImageCodingMethod::OFF)
+        return 0;
+
+    // Don't use Is360Pixels() because the screen size is only updated when drawing the first line.
+    const bool is360Pixels = getDisplayWidth(m_displayFormat) == 360;
+
+    switch(m_imageType[PLANE])
+    {
+    case ImageType::Normal:
+        if(icm == ImageCodingMethod::CLUT4)
+            return is360Pixels ? getBitmapLineSize<720>(icm) : getBitmapLineSize<768>(icm);
+        else
+            return is360Pixels ? getBitmapLineSize<360>(icm) : getBitmapLineSize<384>(icm);
+
+    case ImageType::RunLength:
+        if(m_bps[PLANE] == BitsPerPixel::Double4) // RL3
+            return is360Pixels ? getRunLengthLineSize<720, true>(lineMain) : getRunLengthLineSize<768, true>(lineMain);
+        else if(m_bps[PLANE] == BitsPerPixel::High8) // RL7 high
+            return is360Pixels ? getRunLengthLineSize<720, false>(lineMain) : getRunLengthLineSize<768, false>(lineMain);
+        else
+            return is360Pixels ? getRunLengthLineSize<360, false>(lineMain) : getRunLengthLineSize<384, false>(lineMain);
+
+    case ImageType::Mosaic:
+        panic("Unsupported type Mosaic");
+        return 0;
+    }
+
+    std::unreachable();
+}
+
 /** \brief To be called when the whole frame is drawn.
  * \return The final screen.
  *
- * This function renders the cursor and pastes it on the screen.
+ * This function renders the cursor and overlays it on the screen.
+ * The cursor plane is only redrawn when its pattern, color, blink phase or resolution changed.
  */
 const Plane& Renderer::RenderFrame() noexcept
 {
     // Should this be inside DrawLine() ?
     if(m_cursorEnabled)
     {
-        DrawCursor();
-        paste(m_screen.data(), m_screen.m_width, m_screen.m_height,
-              m_cursorPlane.data(), m_cursorPlane.m_width, m_cursorPlane.m_height,
-              m_cursorX, m_cursorY);
+        const CursorState state{m_cursorPatterns, GetCursorColor(), m_cursorDoubleResolution};
+        if(m_cursorState != state)
+        {
+            DrawCursor();
+            m_cursorState = state;
+        }
+
+        // In the OFF period of an ON/OFF blink, the cursor color is transparent and nothing would be drawn.
+        if(state.color.a != 0)
+            OverlayCursor();
     }
 
     return m_screen;
 }
 
+/** \brief Draws the visible pixels of the cursor plane on the screen at the cursor position.
+ *
+ * The parts of the cursor outside of the screen are clipped.
+ */
+void Renderer::OverlayCursor() noexcept
+{
+    if(m_cursorX >= m_screen.m_width || m_cursorY >= m_screen.m_height)
+        return;
+
+    const size_t width = std::min(m_cursorPlane.m_width, m_screen.m_width - m_cursorX);
+    const size_t height = std::min(m_cursorPlane.m_height, m_screen.m_height - m_cursorY);
+    for(size_t y = 0; y < height; ++y)
+    {
+        const Pixel* src = m_cursorPlane.GetLinePointer(y);
+        Pixel* dst = m_screen.GetLinePointer(m_cursorY + y) + m_cursorX;
+        for(size_t x = 0; x < width; ++x)
+            dst[x] = src[x].a != 0 ? src[x] : dst[x]; // Alpha is either 0 or 255.
+    }
+}
+
+/** \brief Executes the matte commands of the current line and splits it in spans of identical matte state.
+ *
+ * Matte commands only change the state at up to \ref MATTE_NUM positions per line, so the renderers apply the
+ * matte flags and ICF span by span instead of pixel by pixel.
+ */
+void Renderer::ComputeMatteSpans() noexcept
+{
+    if(m_matteNumber)
+        ComputeMatteSpansImpl<true>();
+    else
+        ComputeMatteSpansImpl<false>();
+}
+
+template<bool TWO_MATTES>
+void Renderer::ComputeMatteSpansImpl() noexcept
+{
+    const size_t width = m_screen.m_width;
+    m_matteSpansCount = 0;
+
+    size_t nextMatte0 = 0; // Used when 1 or 2 mattes.
+    size_t nextMatte1 = MATTE_HALF; // Used when 2 mattes.
+    size_t nextChange0 = matteXPosition(m_matteControl[nextMatte0]);
+    size_t nextChange1 = matteXPosition(m_matteControl[nextMatte1]);
+
+    for(size_t x = 0; x < width;)
+    {
+        size_t nextChange = width;
+
+        if constexpr(TWO_MATTES)
+        {
+            if(nextChange0 == x)
+            {
+                const uint32_t command0 = m_matteControl[nextMatte0];
+                const bool disregard = ExecuteMatteCommand<TWO_MATTES>(command0, false); // false for matte 0.
+
+                ++nextMatte0;
+                if(disregard || nextMatte0 >= MATTE_HALF)
+                    nextChange0 = width;
+                else
+                    nextChange0 = matteXPosition(m_matteControl[nextMatte0]);
+            }
+
+            if(nextChange1 == x)
+            {
+                const uint32_t command1 = m_matteControl[nextMatte1];
+                const bool disregard = ExecuteMatteCommand<TWO_MATTES>(command1, true); // true for matte 1.
+
+                ++nextMatte1;
+                if(disregard || nextMatte1 >= MATTE_NUM)
+                    nextChange1 = width;
+                else
+                    nextChange1 = matteXPosition(m_matteControl[nextMatte1]);
+            }
+
+            // Sometimes the next register has a lower position.
+            if(nextChange0 <= x)
+                nextChange0 = width;
+            if(nextChange1 <= x)
+                nextChange1 = width;
+            nextChange = std::min(nextChange0, nextChange1);
+        }
+        else
+        {
+            if(nextChange0 == x)
+            {
+                const uint32_t command = m_matteControl[nextMatte0];
+                const bool disregard = ExecuteMatteCommand<TWO_MATTES>(command, false); // false is unused with one matte.
+
+                ++nextMatte0;
+                if(disregard || nextMatte0 >= m_matteControl.size())
+                    nextChange0 = width;
+                else
+                {
+                    nextChange0 = matteXPosition(m_matteControl[nextMatte0]);
+                    if(nextChange0 <= x) // Sometimes the next register has a lower position.
+                        nextChange0 = width;
+                }
+            }
+            nextChange = nextChange0;
+        }
+
+        nextChange = std::min(nextChange, width); // The positions can be beyond the end of the line.
+        m_matteSpans[m_matteSpansCount++] = MatteSpan{
+            static_cast<uint16_t>(x), static_cast<uint16_t>(nextChange), m_icf, m_matteFlags,
+        };
+        x = nextChange;
+    }
+}
+
+/** \brief Executes the given matte command.
+ * \tparam TWO_MATTES true for two mattes, false for one matte.
+ * \param command The command to execute.
+ * \param mf The matte flag to modifiy (used only when TWO_MATTES is true).
+ * \return true if upper registers are to be ignored (command 0).
+ */
+template<bool TWO_MATTES>
+bool Renderer::ExecuteMatteCommand(const uint32_t command, bool mf) noexcept
+{
+    if constexpr(!TWO_MATTES)
+        mf = matteMF(command);
+
+    const uint8_t op = matteOp(command);
+    switch(op)
+    {
+    case 0b0000:
+        return true;
+
+    case 0b0100:
+        m_icf[A] = matteICF(command);
+        break;
+
+    case 0b0110:
+        m_icf[B] = matteICF(command);
+        break;
+
+    case 0b1000:
+        m_matteFlags[mf] = false;
+        break;
+
+    case 0b1001:
+        m_matteFlags[mf] = true;
+        break;
+
+    case 0b1100:
+        m_icf[A] = matteICF(command);
+        m_matteFlags[mf] = false;
+        break;
+
+    case 0b1101:
+        m_icf[A] = matteICF(command);
+        m_matteFlags[mf] = true;
+        break;
+
+    case 0b1110:
+        m_icf[B] = matteICF(command);
+        m_matteFlags[mf] = false;
+        break;
+
+    case 0b1111:
+        m_icf[B] = matteICF(command);
+        m_matteFlags[mf] = true;
+        break;
+    }
+
+    return false;
+}
+
 } // namespace Video
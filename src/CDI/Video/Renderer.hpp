@@ -11,7 +11,10 @@
 #include "VideoCommon.hpp"
 
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <optional>
+#include <span>
 #include <utility>
 
 namespace Video
@@ -60,6 +63,15 @@ public:
 
     static constexpr Pixel BLACK_PIXEL{0x00'10'10'10};
 
+    /** \brief A run of pixels that share the same matte flags and ICF, computed by \ref ComputeMatteSpans. */
+    struct MatteSpan
+    {
+        uint16_t begin; /**< First pixel of the span (in double resolution). */
+        uint16_t end; /**< One past the last pixel of the span. */
+        std::array<uint8_t, 2> icf; /**< ICF of each plane. */
+        std::array<bool, 2> matteFlags; /**< Matte flags 0 and 1. */
+    };
+
     static constexpr double DELTA_50FPS = 240'000'000.; /**< GB VII.2.3.4.2 GC_Blnk. */
     static constexpr double DELTA_60FPS = 200'000'000.; /**< GB VII.2.3.4.2 GC_Blnk. */
 
@@ -73,20 +85,45 @@ public:
 
     void IncrementCursorTime(double ns) noexcept;
     std::pair<uint16_t, uint16_t> DrawLine(const uint8_t* lineA, const uint8_t* lineB, uint16_t lineNumber) noexcept;
+    std::pair<uint16_t, uint16_t> GetLineSize(const uint8_t* lineA, const uint8_t* lineB) const noexcept;
     const Plane& RenderFrame() noexcept;
+    void SetPlanesRetained(bool retained) noexcept;
 
     Plane m_screen{};
-    std::array<Plane, 2> m_plane{Plane{}, Plane{}};
+    std::array<Plane, 2> m_plane{Plane{0, 0, 0}, Plane{0, 0, 0}}; /**< Empty unless retained, see \ref SetPlanesRetained. */
     Plane m_backdropPlane{1, Plane::MAX_HEIGHT, Plane::MAX_HEIGHT};
     Plane m_cursorPlane{Plane::CURSOR_WIDTH, Plane::CURSOR_HEIGHT, Plane::CURSOR_SIZE}; /**< The alpha is 0, 127 or 255. */
 
 protected:
+    friend class RenderThread;
+
     // Matte (Region of the MCD212).
     std::array<bool, 2> m_matteFlags{}; // Common to all renderers and reset in this class.
     constexpr void ResetMatte() noexcept { m_matteFlags.fill(false); }
 
+    /** \brief Each matte command can start a new span, plus the one at the beginning of the line. */
+    static constexpr size_t MAX_MATTE_SPANS = MATTE_NUM + 1;
+    std::array<MatteSpan, MAX_MATTE_SPANS> m_matteSpans{};
+    size_t m_matteSpansCount{};
+    void ComputeMatteSpans() noexcept;
+    template<bool TWO_MATTES> void ComputeMatteSpansImpl() noexcept;
+    template<bool TWO_MATTES> bool ExecuteMatteCommand(uint32_t command, bool mf) noexcept;
+    /** \brief Returns the spans computed by the last call to \ref ComputeMatteSpans. */
+    std::span<const MatteSpan> GetMatteSpans() const noexcept { return {m_matteSpans.data(), m_matteSpansCount}; }
+
     uint16_t m_lineNumber{}; /**< Current line being drawn, starts at 0. Handled by the caller. */
 
+    /** \brief The pixels of the line being drawn of each plane, when the full planes are not retained. */
+    std::array<std::array<Pixel, Plane::MAX_WIDTH>, 2> m_planeLine{};
+    std::atomic<bool> m_retainPlanesRequest{false}; /**< Applied by \ref DrawLine at the beginning of the next frame. */
+    bool m_planesRetained{false};
+    void ApplyPlanesRetention() noexcept;
+    /** \brief Returns where the current line of the given plane is decoded. */
+    Pixel* GetPlaneLine(const ImagePlane plane) noexcept
+    {
+        return m_planesRetained ? m_plane[plane].GetLinePointer(m_lineNumber) : m_planeLine[plane].data();
+    }
+
     virtual std::pair<uint16_t, uint16_t> DrawLineImpl(const uint8_t* lineA, const uint8_t* lineB) noexcept = 0;
     virtual void DrawCursor() noexcept = 0;
     void DrawLineBackdrop() noexcept
@@ -100,10 +137,26 @@ protected:
         return m_screen.m_width == 720;
     }
 
+    template<ImagePlane PLANE>
+    uint16_t GetLinePlaneSize(const uint8_t* lineMain) const noexcept;
+
     static constexpr Pixel backdropCursorColorToPixel(uint8_t color) noexcept;
 
     double m_cursorTime{0.0}; /**< Keeps track of the emulated time for cursor blink. */
     bool m_cursorIsOn{true}; /**< Keeps the state of the cursor (ON or OFF/complement). true when ON. */
+
+    /** \brief The cursor parameters \ref m_cursorPlane has been drawn with. */
+    struct CursorState
+    {
+        std::array<uint16_t, 16> patterns;
+        Pixel color; /**< Includes the blink phase, see \ref GetCursorColor. */
+        bool doubleResolution;
+
+        constexpr bool operator==(const CursorState&) const = default;
+    };
+    std::optional<CursorState> m_cursorState{}; /**< Empty when the cursor plane has never been drawn. */
+    void OverlayCursor() noexcept;
+
     constexpr Pixel GetCursorColor() const noexcept
     {
         Pixel color = backdropCursorColorToPixel(m_cursorColor);
@@ -140,6 +193,21 @@ constexpr Pixel Renderer::backdropCursorColorToPixel(const uint8_t color) noexce
     return argb;
 }
 
+/** \brief Apply the given Image Contribution Factor to the given color component (V.5.9). */
+constexpr uint8_t applyICFComponent(const int color, const int icf) noexcept
+{
+    return static_cast<uint8_t>(((icf * (color - 16)) / 63) + 16);
+}
+
+/** \brief Precomputed \ref applyICFComponent for every ICF and color component, indexed as `ICF_LUT[icf][color]`. */
+inline constexpr std::array<std::array<uint8_t, 256>, 64> ICF_LUT = [] {
+    std::array<std::array<uint8_t, 256>, 64> lut{};
+    for(int icf = 0; icf < 64; ++icf)
+        for(int color = 0; color < 256; ++color)
+            lut[icf][color] = applyICFComponent(color, icf);
+    return lut;
+}();
+
 } // namespace Video
 
 #endif // CDI_VIDEO_RENDERER_HPP
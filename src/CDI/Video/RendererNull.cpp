@@ -0,0 +1,25 @@
+/** \file RendererNull.cpp
+ * \brief RendererNull implementation file.
+ */
+
+#include "RendererNull.hpp"
+
+namespace Video
+{
+
+/** \brief Computes the number of bytes read by the next line without drawing it.
+ * \param lineA Line A data.
+ * \param lineB Line B data.
+ * \return The number of bytes read from memory for each plane `<plane A, plane B>`.
+ */
+std::pair<uint16_t, uint16_t> RendererNull::DrawLineImpl(const uint8_t* lineA, const uint8_t* lineB) noexcept
+{
+    return GetLineSize(lineA, lineB);
+}
+
+/** \brief Does nothing, the cursor is never drawn. */
+void RendererNull::DrawCursor() noexcept
+{
+}
+
+} // namespace Video
@@ -0,0 +1,26 @@
+#ifndef CDI_VIDEO_RENDERERNULL_HPP
+#define CDI_VIDEO_RENDERERNULL_HPP
+
+#include "Renderer.hpp"
+
+namespace Video
+{
+
+/** \brief CD-i video renderer that does not produce any pixel.
+ *
+ * It only computes the number of bytes read by each line, so the MCD212 can keep advancing its VSR registers and
+ * executing the control areas. The planes and the screen stay black.
+ */
+class RendererNull final : public Renderer
+{
+public:
+    RendererNull() {}
+    virtual ~RendererNull() noexcept {}
+
+    virtual std::pair<uint16_t, uint16_t> DrawLineImpl(const uint8_t* lineA, const uint8_t* lineB) noexcept override;
+    virtual void DrawCursor() noexcept override;
+};
+
+} // namespace Video
+
+#endif // CDI_VIDEO_RENDERERNULL_HPP
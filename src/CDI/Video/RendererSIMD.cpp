@@ -30,7 +30,8 @@ namespace Video
  * \param lineNumber The line number to draw (starting at 0).
  * \return The number of bytes read from memory for each plane `<plane A, plane B>`.
  */
-std::pair<uint16_t, uint16_t> RendererSIMD::DrawLineImpl(const uint8_t* lineA, const uint8_t* lineB) noexcept
+template<SIMDTarget TARGET>
+std::pair<uint16_t, uint16_t> RendererSIMDTarget<TARGET>::DrawLineImpl(const uint8_t* lineA, const uint8_t* lineB) noexcept
 {
     uint16_t bytesA = DrawLinePlane<A>(lineA, nullptr); // nullptr because plane A can't decode RGB555.
     const uint16_t bytesB = DrawLinePlane<B>(lineB, lineA);
@@ -58,12 +59,13 @@ std::pair<uint16_t, uint16_t> RendererSIMD::DrawLineImpl(const uint8_t* lineA, c
  *
  * lineA is only used when the decoding method is RGB555.
  */
+template<SIMDTarget TARGET>
 template<ImagePlane PLANE>
-uint16_t RendererSIMD::DrawLinePlane(const uint8_t* lineMain, const uint8_t* lineA) noexcept
+uint16_t RendererSIMDTarget<TARGET>::DrawLinePlane(const uint8_t* lineMain, const uint8_t* lineA) noexcept
 {
     if(m_codingMethod[PLANE] == ImageCodingMethod::OFF)
     {
-        std::fill_n(std::execution::unseq, m_plane[PLANE].GetLinePointer(m_lineNumber), m_plane[PLANE].m_width, 0);
+        std::fill_n(std::execution::unseq, GetPlaneLine(PLANE), m_screen.m_width, 0);
         return 0;
     }
 
@@ -80,31 +82,31 @@ uint16_t RendererSIMD::DrawLinePlane(const uint8_t* lineMain, const uint8_t* lin
     case ImageType::Normal:
         if(icm == ImageCodingMethod::CLUT4)
             if(Is360Pixels())
-                return decodeBitmapLineSIMD<720>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
+                return decodeBitmapLineSIMD<TARGET, 720>(GetPlaneLine(PLANE), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
             else
-                return decodeBitmapLineSIMD<768>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
+                return decodeBitmapLineSIMD<TARGET, 768>(GetPlaneLine(PLANE), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
         else
             if(Is360Pixels())
-                return decodeBitmapLineSIMD<360>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
+                return decodeBitmapLineSIMD<TARGET, 360>(GetPlaneLine(PLANE), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
             else
-                return decodeBitmapLineSIMD<384>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
+                return decodeBitmapLineSIMD<TARGET, 384>(GetPlaneLine(PLANE), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
 
     case ImageType::RunLength:
         if(m_bps[PLANE] == BitsPerPixel::Double4) // RL3
             if(Is360Pixels())
-                return decodeRunLengthLine<720, true>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLineSIMD<TARGET, 720, true>(GetPlaneLine(PLANE), lineMain, clut);
             else
-                return decodeRunLengthLine<768, true>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLineSIMD<TARGET, 768, true>(GetPlaneLine(PLANE), lineMain, clut);
         else if(m_bps[PLANE] == BitsPerPixel::High8) // RL7 high
             if(Is360Pixels())
-                return decodeRunLengthLine<720, false>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLineSIMD<TARGET, 720, false>(GetPlaneLine(PLANE), lineMain, clut);
             else
-                return decodeRunLengthLine<768, false>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLineSIMD<TARGET, 768, false>(GetPlaneLine(PLANE), lineMain, clut);
         else
             if(Is360Pixels())
-                return decodeRunLengthLine<360, false>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLineSIMD<TARGET, 360, false>(GetPlaneLine(PLANE), lineMain, clut);
             else
-                return decodeRunLengthLine<384, false>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLineSIMD<TARGET, 384, false>(GetPlaneLine(PLANE), lineMain, clut);
 
     case ImageType::Mosaic:
         panic("Unsupported type Mosaic");
@@ -114,7 +116,8 @@ uint16_t RendererSIMD::DrawLinePlane(const uint8_t* lineMain, const uint8_t* lin
     std::unreachable();
 }
 
-void RendererSIMD::DrawCursor() noexcept
+template<SIMDTarget TARGET>
+void RendererSIMDTarget<TARGET>::DrawCursor() noexcept
 {
     // Technically speaking the cursor is drawn when the drawing line number is the cursor's one (because video
     // is outputted continuously line by line). But for here maybe we don't care.
@@ -143,13 +146,11 @@ void RendererSIMD::DrawCursor() noexcept
  * \tparam MIX true to use mixing, false to use overlay.
  * \tparam PLANE_ORDER true when plane B in front of plane A, false for A in front of B.
  */
+template<SIMDTarget TARGET>
 template<bool MIX, bool PLANE_ORDER>
-void RendererSIMD::OverlayMix() noexcept
+void RendererSIMDTarget<TARGET>::OverlayMix() noexcept
 {
-    if(m_matteNumber)
-        HandleMatteSIMD<true>();
-    else
-        HandleMatteSIMD<false>();
+    ComputeMatteSpans();
 
     switch(m_screen.m_width)
     {
@@ -170,28 +171,55 @@ void RendererSIMD::OverlayMix() noexcept
     }
 }
 
+// The helpers are in the namespace of the instruction set, see SIMD.hpp.
+inline namespace LIBCEDIMU_SIMD_TARGET
+{
+
+/** \brief Returns the value of the matte span of each pixel of a SIMD register.
+ * \param span A span that does not start after \p x, it is advanced to the span containing \p x.
+ * \param x The position of the first pixel of the register.
+ * \param value Returns the value to use for the given span.
+ *
+ * Spans are usually much wider than a register, so the value is broadcasted unless a span ends inside it.
+ */
+template<typename SIMD, typename FUNC>
+static SIMD matteSpanValue(const Renderer::MatteSpan*& span, const size_t x, FUNC value) noexcept
+{
+    while(x >= span->end)
+        ++span;
+
+    if(x + SIMD::size() <= span->end)
+        return SIMD(static_cast<typename SIMD::value_type>(value(*span)));
+
+    const Renderer::MatteSpan* first = span;
+    return SIMD([&] (auto lane) {
+        const Renderer::MatteSpan* s = first;
+        while(x + lane >= s->end)
+            ++s;
+        return static_cast<typename SIMD::value_type>(value(*s));
+    });
+}
+
+// The SIMD types layout depends on the target, so these must not be shared with the other translation units.
 template<size_t WIDTH>
-inline constexpr SIMDFixedPixelSigned<WIDTH> U8_MIN{0};
+static constexpr SIMDFixedPixelSigned<WIDTH> U8_MIN{0};
 template<size_t WIDTH>
-inline constexpr SIMDFixedPixelSigned<WIDTH> U8_MAX{255};
+static constexpr SIMDFixedPixelSigned<WIDTH> U8_MAX{255};
 template<size_t WIDTH>
-inline constexpr SIMDFixedPixelSigned<WIDTH> ALPHA_MASK{-16777216}; // 0xFF'00'00'00
+static constexpr SIMDFixedPixelSigned<WIDTH> ALPHA_MASK{-16777216}; // 0xFF'00'00'00
 
-inline constexpr SIMDFixedS16 U8_MINN{0};
-inline constexpr SIMDFixedS16 U8_MAXX{255};
-inline constexpr SIMDNativePixel ALPHA_MASKK{0xFF'00'00'00};
+static constexpr SIMDFixedS16 U8_MINN{0};
+static constexpr SIMDFixedS16 U8_MAXX{255};
+static constexpr SIMDNativePixel ALPHA_MASKK{0xFF'00'00'00};
 
 /** \brief Applies ICF and mixes using SIMD (algorithm that shifts and masks RGB components).
  * \tparam WIDTH The width of the SIMD type.
  */
 template<size_t WIDTH>
-static constexpr void applyICFMixSIMDShift(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, const uint8_t* icfFront, const uint8_t* icfBack, const uint32_t backdrop) noexcept
+static constexpr void applyICFMixSIMDShift(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, SIMDFixedPixelSigned<WIDTH> icfF, SIMDFixedPixelSigned<WIDTH> icfB, const uint32_t backdrop) noexcept
 {
     using SIMD = SIMDFixedPixelSigned<WIDTH>;
 
-    SIMD icfF{icfFront, stdx::element_aligned};
-    SIMD icfB{icfBack, stdx::element_aligned};
-
     SIMD planeF{planeFront->AsU32Pointer(), stdx::element_aligned};
     SIMD planeB{planeBack->AsU32Pointer(), stdx::element_aligned};
 
@@ -263,15 +291,13 @@ static constexpr void applyICFMixSIMDShift(Pixel* screen, const Pixel* planeFron
 
     result.copy_to(screen->AsU32Pointer(), stdx::element_aligned);
 }
-// template void applyICFMixSIMDShift<8>(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, const uint8_t* icfFront, const uint8_t* icfBack, const uint32_t backdrop) noexcept;
+// template void applyICFMixSIMDShift<8>(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, SIMDFixedPixelSigned<8> icfF, SIMDFixedPixelSigned<8> icfB, const uint32_t backdrop) noexcept;
 
 /** \brief Applies ICF and mixes using SIMD (algorithm that casts the registers to access RGB components).
  * This can't be used with fixed-sized SIMD because fixed_sized_simd is not trivially copyable.
  */
-static constexpr void applyICFMixSIMDCast(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, const uint8_t* icfFront, const uint8_t* icfBack, const uint32_t backdrop) noexcept
+static constexpr void applyICFMixSIMDCast(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, SIMDNativePixel icfF, SIMDNativePixel icfB, const uint32_t backdrop) noexcept
 {
-    SIMDNativePixel icfF{icfFront, stdx::element_aligned};
-    SIMDNativePixel icfB{icfBack, stdx::element_aligned};
 
     SIMDNativePixel planeF{planeFront->AsU32Pointer(), stdx::element_aligned};
     SIMDNativePixel planeB{planeBack->AsU32Pointer(), stdx::element_aligned};
@@ -333,14 +359,11 @@ static constexpr void applyICFMixSIMDCast(Pixel* screen, const Pixel* planeFront
  * \tparam SIMD The SIMD type holding signed 32 bits integers.
  */
 template<typename SIMD>
-static constexpr void applyICFOverlaySIMDShift(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, const uint8_t* icfFront, const uint8_t* icfBack, const uint32_t backdrop) noexcept
+static constexpr void applyICFOverlaySIMDShift(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, const SIMD icfF, const SIMD icfB, const uint32_t backdrop) noexcept
 {
     SIMD planeF{planeFront->AsU32Pointer(), stdx::element_aligned};
     SIMD planeB{planeBack->AsU32Pointer(), stdx::element_aligned};
 
-    const SIMD icfF{icfFront, stdx::element_aligned};
-    const SIMD icfB{icfBack, stdx::element_aligned};
-
     SIMD rfp = planeF >> 16 & 0xFF;
     SIMD gfp = planeF >> 8 & 0xFF;
     SIMD bfp = planeF & 0xFF;
@@ -408,7 +431,7 @@ static constexpr void applyICFOverlaySIMDShift(Pixel* screen, const Pixel* plane
 /** \brief Applies ICF and overlays using SIMD (algorithm that casts the registers to access RGB components).
  * This can't be used with fixed-sized SIMD because fixed_sized_simd is not trivially copyable.
  */
-static constexpr void applyICFOverlaySIMDCast(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, const uint8_t* icfFront, const uint8_t* icfBack, const uint32_t backdrop) noexcept
+static constexpr void applyICFOverlaySIMDCast(Pixel* screen, const Pixel* planeFront, const Pixel* planeBack, SIMDNativePixel icfF, SIMDNativePixel icfB, const uint32_t backdrop) noexcept
 {
     SIMDNativePixel planeF{planeFront->AsU32Pointer(), stdx::element_aligned};
     SIMDNativePixel planeB{planeBack->AsU32Pointer(), stdx::element_aligned};
@@ -417,9 +440,6 @@ static constexpr void applyICFOverlaySIMDCast(Pixel* screen, const Pixel* planeF
     const SIMDNativePixel::mask_type transparentB = (planeB & ALPHA_MASKK) == 0;
     // Transparent pixels are overwritten by visible pixels in the end so no need to adjust ICF and black level.
 
-    SIMDNativePixel icfF{icfFront, stdx::element_aligned};
-    SIMDNativePixel icfB{icfBack, stdx::element_aligned};
-
     // extend ICF to whole register.
     icfF *= 0x00'01'01'01;
     icfB *= 0x00'01'01'01;
@@ -462,6 +482,8 @@ static constexpr void applyICFOverlaySIMDCast(Pixel* screen, const Pixel* planeF
     result.copy_to(screen->AsU32Pointer(), stdx::element_aligned);
 }
 
+} // inline namespace LIBCEDIMU_SIMD_TARGET
+
 /** \brief Dispatches the correct overlay or mix SIMD algorithm.
  * \tparam MIX true to use mixing, false to use overlay.
  * \tparam PLANE_ORDER true when plane B in front of plane A, false for A in front of B.
@@ -470,185 +492,50 @@ static constexpr void applyICFOverlaySIMDCast(Pixel* screen, const Pixel* planeF
  * necessary amount of data (no more than the width of the screen and planes).
  * Because fixed-sized SIMD is not trivially copyable, Shift algorithm is used for the last loop with the reminder.
  */
+template<SIMDTarget TARGET>
 template<bool MIX, bool PLANE_ORDER, size_t WIDTH_REMINDER>
-void RendererSIMD::HandleOverlayMixSIMD() noexcept
+void RendererSIMDTarget<TARGET>::HandleOverlayMixSIMD() noexcept
 {
+    constexpr ImagePlane FRONT = PLANE_ORDER ? B : A;
+    constexpr ImagePlane BACK = PLANE_ORDER ? A : B;
+
     Pixel* screen = m_screen.GetLinePointer(m_lineNumber);
-    const Pixel* planeFront;
-    const Pixel* planeBack;
-    const uint8_t* icfFront;
-    const uint8_t* icfBack;
-    if constexpr(PLANE_ORDER)
-    {
-        planeFront = m_plane[B].GetLinePointer(m_lineNumber);
-        planeBack = m_plane[A].GetLinePointer(m_lineNumber);
-        icfFront = m_icfLine[B].data();
-        icfBack = m_icfLine[A].data();
-    }
-    else
-    {
-        planeFront = m_plane[A].GetLinePointer(m_lineNumber);
-        planeBack = m_plane[B].GetLinePointer(m_lineNumber);
-        icfFront = m_icfLine[A].data();
-        icfBack = m_icfLine[B].data();
-    }
+    const Pixel* planeFront = GetPlaneLine(FRONT);
+    const Pixel* planeBack = GetPlaneLine(BACK);
+    const uint32_t backdrop = m_backdropPlane.GetLinePointer(m_lineNumber)->AsU32();
 
+    const MatteSpan* span = GetMatteSpans().data();
+    const auto icfFront = [] (const MatteSpan& s) { return s.icf[FRONT]; };
+    const auto icfBack = [] (const MatteSpan& s) { return s.icf[BACK]; };
+
+    size_t x = 0;
     for(size_t width = m_screen.m_width; width >= SIMD_SIZE; width -= SIMD_SIZE,
-        planeFront += SIMD_SIZE, planeBack += SIMD_SIZE, icfFront += SIMD_SIZE, icfBack += SIMD_SIZE, screen += SIMD_SIZE)
+        planeFront += SIMD_SIZE, planeBack += SIMD_SIZE, screen += SIMD_SIZE, x += SIMD_SIZE)
     {
+        const SIMDNativePixel icfF = matteSpanValue<SIMDNativePixel>(span, x, icfFront);
+        const SIMDNativePixel icfB = matteSpanValue<SIMDNativePixel>(span, x, icfBack);
         if constexpr(MIX) // Mixing.
-            applyICFMixSIMDCast(screen, planeFront, planeBack, icfFront, icfBack, m_backdropPlane.GetLinePointer(m_lineNumber)->AsU32());
+            applyICFMixSIMDCast(screen, planeFront, planeBack, icfF, icfB, backdrop);
         else // Overlay.
-            applyICFOverlaySIMDCast(screen, planeFront, planeBack, icfFront, icfBack, m_backdropPlane.GetLinePointer(m_lineNumber)->AsU32());
+            applyICFOverlaySIMDCast(screen, planeFront, planeBack, icfF, icfB, backdrop);
     }
 
     if constexpr(WIDTH_REMINDER != 0) // Now the remaining width is less than a SIMD register.
     {
+        using SIMD = SIMDFixedPixelSigned<WIDTH_REMINDER>;
+        const SIMD icfF = matteSpanValue<SIMD>(span, x, icfFront);
+        const SIMD icfB = matteSpanValue<SIMD>(span, x, icfBack);
         if constexpr(MIX)
-            applyICFMixSIMDShift<WIDTH_REMINDER>(screen, planeFront, planeBack, icfFront, icfBack, m_backdropPlane.GetLinePointer(m_lineNumber)->AsU32());
+            applyICFMixSIMDShift<WIDTH_REMINDER>(screen, planeFront, planeBack, icfF, icfB, backdrop);
         else
-            applyICFOverlaySIMDShift<SIMDFixedPixelSigned<WIDTH_REMINDER>>(screen, planeFront, planeBack, icfFront, icfBack, m_backdropPlane.GetLinePointer(m_lineNumber)->AsU32());
-    }
-}
-
-/** \brief Executes the given matte command.
- * \tparam TWO_MATTES true for two mattes, false for one matte.
- * \param command The command to execute.
- * \param mf The matte flag to modifiy (used only when TWO_MATTES is true).
- * \return true if upper registers are to be ignored (command 0).
- */
-template<bool TWO_MATTES>
-bool RendererSIMD::ExecuteMatteCommand(const uint32_t command, bool mf) noexcept
-{
-    if constexpr(!TWO_MATTES)
-        mf = matteMF(command);
-
-    const uint8_t op = matteOp(command);
-    switch(op)
-    {
-    case 0b0000:
-        return true;
-
-    case 0b0100:
-        m_icf[A] = matteICF(command);
-        break;
-
-    case 0b0110:
-        m_icf[B] = matteICF(command);
-        break;
-
-    case 0b1000:
-        m_matteFlags[mf] = false;
-        break;
-
-    case 0b1001:
-        m_matteFlags[mf] = true;
-        break;
-
-    case 0b1100:
-        m_icf[A] = matteICF(command);
-        m_matteFlags[mf] = false;
-        break;
-
-    case 0b1101:
-        m_icf[A] = matteICF(command);
-        m_matteFlags[mf] = true;
-        break;
-
-    case 0b1110:
-        m_icf[B] = matteICF(command);
-        m_matteFlags[mf] = false;
-        break;
-
-    case 0b1111:
-        m_icf[B] = matteICF(command);
-        m_matteFlags[mf] = true;
-        break;
-    }
-
-    return false;
-}
-
-template<bool TWO_MATTES>
-void RendererSIMD::HandleMatteSIMD() noexcept
-{
-    // No need to reset m_matteFlagsLine to false.
-
-    size_t nextMatte0 = 0; // Used when 1 or 2 mattes.
-    size_t nextMatte1 = MATTE_HALF; // Used when 2 mattes.
-    size_t nextChange0 = matteXPosition(m_matteControl[nextMatte0]);
-    size_t nextChange1 = matteXPosition(m_matteControl[nextMatte1]);
-
-    for(size_t x = 0; x < m_screen.m_width;)
-    {
-        size_t nextChange = m_screen.m_width;
-
-        if constexpr(TWO_MATTES)
-        {
-            if(nextChange0 == x)
-            {
-                const uint32_t command0 = m_matteControl[nextMatte0];
-                const bool disregard = ExecuteMatteCommand<TWO_MATTES>(command0, false); // false for matte 0.
-
-                ++nextMatte0;
-                if(disregard || nextMatte0 >= MATTE_HALF)
-                    nextChange0 = m_screen.m_width;
-                else
-                    nextChange0 = matteXPosition(m_matteControl[nextMatte0]);
-            }
-
-            if(nextChange1 == x)
-            {
-                const uint32_t command1 = m_matteControl[nextMatte1];
-                const bool disregard = ExecuteMatteCommand<TWO_MATTES>(command1, true); // true for matte 1.
-
-                ++nextMatte1;
-                if(disregard || nextMatte1 >= MATTE_NUM)
-                    nextChange1 = m_screen.m_width;
-                else
-                    nextChange1 = matteXPosition(m_matteControl[nextMatte1]);
-            }
-
-            // Sometimes the next register has a lower position.
-            if(nextChange0 <= x)
-                nextChange0 = m_screen.m_width;
-            if(nextChange1 <= x)
-                nextChange1 = m_screen.m_width;
-            nextChange = std::min(nextChange0, nextChange1);
-        }
-        else
-        {
-            if(nextChange0 == x)
-            {
-                const uint32_t command = m_matteControl[nextMatte0];
-                const bool disregard = ExecuteMatteCommand<TWO_MATTES>(command, false); // false is unused with one matte.
-
-                ++nextMatte0;
-                if(disregard || nextMatte0 >= m_matteControl.size())
-                    nextChange0 = m_screen.m_width;
-                else
-                {
-                    nextChange0 = matteXPosition(m_matteControl[nextMatte0]);
-                    if(nextChange0 <= x) // Sometimes the next register has a lower position.
-                        nextChange0 = m_screen.m_width;
-                }
-            }
-            nextChange = nextChange0;
-        }
-
-        for(; x < nextChange; ++x)
-        {
-            m_icfLine[A][x] = m_icf[A];
-            m_icfLine[B][x] = m_icf[B];
-            m_matteFlagsLine[A][x] = m_matteFlags[A];
-            m_matteFlagsLine[B][x] = m_matteFlags[B];
-        }
+            applyICFOverlaySIMDShift<SIMD>(screen, planeFront, planeBack, icfF, icfB, backdrop);
     }
 }
 
 /** \brief Dispatch transparency of plane A. */
+template<SIMDTarget TARGET>
 template<size_t WIDTH_REM>
-void RendererSIMD::HandleTransparencyPlaneASIMD() noexcept
+void RendererSIMDTarget<TARGET>::HandleTransparencyPlaneASIMD() noexcept
 {
     const bool booleanA = !bit<3>(m_transparencyControl[A]);
     const uint8_t controlA = bits<0, 2>(m_transparencyControl[A]);
@@ -713,8 +600,9 @@ void RendererSIMD::HandleTransparencyPlaneASIMD() noexcept
 }
 
 /** \brief Dispatch transparency of plane B. */
+template<SIMDTarget TARGET>
 template<size_t WIDTH_REM>
-void RendererSIMD::HandleTransparencyPlaneBSIMD() noexcept
+void RendererSIMDTarget<TARGET>::HandleTransparencyPlaneBSIMD() noexcept
 {
     const bool booleanB = !bit<3>(m_transparencyControl[B]);
     const uint8_t controlB = bits<0, 2>(m_transparencyControl[B]);
@@ -778,42 +666,59 @@ void RendererSIMD::HandleTransparencyPlaneBSIMD() noexcept
     }
 }
 
+inline namespace LIBCEDIMU_SIMD_TARGET
+{
+
 static constexpr Pixel::ARGB32 COLOR_KEY_MASK = 0x00'FC'FC'FC;
 
 template<Renderer::TransparentIf TRANSPARENT, bool BOOL_FLAG, typename SIMD>
-constexpr void HandleTransparencySIMD(Pixel* plane, const bool* matteFlagsA, const bool* matteFlagsB, SIMD colorMask, SIMD transparentColor) noexcept;
+static constexpr void HandleTransparencySIMD(Pixel* plane, typename SIMD::mask_type matteFlag0, typename SIMD::mask_type matteFlag1, SIMD colorMask, SIMD transparentColor) noexcept;
+
+/** \brief Returns the given matte flag of each pixel of a SIMD register, see \ref matteSpanValue. */
+template<typename SIMD, bool MATTE_FLAG>
+static typename SIMD::mask_type matteSpanFlag(const Renderer::MatteSpan*& span, const size_t x) noexcept
+{
+    return matteSpanValue<SIMD>(span, x, [] (const Renderer::MatteSpan& s) { return s.matteFlags[MATTE_FLAG]; }) != 0;
+}
+
+} // inline namespace LIBCEDIMU_SIMD_TARGET
 
 /** \brief Actually handles the transparency for a plane statically. */
+template<SIMDTarget TARGET>
 template<size_t WIDTH_REM, ImagePlane PLANE, Renderer::TransparentIf TRANSPARENT, bool BOOL_FLAG>
-void RendererSIMD::HandleTransparencyLoopSIMD() noexcept
+void RendererSIMDTarget<TARGET>::HandleTransparencyLoopSIMD() noexcept
 {
     const SIMDNativePixel colorMask{m_maskColorRgb[PLANE] & COLOR_KEY_MASK};
     const SIMDNativePixel transparentColor{(m_transparentColorRgb[PLANE] & COLOR_KEY_MASK) | colorMask};
 
-    Pixel* plane = m_plane[PLANE].GetLinePointer(m_lineNumber);
-    size_t remaining = m_plane[PLANE].m_width;
-    size_t i = 0;
+    Pixel* plane = GetPlaneLine(PLANE);
+    const MatteSpan* span = GetMatteSpans().data();
+    size_t remaining = m_screen.m_width;
+    size_t x = 0;
     for(; remaining >= SIMDNativePixel::size();
-        remaining -= SIMDNativePixel::size(), i += SIMDNativePixel::size(), plane += SIMDNativePixel::size())
+        remaining -= SIMDNativePixel::size(), x += SIMDNativePixel::size(), plane += SIMDNativePixel::size())
     {
-        const bool* matteFlagsA = m_matteFlagsLine[A].data() + i;
-        const bool* matteFlagsB = m_matteFlagsLine[B].data() + i;
-        HandleTransparencySIMD<TRANSPARENT, BOOL_FLAG, SIMDNativePixel>(plane, matteFlagsA, matteFlagsB, colorMask, transparentColor);
+        const auto matteFlag0 = matteSpanFlag<SIMDNativePixel, 0>(span, x);
+        const auto matteFlag1 = matteSpanFlag<SIMDNativePixel, 1>(span, x);
+        HandleTransparencySIMD<TRANSPARENT, BOOL_FLAG, SIMDNativePixel>(plane, matteFlag0, matteFlag1, colorMask, transparentColor);
     }
 
     if constexpr(WIDTH_REM != 0)
     {
         const SIMDFixedPixel<WIDTH_REM> colorMaskFixed{m_maskColorRgb[PLANE] & COLOR_KEY_MASK};
         const SIMDFixedPixel<WIDTH_REM> transparentColorFixed{(m_transparentColorRgb[PLANE] & COLOR_KEY_MASK) | colorMaskFixed};
-        const bool* matteFlagsA = m_matteFlagsLine[A].data() + i;
-        const bool* matteFlagsB = m_matteFlagsLine[B].data() + i;
-        HandleTransparencySIMD<TRANSPARENT, BOOL_FLAG, SIMDFixedPixel<WIDTH_REM>>(plane, matteFlagsA, matteFlagsB, colorMaskFixed, transparentColorFixed);
+        const auto matteFlag0 = matteSpanFlag<SIMDFixedPixel<WIDTH_REM>, 0>(span, x);
+        const auto matteFlag1 = matteSpanFlag<SIMDFixedPixel<WIDTH_REM>, 1>(span, x);
+        HandleTransparencySIMD<TRANSPARENT, BOOL_FLAG, SIMDFixedPixel<WIDTH_REM>>(plane, matteFlag0, matteFlag1, colorMaskFixed, transparentColorFixed);
     }
 }
-template void RendererSIMD::HandleTransparencyLoopSIMD<8, A, Renderer::TransparentIf::AlwaysNever, false>() noexcept;
+template void RendererSIMDTarget<CURRENT_SIMD_TARGET>::HandleTransparencyLoopSIMD<8, A, Renderer::TransparentIf::AlwaysNever, false>() noexcept;
+
+inline namespace LIBCEDIMU_SIMD_TARGET
+{
 
 template<Renderer::TransparentIf TRANSPARENT, bool BOOL_FLAG, typename SIMD>
-constexpr void HandleTransparencySIMD(Pixel* plane, const bool* matteFlagsA, const bool* matteFlagsB, SIMD colorMask, SIMD transparentColor) noexcept
+static constexpr void HandleTransparencySIMD(Pixel* plane, typename SIMD::mask_type matteFlag0, typename SIMD::mask_type matteFlag1, SIMD colorMask, SIMD transparentColor) noexcept
 {
     using MASK = SIMD::mask_type;
     constexpr MASK FLAG{BOOL_FLAG};
@@ -846,29 +751,25 @@ constexpr void HandleTransparencySIMD(Pixel* plane, const bool* matteFlagsA, con
 
     case Renderer::TransparentIf::MatteFlag0: // Matte Flag 0.
     {
-        const MASK matte{matteFlagsA, stdx::element_aligned};
-        stdx::where(matte == FLAG, pixel) &= CLEAR_ALPHA;
+        stdx::where(matteFlag0 == FLAG, pixel) &= CLEAR_ALPHA;
         break;
     }
 
     case Renderer::TransparentIf::MatteFlag1: // Matte Flag 1.
     {
-        const MASK matte{matteFlagsB, stdx::element_aligned};
-        stdx::where(matte == FLAG, pixel) &= CLEAR_ALPHA;
+        stdx::where(matteFlag1 == FLAG, pixel) &= CLEAR_ALPHA;
         break;
     }
 
     case Renderer::TransparentIf::MatteFlag0OrColorKey: // Matte Flag 0 or Color Key.
     {
-        const MASK matte{matteFlagsA, stdx::element_aligned};
-        stdx::where(matte == FLAG || colorKey == FLAG, pixel) &= CLEAR_ALPHA;
+        stdx::where(matteFlag0 == FLAG || colorKey == FLAG, pixel) &= CLEAR_ALPHA;
         break;
     }
 
     case Renderer::TransparentIf::MatteFlag1OrColorKey: // Matte Flag 1 or Color Key.
     {
-        const MASK matte{matteFlagsB, stdx::element_aligned};
-        stdx::where(matte == FLAG || colorKey == FLAG, pixel) &= CLEAR_ALPHA;
+        stdx::where(matteFlag1 == FLAG || colorKey == FLAG, pixel) &= CLEAR_ALPHA;
         break;
     }
 
@@ -880,4 +781,8 @@ constexpr void HandleTransparencySIMD(Pixel* plane, const bool* matteFlagsA, con
     pixel.copy_to(plane->AsU32Pointer(), stdx::element_aligned);
 }
 
+} // inline namespace LIBCEDIMU_SIMD_TARGET
+
+template class RendererSIMDTarget<CURRENT_SIMD_TARGET>;
+
 } // namespace Video
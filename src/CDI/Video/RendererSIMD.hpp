@@ -2,17 +2,24 @@
 #define CDI_VIDEO_RENDERERSIMD_HPP
 
 #include "Renderer.hpp"
+#include "SIMDDispatch.hpp"
+
+#include <memory>
 
 namespace Video
 {
 
 /** \brief CD-i video renderer implementation using std::simd.
+ * \tparam TARGET The instruction set the renderer is compiled for.
+ *
+ * Use \ref makeRendererSIMD to get the renderer for the instruction set selected at runtime.
  */
-class RendererSIMD final : public Renderer
+template<SIMDTarget TARGET>
+class LIBCEDIMU_SIMD_ENTRY RendererSIMDTarget final : public Renderer
 {
 public:
-    RendererSIMD() {}
-    virtual ~RendererSIMD() noexcept {}
+    RendererSIMDTarget() {}
+    virtual ~RendererSIMDTarget() noexcept {}
 
     virtual std::pair<uint16_t, uint16_t> DrawLineImpl(const uint8_t* lineA, const uint8_t* lineB) noexcept override;
     virtual void DrawCursor() noexcept override;
@@ -29,16 +36,17 @@ public:
     template<size_t WIDTH_REM, ImagePlane PLANE, TransparentIf TRANSPARENT, bool BOOL_FLAG>
     void HandleTransparencyLoopSIMD() noexcept;
 
-    template<bool TWO_MATTES>
-    void HandleMatteSIMD() noexcept;
-    template<bool TWO_MATTES>
-    bool ExecuteMatteCommand(uint32_t command, bool mf) noexcept;
+};
+
+extern template class RendererSIMDTarget<SIMDTarget::Default>;
+extern template class RendererSIMDTarget<SIMDTarget::SSE42>;
+extern template class RendererSIMDTarget<SIMDTarget::AVX2>;
 
-    // Image Contribution Factor.
-    std::array<std::array<uint8_t, Plane::MAX_WIDTH>, 2> m_icfLine{}; /**< ICF for the whole line. */
+/** \brief SIMD renderer compiled with the instruction set of the library. */
+using RendererSIMD = RendererSIMDTarget<SIMDTarget::Default>;
 
-    std::array<std::array<bool, Plane::MAX_WIDTH>, 2> m_matteFlagsLine{}; /**< Matte flags for the whole line. */
-};
+std::unique_ptr<Renderer> makeRendererSIMD();
+std::unique_ptr<Renderer> makeRendererSIMD(SIMDTarget target);
 
 } // namespace Video
 
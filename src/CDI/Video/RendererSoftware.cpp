@@ -8,6 +8,7 @@
 #include "../common/panic.hpp"
 #include "../common/utils.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 namespace Video
@@ -52,7 +53,7 @@ uint16_t RendererSoftware::DrawLinePlane(const uint8_t* lineMain, const uint8_t*
 {
     if(m_codingMethod[PLANE] == ImageCodingMethod::OFF)
     {
-        std::fill_n(m_plane[PLANE].GetLinePointer(m_lineNumber), m_plane[PLANE].m_width, Pixel{0});
+        std::fill_n(GetPlaneLine(PLANE), m_screen.m_width, Pixel{0});
         return 0;
     }
 
@@ -69,31 +70,31 @@ uint16_t RendererSoftware::DrawLinePlane(const uint8_t* lineMain, const uint8_t*
     case ImageType::Normal:
         if(icm == ImageCodingMethod::CLUT4)
             if(Is360Pixels())
-                return decodeBitmapLine<720>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
+                return decodeBitmapLine<720>(GetPlaneLine(PLANE), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
             else
-                return decodeBitmapLine<768>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
+                return decodeBitmapLine<768>(GetPlaneLine(PLANE), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
         else
             if(Is360Pixels())
-                return decodeBitmapLine<360>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
+                return decodeBitmapLine<360>(GetPlaneLine(PLANE), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
             else
-                return decodeBitmapLine<384>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
+                return decodeBitmapLine<384>(GetPlaneLine(PLANE), lineA, lineMain, clut, m_dyuvInitialValue[PLANE], icm);
 
     case ImageType::RunLength:
         if(m_bps[PLANE] == BitsPerPixel::Double4) // RL3
             if(Is360Pixels())
-                return decodeRunLengthLine<720, true>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLine<720, true>(GetPlaneLine(PLANE), lineMain, clut);
             else
-                return decodeRunLengthLine<768, true>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLine<768, true>(GetPlaneLine(PLANE), lineMain, clut);
         else if(m_bps[PLANE] == BitsPerPixel::High8) // RL7 high
             if(Is360Pixels())
-                return decodeRunLengthLine<720, false>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLine<720, false>(GetPlaneLine(PLANE), lineMain, clut);
             else
-                return decodeRunLengthLine<768, false>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLine<768, false>(GetPlaneLine(PLANE), lineMain, clut);
         else
             if(Is360Pixels())
-                return decodeRunLengthLine<360, false>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLine<360, false>(GetPlaneLine(PLANE), lineMain, clut);
             else
-                return decodeRunLengthLine<384, false>(m_plane[PLANE].GetLinePointer(m_lineNumber), lineMain, clut);
+                return decodeRunLengthLine<384, false>(GetPlaneLine(PLANE), lineMain, clut);
 
     case ImageType::Mosaic:
         panic("Unsupported type Mosaic");
@@ -124,108 +125,112 @@ void RendererSoftware::DrawCursor() noexcept
     }
 }
 
-/** \brief Apply the given Image Contribution Factor to the given color component (V.5.9). */
-static constexpr uint8_t applyICFComponent(const int color, const int icf) noexcept
+/** \brief Apply an Image Contribution Factor to the given pixel (V.5.9).
+ * \param pixel The pixel, its alpha channel is kept.
+ * \param lut The row of \ref ICF_LUT of the ICF to apply.
+ */
+static constexpr uint32_t applyICF(const Pixel pixel, const std::array<uint8_t, 256>& lut) noexcept
 {
-    return static_cast<uint8_t>(((icf * (color - 16)) / 63) + 16);
+    return static_cast<uint32_t>(pixel.a) << 24 | static_cast<uint32_t>(lut[pixel.r]) << 16 |
+        static_cast<uint32_t>(lut[pixel.g]) << 8 | lut[pixel.b];
 }
 
-/** \brief Apply the given Image Contribution Factor to the given color component (V.5.9). */
-static constexpr void applyICF(Pixel& pixel, const int icf) noexcept
+/** \brief Mixes a line of front and back pixels after ICF (V.5.9.1).
+ * \param screen Where the mixed pixels are written to.
+ * \param front The front plane pixels after ICF.
+ * \param back The back plane pixels after ICF.
+ * \param width The number of pixels.
+ * \param backdrop The backdrop color, shown where both planes are transparent.
+ *
+ * When mixing, transparent pixels are black (V.5.9.1), which is 16 in each component. Mixing a pixel with black
+ * gives back the pixel, so only the case where both planes are transparent needs to be handled separately.
+ *
+ * This loop is written without branches nor lookups so the compiler can vectorize it on every target.
+ */
+static void mixLine(uint32_t* screen, const uint32_t* front, const uint32_t* back, const uint16_t width, const uint32_t backdrop) noexcept
 {
-    pixel.r = applyICFComponent(pixel.r, icf);
-    pixel.g = applyICFComponent(pixel.g, icf);
-    pixel.b = applyICFComponent(pixel.b, icf);
+    for(uint16_t i = 0; i < width; ++i)
+    {
+        const uint32_t f = front[i];
+        const uint32_t b = back[i];
+        const bool transparentF = (f & 0xFF00'0000) == 0;
+        const bool transparentB = (b & 0xFF00'0000) == 0;
+        const uint32_t fp = transparentF ? 0x0010'1010 : f;
+        const uint32_t bp = transparentB ? 0x0010'1010 : b;
+
+        const int r = std::clamp<int>((fp >> 16 & 0xFF) + (bp >> 16 & 0xFF) - 16, 0, 255);
+        const int g = std::clamp<int>((fp >> 8 & 0xFF) + (bp >> 8 & 0xFF) - 16, 0, 255);
+        const int bl = std::clamp<int>((fp & 0xFF) + (bp & 0xFF) - 16, 0, 255);
+        const uint32_t mixed = static_cast<uint32_t>(Renderer::PIXEL_FULL_INTENSITY) << 24 | r << 16 | g << 8 | bl;
+
+        screen[i] = transparentF && transparentB ? backdrop : mixed;
+    }
 }
 
-/** \brief Apply mixing to the given color components after ICF (V.5.9.1). */
-static constexpr void mix(Pixel& dst, const Pixel a, const Pixel b) noexcept
+/** \brief Overlays a line of front and back pixels after ICF.
+ * \param screen Where the overlaid pixels are written to.
+ * \param front The front plane pixels after ICF.
+ * \param back The back plane pixels after ICF.
+ * \param width The number of pixels.
+ * \param backdrop The backdrop color, shown where both planes are transparent.
+ *
+ * This loop is written without branches nor lookups so the compiler can vectorize it on every target.
+ */
+static void overlayLine(uint32_t* screen, const uint32_t* front, const uint32_t* back, const uint16_t width, const uint32_t backdrop) noexcept
 {
-    dst.a = Renderer::PIXEL_FULL_INTENSITY;
-    dst.r = limu8(a.r + b.r - 16);
-    dst.g = limu8(a.g + b.g - 16);
-    dst.b = limu8(a.b + b.b - 16);
+    for(uint16_t i = 0; i < width; ++i)
+    {
+        const uint32_t f = front[i];
+        const uint32_t b = back[i];
+        const uint32_t behind = (b & 0xFF00'0000) == 0 ? backdrop : b;
+        screen[i] = (f & 0xFF00'0000) == 0 ? behind : f;
+    }
 }
 
 /** \brief Overlays or mix all the planes to the final screen.
  * \tparam MIX true to use mixing, false to use overlay.
  * \tparam PLANE_ORDER true when plane B in front of plane A, false for A in front of B.
+ *
+ * ICF is applied first with lookups in \ref ICF_LUT, span by span, then the planes are composited by a
+ * vectorizable kernel.
  */
 template<bool MIX, bool PLANE_ORDER>
 void RendererSoftware::OverlayMix() noexcept
 {
-    Pixel* screen = m_screen.GetLinePointer(m_lineNumber);
-    Pixel* planeA = m_plane[A].GetLinePointer(m_lineNumber);
-    Pixel* planeB = m_plane[B].GetLinePointer(m_lineNumber);
-    const Pixel backdrop = *m_backdropPlane.GetLinePointer(m_lineNumber);
+    constexpr ImagePlane FRONT = PLANE_ORDER ? B : A;
+    constexpr ImagePlane BACK = PLANE_ORDER ? A : B;
 
-    HandleMatteAndTransparency(m_lineNumber);
-
-    for(uint16_t i = 0; i < m_plane[A].m_width; i++) // Both planes always have the same width.
-    {
-        Pixel a = *planeA++;
-        Pixel b = *planeB++;
+    const Pixel* planeFront = GetPlaneLine(FRONT);
+    const Pixel* planeBack = GetPlaneLine(BACK);
+    const uint32_t backdrop = m_backdropPlane.GetLinePointer(m_lineNumber)->AsU32();
+    const uint16_t width = m_screen.m_width; // The planes always have the width of the screen.
 
-        applyICF(a, m_icfLine[A][i]);
-        applyICF(b, m_icfLine[B][i]);
+    HandleMatteAndTransparency();
 
-        Pixel fp, bp;
-        if constexpr(PLANE_ORDER) // Plane B in front.
-        {
-            fp = b;
-            bp = a;
-        }
-        else // Plane A in front.
-        {
-            fp = a;
-            bp = b;
-        }
-
-        // Plane transparency is either 0 or 255.
-        // Backdrop is always visible.
-        Pixel pixel;
-        if constexpr(MIX)
-        {
-            // When mixing transparent pixels are black (V.5.9.1).
-            if(fp.a == 0 && bp.a == 0) // Front and back planes transparent: only show background.
-            {
-                pixel = backdrop;
-            }
-            else if(fp.a == 0) // Front plane transparent: only back plane.
-            {
-                pixel = bp;
-            }
-            else if(bp.a == 0) // Back plane transparent: only front plane.
-            {
-                pixel = fp;
-            }
-            else // Both planes visible: mix them.
-            {
-                mix(pixel, fp, bp);
-            }
-        }
-        else // Overlay.
+    for(const MatteSpan& span : GetMatteSpans())
+    {
+        const std::array<uint8_t, 256>& lutFront = ICF_LUT[span.icf[FRONT]];
+        const std::array<uint8_t, 256>& lutBack = ICF_LUT[span.icf[BACK]];
+        for(uint16_t i = span.begin; i < span.end; i++)
         {
-            if(fp.a == 0 && bp.a == 0) // Front and back planes transparent: only show background.
-            {
-                pixel = backdrop;
-            }
-            else if(fp.a == 0) // Front plane transparent: show back plane.
-            {
-                pixel = bp;
-            }
-            else // Front plane visible: only show front plane.
-            {
-                pixel = fp;
-            }
+            m_icfFront[i] = applyICF(planeFront[i], lutFront);
+            m_icfBack[i] = applyICF(planeBack[i], lutBack);
         }
-        *screen++ = pixel; // Should always have the transparency component to 255.
     }
+
+    // Plane transparency is either 0 or 255.
+    // Backdrop is always visible.
+    if constexpr(MIX)
+        mixLine(m_screen.GetLinePointer(m_lineNumber)->AsU32Pointer(), m_icfFront.data(), m_icfBack.data(), width, backdrop);
+    else
+        overlayLine(m_screen.GetLinePointer(m_lineNumber)->AsU32Pointer(), m_icfFront.data(), m_icfBack.data(), width, backdrop);
 }
 
 /** \brief Applies matte and transparency to the two video planes. */
-void RendererSoftware::HandleMatteAndTransparency(const uint16_t lineNumber) noexcept
+void RendererSoftware::HandleMatteAndTransparency() noexcept
 {
+    ComputeMatteSpans();
+
     const bool booleanA = !bit<3>(m_transparencyControl[A]);
     const uint8_t controlA = bits<0, 2>(m_transparencyControl[A]);
 
@@ -233,53 +238,53 @@ void RendererSoftware::HandleMatteAndTransparency(const uint16_t lineNumber) noe
     {
     case TransparentIf::AlwaysNever: // Always/Never.
         if(booleanA)
-            HandleMatteAndTransparencyDispatchB<TransparentIf::AlwaysNever, true>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::AlwaysNever, true>();
         else
-            HandleMatteAndTransparencyDispatchB<TransparentIf::AlwaysNever, false>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::AlwaysNever, false>();
         break;
 
     case TransparentIf::ColorKey: // Color Key.
         if(booleanA)
-            HandleMatteAndTransparencyDispatchB<TransparentIf::ColorKey, true>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::ColorKey, true>();
         else
-            HandleMatteAndTransparencyDispatchB<TransparentIf::ColorKey, false>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::ColorKey, false>();
         break;
 
     case TransparentIf::TransparencyBit: // Transparent Bit.
         // TODO: currently decodeRGB555 make the pixel visible if the bit is set.
         // TODO: disable if not RGB555.
         if(booleanA)
-            HandleMatteAndTransparencyDispatchB<TransparentIf::TransparencyBit, true>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::TransparencyBit, true>();
         else
-            HandleMatteAndTransparencyDispatchB<TransparentIf::TransparencyBit, false>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::TransparencyBit, false>();
         break;
 
     case TransparentIf::MatteFlag0: // Matte Flag 0.
         if(booleanA)
-            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag0, true>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag0, true>();
         else
-            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag0, false>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag0, false>();
         break;
 
     case TransparentIf::MatteFlag1: // Matte Flag 1.
         if(booleanA)
-            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag1, true>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag1, true>();
         else
-            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag1, false>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag1, false>();
         break;
 
     case TransparentIf::MatteFlag0OrColorKey: // Matte Flag 0 or Color Key.
         if(booleanA)
-            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag0OrColorKey, true>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag0OrColorKey, true>();
         else
-            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag0OrColorKey, false>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag0OrColorKey, false>();
         break;
 
     case TransparentIf::MatteFlag1OrColorKey: // Matte Flag 1 or Color Key.
         if(booleanA)
-            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag1OrColorKey, true>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag1OrColorKey, true>();
         else
-            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag1OrColorKey, false>(lineNumber);
+            HandleMatteAndTransparencyDispatchB<TransparentIf::MatteFlag1OrColorKey, false>();
         break;
 
     default: // Reserved.
@@ -290,7 +295,7 @@ void RendererSoftware::HandleMatteAndTransparency(const uint16_t lineNumber) noe
 
 /** \brief Takes the template transparency control of A and mixes it with B's and handle them both. */
 template<Renderer::TransparentIf TRANSPARENCY_A, bool FLAG_A>
-void RendererSoftware::HandleMatteAndTransparencyDispatchB(const uint16_t lineNumber) noexcept
+void RendererSoftware::HandleMatteAndTransparencyDispatchB() noexcept
 {
     const bool booleanB = !bit<3>(m_transparencyControl[B]);
     const uint8_t controlB = bits<0, 2>(m_transparencyControl[B]);
@@ -299,53 +304,53 @@ void RendererSoftware::HandleMatteAndTransparencyDispatchB(const uint16_t lineNu
     {
     case TransparentIf::AlwaysNever: // Always/Never.
         if(booleanB)
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::AlwaysNever, true>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::AlwaysNever, true>();
         else
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::AlwaysNever, false>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::AlwaysNever, false>();
         break;
 
     case TransparentIf::ColorKey: // Color Key.
         if(booleanB)
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::ColorKey, true>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::ColorKey, true>();
         else
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::ColorKey, false>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::ColorKey, false>();
         break;
 
     case TransparentIf::TransparencyBit: // Transparent Bit.
         // TODO: currently decodeRGB555 make the pixel visible if the bit is set.
         // TODO: disable if not RGB555.
         if(booleanB)
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::TransparencyBit, true>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::TransparencyBit, true>();
         else
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::TransparencyBit, false>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::TransparencyBit, false>();
         break;
 
     case TransparentIf::MatteFlag0: // Matte Flag 0.
         if(booleanB)
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag0, true>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag0, true>();
         else
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag0, false>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag0, false>();
         break;
 
     case TransparentIf::MatteFlag1: // Matte Flag 1.
         if(booleanB)
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag1, true>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag1, true>();
         else
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag1, false>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag1, false>();
         break;
 
     case TransparentIf::MatteFlag0OrColorKey: // Matte Flag 0 or Color Key.
         if(booleanB)
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag0OrColorKey, true>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag0OrColorKey, true>();
         else
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag0OrColorKey, false>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag0OrColorKey, false>();
         break;
 
     case TransparentIf::MatteFlag1OrColorKey: // Matte Flag 1 or Color Key.
         if(booleanB)
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag1OrColorKey, true>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag1OrColorKey, true>();
         else
-            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag1OrColorKey, false>(lineNumber);
+            HandleMatteAndTransparencyLoop<TRANSPARENCY_A, FLAG_A, TransparentIf::MatteFlag1OrColorKey, false>();
         break;
 
     default: // Reserved.
@@ -356,31 +361,18 @@ void RendererSoftware::HandleMatteAndTransparencyDispatchB(const uint16_t lineNu
 
 /** \brief Actually handles matte and transparency for both planes statically. */
 template<Renderer::TransparentIf TRANSPARENCY_A, bool FLAG_A, Renderer::TransparentIf TRANSPARENCY_B, bool FLAG_B>
-void RendererSoftware::HandleMatteAndTransparencyLoop(const uint16_t lineNumber) noexcept
+void RendererSoftware::HandleMatteAndTransparencyLoop() noexcept
 {
-    if(!m_matteNumber) // One matte.
-    {
-        const bool matte = matteMF(m_matteControl[0]);
-        m_nextMatte[matte] = 0;
-        m_nextMatte[!matte] = m_matteControl.size();
-    }
-    else // Two mattes.
-    {
-        m_nextMatte[A] = 0;
-        m_nextMatte[B] = MATTE_HALF;
-    }
-
-    Pixel* planeA = m_plane[A].GetLinePointer(lineNumber);
-    Pixel* planeB = m_plane[B].GetLinePointer(lineNumber);
+    Pixel* planeA = GetPlaneLine(A);
+    Pixel* planeB = GetPlaneLine(B);
 
-    for(uint16_t i = 0; i < m_plane[A].m_width; ++i) // Plane B has the same width.
+    for(const MatteSpan& span : GetMatteSpans())
     {
-        HandleMatte<A>(i);
-        HandleMatte<B>(i);
-        m_icfLine[A][i] = m_icf[A];
-        m_icfLine[B][i] = m_icf[B];
-        HandleTransparency<A, TRANSPARENCY_A, FLAG_A>(*planeA++);
-        HandleTransparency<B, TRANSPARENCY_B, FLAG_B>(*planeB++);
+        for(uint16_t i = span.begin; i < span.end; ++i) // Plane B has the same width.
+        {
+            HandleTransparency<A, TRANSPARENCY_A, FLAG_A>(planeA[i], span.matteFlags);
+            HandleTransparency<B, TRANSPARENCY_B, FLAG_B>(planeB[i], span.matteFlags);
+        }
     }
 }
 
@@ -389,10 +381,11 @@ void RendererSoftware::HandleMatteAndTransparencyLoop(const uint16_t lineNumber)
  * \tparam TRANSPARENT The low 3-bits of the transparency instruction.
  * \tparam BOOL_FLAG True if bit 3 is 0, false if bit 3 is 1.
  * \param pixel The ARGB pixel.
+ * \param matteFlags The matte flags of the span containing the pixel.
  * TODO: do not compute colorKey if not CLUT.
  */
 template<ImagePlane PLANE, Renderer::TransparentIf TRANSPARENT, bool BOOL_FLAG>
-constexpr void RendererSoftware::HandleTransparency(Pixel& pixel) noexcept
+constexpr void RendererSoftware::HandleTransparency(Pixel& pixel, const std::array<bool, 2>& matteFlags) noexcept
 {
     uint32_t color = static_cast<uint32_t>(pixel) & 0x00'FF'FF'FF;
     color = clutColorKey(color | m_maskColorRgb[PLANE]);
@@ -419,22 +412,22 @@ constexpr void RendererSoftware::HandleTransparency(Pixel& pixel) noexcept
         break;
 
     case TransparentIf::MatteFlag0: // Matte Flag 0.
-        if(m_matteFlags[A] == BOOL_FLAG)
+        if(matteFlags[A] == BOOL_FLAG)
             pixel.a = PIXEL_TRANSPARENT;
         break;
 
     case TransparentIf::MatteFlag1: // Matte Flag 1.
-        if(m_matteFlags[B] == BOOL_FLAG)
+        if(matteFlags[B] == BOOL_FLAG)
             pixel.a = PIXEL_TRANSPARENT;
         break;
 
     case TransparentIf::MatteFlag0OrColorKey: // Matte Flag 0 or Color Key.
-        if(m_matteFlags[A] == BOOL_FLAG || colorKey == BOOL_FLAG)
+        if(matteFlags[A] == BOOL_FLAG || colorKey == BOOL_FLAG)
             pixel.a = PIXEL_TRANSPARENT;
         break;
 
     case TransparentIf::MatteFlag1OrColorKey: // Matte Flag 1 or Color Key.
-        if(m_matteFlags[B] == BOOL_FLAG || colorKey == BOOL_FLAG)
+        if(matteFlags[B] == BOOL_FLAG || colorKey == BOOL_FLAG)
             pixel.a = PIXEL_TRANSPARENT;
         break;
 
@@ -444,79 +437,4 @@ constexpr void RendererSoftware::HandleTransparency(Pixel& pixel) noexcept
     }
 }
 
-/** \brief Handles the matte flags for the given plane at the given pixel position.
- * \param pos The current pixel position (in double resolution).
- */
-template<ImagePlane PLANE>
-void RendererSoftware::HandleMatte(uint16_t pos) noexcept
-{
-    if(!m_matteNumber) // One matte.
-    {
-        if(m_nextMatte[PLANE] >= m_matteControl.size())
-            return;
-    }
-    else // Two mattes.
-    {
-        if constexpr(PLANE == A)
-        {
-            if(m_nextMatte[A] >= MATTE_HALF)
-                return;
-        }
-        else
-            if(m_nextMatte[B] >= m_matteControl.size())
-                return;
-    }
-
-    const uint32_t command = m_matteControl[m_nextMatte[PLANE]];
-    if(matteXPosition(command) != pos)
-        return;
-
-    ++m_nextMatte[PLANE];
-
-    /* TODO: matte flag index changed should be based on its index. V.5.10.2 note 8 */
-    const uint8_t op = matteOp(command);
-    switch(op)
-    {
-    case 0b0000:
-        m_nextMatte[PLANE] = m_matteControl.size();
-        break;
-
-    case 0b0100:
-        m_icf[A] = matteICF(command);
-        break;
-
-    case 0b0110:
-        m_icf[B] = matteICF(command);
-        break;
-
-    case 0b1000:
-        m_matteFlags[PLANE] = false;
-        break;
-
-    case 0b1001:
-        m_matteFlags[PLANE] = true;
-        break;
-
-    case 0b1100:
-        m_icf[A] = matteICF(command);
-        m_matteFlags[PLANE] = false;
-        break;
-
-    case 0b1101:
-        m_icf[A] = matteICF(command);
-        m_matteFlags[PLANE] = true;
-        break;
-
-    case 0b1110:
-        m_icf[B] = matteICF(command);
-        m_matteFlags[PLANE] = false;
-        break;
-
-    case 0b1111:
-        m_icf[B] = matteICF(command);
-        m_matteFlags[PLANE] = true;
-        break;
-    }
-}
-
 } // namespace Video
@@ -21,20 +21,17 @@ public:
     uint16_t DrawLinePlane(const uint8_t* lineMain, const uint8_t* lineA) noexcept;
     template<bool MIX, bool PLANE_ORDER> void OverlayMix() noexcept;
 
-    void HandleMatteAndTransparency(uint16_t lineNumber) noexcept;
+    void HandleMatteAndTransparency() noexcept;
     template<TransparentIf TRANSPARENCY_A, bool FLAG_A>
-    void HandleMatteAndTransparencyDispatchB(uint16_t lineNumber) noexcept;
+    void HandleMatteAndTransparencyDispatchB() noexcept;
     template<TransparentIf TRANSPARENCY_A, bool FLAG_A, TransparentIf TRANSPARENCY_B, bool FLAG_B>
-    void HandleMatteAndTransparencyLoop(uint16_t lineNumber) noexcept;
+    void HandleMatteAndTransparencyLoop() noexcept;
     template<ImagePlane PLANE, TransparentIf TRANSPARENT, bool BOOL_FLAG>
-    constexpr void HandleTransparency(Pixel& pixel) noexcept;
+    constexpr void HandleTransparency(Pixel& pixel, const std::array<bool, 2>& matteFlags) noexcept;
 
     // Image Contribution Factor.
-    std::array<std::array<uint8_t, Plane::MAX_WIDTH>, 2> m_icfLine{}; /**< ICF for the whole line. */
-
-    // Matte (Region of the MCD212).
-    std::array<uint8_t, 2> m_nextMatte{};
-    template<ImagePlane PLANE> void HandleMatte(uint16_t pos) noexcept;
+    std::array<uint32_t, Plane::MAX_WIDTH> m_icfFront{}; /**< Front plane line after ICF. */
+    std::array<uint32_t, Plane::MAX_WIDTH> m_icfBack{}; /**< Back plane line after ICF. */
 };
 
 } // namespace Video
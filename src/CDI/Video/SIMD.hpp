@@ -6,6 +6,7 @@
 #define CDI_VIDEO_SIMD_HPP
 
 #include "Pixel.hpp"
+#include "SIMDDispatch.hpp"
 
 #if __has_include(<simd>)
 // #   include <simd>
@@ -17,9 +18,22 @@
 // #    error Missing <simd> or <experimental/simd> headers
 // #endif
 
+/** \brief The SIMDTarget the current translation unit is compiled for, set by the build system. */
+#ifndef LIBCEDIMU_SIMD_TARGET
+#define LIBCEDIMU_SIMD_TARGET Default
+#endif
+
 namespace Video
 {
 
+// The native SIMD width depends on the compiler flags, so keep each instruction set in its own namespace, along with
+// the helpers of the SIMD sources. The inline code they share with the library is kept private to each instruction set
+// by the build system (see Video/CMakeLists.txt).
+inline namespace LIBCEDIMU_SIMD_TARGET
+{
+
+inline constexpr SIMDTarget CURRENT_SIMD_TARGET = SIMDTarget::LIBCEDIMU_SIMD_TARGET;
+
 #if __has_include(<simd>)
 #   warning not yet implemented with <simd> header, using <experimental/simd> instead
 #endif
@@ -49,6 +63,8 @@ template<size_t WIDTH>
 struct SIMDReminder : std::integral_constant<size_t, WIDTH % SIMD_SIZE>
 {};
 
+} // inline namespace LIBCEDIMU_SIMD_TARGET
+
 } // namespace Video
 
 #endif // CDI_VIDEO_SIMD_HPP
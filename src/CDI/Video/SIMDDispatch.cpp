@@ -0,0 +1,147 @@
+/** \file SIMDDispatch.cpp
+ * \brief Selects the instruction set of the SIMD code at runtime.
+ *
+ * This file must be compiled with the baseline instruction set of the library, as it runs before knowing what the
+ * CPU supports.
+ */
+
+#include "SIMDDispatch.hpp"
+#include "RendererSIMD.hpp"
+#include "VideoDecodersSIMD.hpp"
+
+namespace Video
+{
+
+static SIMDTarget detectSIMDTarget() noexcept
+{
+#if defined(LIBCEDIMU_SIMD_DISPATCH) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("bmi2"))
+        return SIMDTarget::AVX2;
+
+    if(__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+        return SIMDTarget::SSE42;
+#endif // LIBCEDIMU_SIMD_DISPATCH
+
+    return SIMDTarget::Default;
+}
+
+/** \brief Returns the widest SIMD target supported by both the CPU and the library.
+ *
+ * The CPU is only queried on the first call.
+ */
+SIMDTarget getSIMDTarget() noexcept
+{
+    static const SIMDTarget target = detectSIMDTarget();
+    return target;
+}
+
+/** \brief Returns the display name of the given SIMD target. */
+std::string_view getSIMDTargetName(const SIMDTarget target) noexcept
+{
+    switch(target)
+    {
+    case SIMDTarget::Default: return "Default";
+    case SIMDTarget::SSE42:   return "SSE4.2";
+    case SIMDTarget::AVX2:    return "AVX2";
+    }
+
+    return "Unknown";
+}
+
+/** \brief Creates a SIMD renderer using the instruction set selected at runtime. */
+std::unique_ptr<Renderer> makeRendererSIMD()
+{
+    return makeRendererSIMD(getSIMDTarget());
+}
+
+/** \brief Creates a SIMD renderer using the given instruction set.
+ * \param target The instruction set, it must be supported by the CPU (not above \ref getSIMDTarget).
+ *
+ * Allows to compare the instruction sets with each other. Without LIBCEDIMU_SIMD_DISPATCH, the renderer always uses
+ * the Default one.
+ */
+std::unique_ptr<Renderer> makeRendererSIMD(const SIMDTarget target)
+{
+    return dispatchSIMD(target, [] (auto simdTarget) -> std::unique_ptr<Renderer> {
+        return std::make_unique<RendererSIMDTarget<decltype(simdTarget)::value>>();
+    });
+}
+
+/** \brief Decode a bitmap file line to double resolution ARGB, using the instruction set selected at runtime.
+ * See the target-specific overload for the parameters.
+ */
+template<uint16_t WIDTH>
+uint16_t decodeBitmapLineSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept
+{
+    return dispatchSIMD([=] (auto target) {
+        return decodeBitmapLineSIMD<decltype(target)::value, WIDTH>(dst, dataA, dataB, CLUTTable, initialDYUV, icm);
+    });
+}
+template uint16_t decodeBitmapLineSIMD<360>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+template uint16_t decodeBitmapLineSIMD<384>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+template uint16_t decodeBitmapLineSIMD<720>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+template uint16_t decodeBitmapLineSIMD<768>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+
+/** \brief Decode a RGB555 line to ARGB, using the instruction set selected at runtime.
+ * See the target-specific overload for the parameters.
+ */
+template<uint16_t WIDTH>
+uint16_t decodeRGB555LineSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept
+{
+    return dispatchSIMD([=] (auto target) {
+        return decodeRGB555LineSIMD<decltype(target)::value, WIDTH>(dst, dataA, dataB);
+    });
+}
+template uint16_t decodeRGB555LineSIMD<360>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept;
+template uint16_t decodeRGB555LineSIMD<384>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept;
+
+/** \brief Decode a DYUV line to ARGB, using the instruction set selected at runtime.
+ * See the target-specific overload for the parameters.
+ */
+template<uint16_t WIDTH>
+uint16_t decodeDYUVLineSIMD(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept
+{
+    return dispatchSIMD([=] (auto target) {
+        return decodeDYUVLineSIMD<decltype(target)::value, WIDTH>(dst, dyuv, initialDYUV);
+    });
+}
+template uint16_t decodeDYUVLineSIMD<360>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+template uint16_t decodeDYUVLineSIMD<384>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+template uint16_t decodeDYUVLineSIMD<720>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+template uint16_t decodeDYUVLineSIMD<768>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+
+/** \brief Decode a CLUT line to ARGB, using the instruction set selected at runtime.
+ * See the target-specific overload for the parameters.
+ */
+template<uint16_t WIDTH>
+uint16_t decodeCLUTLineSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept
+{
+    return dispatchSIMD([=] (auto target) {
+        return decodeCLUTLineSIMD<decltype(target)::value, WIDTH>(dst, data, CLUTTable, icm);
+    });
+}
+template uint16_t decodeCLUTLineSIMD<360>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+template uint16_t decodeCLUTLineSIMD<384>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+template uint16_t decodeCLUTLineSIMD<720>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+template uint16_t decodeCLUTLineSIMD<768>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+
+/** \brief Decode a Run-length file line, using the instruction set selected at runtime.
+ * See the target-specific overload for the parameters.
+ */
+template<uint16_t WIDTH, bool RL3>
+uint16_t decodeRunLengthLineSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept
+{
+    return dispatchSIMD([=] (auto target) {
+        return decodeRunLengthLineSIMD<decltype(target)::value, WIDTH, RL3>(dst, data, CLUTTable);
+    });
+}
+template uint16_t decodeRunLengthLineSIMD<360, false>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<384, false>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<720, false>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<768, false>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<720, true>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<768, true>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+
+} // namespace Video
@@ -0,0 +1,80 @@
+/** \file SIMDDispatch.hpp
+ * \brief Runtime selection of the instruction set used by the SIMD renderer and decoders.
+ */
+
+#ifndef CDI_VIDEO_SIMDDISPATCH_HPP
+#define CDI_VIDEO_SIMDDISPATCH_HPP
+
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/** \brief Keeps the entry points of the per-ISA objects visible, the rest of these objects is made local to them
+ * (see Video/CMakeLists.txt).
+ */
+#ifdef LIBCEDIMU_SIMD_DISPATCH
+#   define LIBCEDIMU_SIMD_ENTRY [[gnu::visibility("default")]]
+#else
+#   define LIBCEDIMU_SIMD_ENTRY
+#endif
+
+namespace Video
+{
+
+/** \brief The instruction sets the SIMD code can be compiled for.
+ *
+ * Default is the instruction set the library is compiled with. The other ones are only available when the library
+ * is built with LIBCEDIMU_SIMD_DISPATCH.
+ */
+enum class SIMDTarget
+{
+    Default,
+    SSE42,
+    AVX2,
+};
+
+SIMDTarget getSIMDTarget() noexcept;
+std::string_view getSIMDTargetName(SIMDTarget target) noexcept;
+
+/** \brief Calls \p function with the given SIMD target, as a std::integral_constant.
+ * \param target The instruction set to use, it must be supported by the CPU (not above \ref getSIMDTarget).
+ * \param function The function to call, usually a generic lambda that uses `decltype(target)::value`.
+ * \return The result of \p function.
+ *
+ * Without LIBCEDIMU_SIMD_DISPATCH, \p function is always called with the Default target.
+ */
+template<typename FUNC>
+decltype(auto) dispatchSIMD(const SIMDTarget target, FUNC&& function)
+{
+#ifdef LIBCEDIMU_SIMD_DISPATCH
+    switch(target)
+    {
+    case SIMDTarget::AVX2:
+        return function(std::integral_constant<SIMDTarget, SIMDTarget::AVX2>{});
+
+    case SIMDTarget::SSE42:
+        return function(std::integral_constant<SIMDTarget, SIMDTarget::SSE42>{});
+
+    case SIMDTarget::Default:
+        break;
+    }
+#else
+    static_cast<void>(target);
+#endif // LIBCEDIMU_SIMD_DISPATCH
+
+    return function(std::integral_constant<SIMDTarget, SIMDTarget::Default>{});
+}
+
+/** \brief Calls \p function with the SIMD target selected at runtime, as a std::integral_constant.
+ * \param function The function to call, usually a generic lambda that uses `decltype(target)::value`.
+ * \return The result of \p function.
+ */
+template<typename FUNC>
+decltype(auto) dispatchSIMD(FUNC&& function)
+{
+    return dispatchSIMD(getSIMDTarget(), std::forward<FUNC>(function));
+}
+
+} // namespace Video
+
+#endif // CDI_VIDEO_SIMDDISPATCH_HPP
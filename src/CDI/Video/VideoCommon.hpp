@@ -31,6 +31,14 @@ enum class ImageCodingMethod
     CLUT4,
 };
 
+/** \brief The renderer implementations that can be selected at runtime. */
+enum class RendererBackend
+{
+    Software,
+    SIMD, /**< Uses Software if the library is built without LIBCEDIMU_ENABLE_RENDERERSIMD. */
+    Null, /**< Headless mode: only computes the number of bytes read by each line, does not produce any pixel. */
+};
+
 enum class ControlArea
 {
     ICA1,
@@ -189,7 +189,7 @@ uint16_t decodeRunLengthLine(Pixel* dst, const uint8_t* data, const uint32_t* CL
             if(bit<7>(format)) // run of pixels pairs
             {
                 count = data[index++];
-                if(count == 0)
+                if(count == 0 || count > (WIDTH - x) >> 1) // A run never goes beyond the end of the line.
                     count = (WIDTH - x) >> 1; // This is count in pixel pair, so half the width.
             }
 
@@ -217,7 +217,7 @@ uint16_t decodeRunLengthLine(Pixel* dst, const uint8_t* data, const uint32_t* CL
             if(bit<7>(format)) // run of single pixels
             {
                 count = data[index++];
-                if(count == 0)
+                if(count == 0 || count > WIDTH - x) // A run never goes beyond the end of the line.
                     count = WIDTH - x;
             }
             x += count;
@@ -276,6 +276,48 @@ uint16_t decodeRunLengthLine(Pixel* dst, const uint8_t* data, uint16_t width, co
             return decodeRunLengthLine<384, false>(dst, data, CLUTTable);
 }
 
+/** \brief Returns the number of bytes a Run-length line reads, without decoding it.
+ * \tparam WIDTH The number of input pixels (must match \p RL3).
+ * \tparam RL3 true when RL3 encoding is used, false for RL7.
+ * \param data The raw input data.
+ * \return The number of raw bytes that \ref decodeRunLengthLine would read from data.
+ */
+template<uint16_t WIDTH, bool RL3>
+uint16_t getRunLengthLineSize(const uint8_t* data) noexcept
+{
+    uint16_t index = 0;
+
+    for(int x = 0; x < WIDTH;)
+    {
+        const uint8_t format = data[index++];
+
+        int count = 1;
+        if(bit<7>(format))
+        {
+            count = data[index++];
+            if(count == 0)
+                count = RL3 ? (WIDTH - x) >> 1 : WIDTH - x;
+        }
+
+        if constexpr(RL3) // Count is in pixel pairs.
+            x += count > 1 ? count << 1 : 2;
+        else
+            x += count;
+    }
+
+    return index;
+}
+template uint16_t getRunLengthLineSize<360, false>(const uint8_t* data) noexcept;
+template uint16_t getRunLengthLineSize<384, false>(const uint8_t* data) noexcept;
+template uint16_t getRunLengthLineSize<720, false>(const uint8_t* data) noexcept;
+template uint16_t getRunLengthLineSize<768, false>(const uint8_t* data) noexcept;
+template uint16_t getRunLengthLineSize<720, true>(const uint8_t* data) noexcept;
+template uint16_t getRunLengthLineSize<768, true>(const uint8_t* data) noexcept;
+template<> uint16_t getRunLengthLineSize<360, true>(const uint8_t* data) noexcept
+    = delete; // ("RL3 source width is never normal resolution");
+template<> uint16_t getRunLengthLineSize<384, true>(const uint8_t* data) noexcept
+    = delete; // ("RL3 source width is never normal resolution");
+
 /** \brief Decode a RGB555 line to ARGB using U32.
  * \tparam WIDTH The number of source pixels to decode.
  * \param dst Where the ARGB data will be written to.
@@ -377,28 +419,33 @@ template uint16_t decodeDYUVLine<384>(Pixel* dst, const uint8_t* data, uint32_t
 template uint16_t decodeDYUVLine<720>(Pixel* dst, const uint8_t* data, uint32_t initialDYUV) noexcept;
 template uint16_t decodeDYUVLine<768>(Pixel* dst, const uint8_t* data, uint32_t initialDYUV) noexcept;
 
-#define DYUV_PIXEL_INDEX(Y, U, V) (as<uint32_t>(Y) << 16 | as<uint32_t>(U) << 8 | V)
+/** \brief Offset of the Y value in \ref dyuvClampLUT, so the negative results of the matrixing can be indexed. */
+static constexpr int DYUV_CLAMP_OFFSET = 256;
 
-static std::vector<Pixel> generateDYUVPixelLUT() noexcept
+static constexpr std::array<uint8_t, 768> generateDYUVClampLUT() noexcept
 {
-    std::vector<Pixel> array{};
-    array.resize(256 * 256 * 256);
-
-    for(int y = 0; y < 256; ++y)
-        for(int u = 0; u < 256; ++u)
-            for(int v = 0; v < 256; ++v)
-            {
-                Pixel pixel{0};
-                pixel.r = limu8(y + matrixVToR[v]);
-                pixel.g = limu8(y - (matrixUToG[u] + matrixVToG[v]));
-                pixel.b = limu8(y + matrixUToB[u]);
-                array[DYUV_PIXEL_INDEX(y, u, v)] = pixel;
-            }
+    std::array<uint8_t, 768> array{};
+    for(int i = 0; i < 768; ++i)
+        array[i] = limu8(i - DYUV_CLAMP_OFFSET);
     return array;
 }
 
-/** \brief LUT to convert the YUV values to RGB. Use #DYUV_PIXEL_INDEX macro to index this array. */
-static const std::vector<Pixel> dyuvPixelLUT = generateDYUVPixelLUT();
+/** \brief LUT that limits the result of the matrixing to the uint8_t range. Index it with `value + DYUV_CLAMP_OFFSET`. */
+static constexpr std::array<uint8_t, 768> dyuvClampLUT = generateDYUVClampLUT();
+static_assert(-DYUV_CLAMP_OFFSET <= matrixUToB[0] && 255 + matrixUToB[255] < dyuvClampLUT.size() - DYUV_CLAMP_OFFSET);
+static_assert(-DYUV_CLAMP_OFFSET <= matrixVToR[0] && 255 + matrixVToR[255] < dyuvClampLUT.size() - DYUV_CLAMP_OFFSET);
+static_assert(-DYUV_CLAMP_OFFSET <= -(matrixUToG[255] + matrixVToG[255]));
+static_assert(255 - (matrixUToG[0] + matrixVToG[0]) < dyuvClampLUT.size() - DYUV_CLAMP_OFFSET);
+
+/** \brief Converts a YUV pixel to ARGB using the matrix and clamp LUTs (alpha channel is 0). */
+static constexpr Pixel matrixRGBLUT(const int Y, const uint8_t U, const uint8_t V) noexcept
+{
+    return Pixel{0,
+        dyuvClampLUT[Y + matrixVToR[V] + DYUV_CLAMP_OFFSET],
+        dyuvClampLUT[Y - (matrixUToG[U] + matrixVToG[V]) + DYUV_CLAMP_OFFSET],
+        dyuvClampLUT[Y + matrixUToB[U] + DYUV_CLAMP_OFFSET],
+    };
+}
 
 /** \brief Decode a DYUV line to ARGB using a LUT.
  * \tparam WIDTH The number of source pixels to decode.
@@ -408,7 +455,8 @@ static const std::vector<Pixel> dyuvPixelLUT = generateDYUVPixelLUT();
  * \return The number of raw bytes read from \p dyuv.
  *
  * This is not a SIMD decoder because each pixel depends on the decoded value of the previous one.
- * However this is another approach that uses a pixel LUT to remove as much calculations as possible.
+ * However this is another approach that uses the matrix LUTs and a clamp LUT to remove as much calculations and
+ * branches as possible, while keeping the tables small enough to stay in the L1 cache.
  */
 template<uint16_t WIDTH>
 uint16_t decodeDYUVLineLUT(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept
@@ -441,14 +489,14 @@ uint16_t decodeDYUVLineLUT(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV
         pv = v2;
 
         Pixel* pixel1 = dst++;
-        *pixel1 = dyuvPixelLUT[DYUV_PIXEL_INDEX(y1, u1, v1)]; // Matrix RGB.
+        *pixel1 = matrixRGBLUT(y1, u1, v1);
         if constexpr(WIDTH == 360 || WIDTH == 384)
         {
             memcpy(dst++, pixel1, sizeof(Pixel));
         }
 
         Pixel* pixel2 = dst++;
-        *pixel2 = dyuvPixelLUT[DYUV_PIXEL_INDEX(y2, u2, v2)]; // Matrix RGB.
+        *pixel2 = matrixRGBLUT(y2, u2, v2);
         if constexpr(WIDTH == 360 || WIDTH == 384)
         {
             memcpy(dst++, pixel2, sizeof(Pixel));
@@ -26,6 +26,20 @@ uint16_t decodeDYUVLineLUT(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV
 template<uint16_t WIDTH>
 uint16_t decodeCLUTLine(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
 
+// Line sizes, to know how many bytes a line reads without decoding it.
+template<uint16_t WIDTH, bool RL3>
+uint16_t getRunLengthLineSize(const uint8_t* data) noexcept;
+
+/** \brief Returns the number of bytes read by \ref decodeBitmapLine for the given coding method.
+ * \tparam WIDTH The number of input pixels to decode.
+ * \param icm The coding method of the line.
+ */
+template<uint16_t WIDTH>
+constexpr uint16_t getBitmapLineSize(const ImageCodingMethod icm) noexcept
+{
+    return icm == ImageCodingMethod::CLUT4 ? WIDTH >> 1 : WIDTH;
+}
+
 /** \brief Convert CLUT color to ARGB.
  *
  * \param pixel The CLUT address (must be in the lower bits).
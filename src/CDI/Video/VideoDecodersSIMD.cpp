@@ -30,18 +30,17 @@ namespace Video
  * \warning The pixels are always decoded to double resolution (720 or 768 pixels), no matter the source width.
  * When the source width is normal resolution, the pixels are simply duplicated.
  */
-template<uint16_t WIDTH>
+template<SIMDTarget TARGET, uint16_t WIDTH>
 uint16_t decodeBitmapLineSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept
 {
     if(icm == ImageCodingMethod::DYUV)
-        // return decodeDYUVLineSIMD<WIDTH>(dst, dataB, initialDYUV);
-        return decodeDYUVLineLUT<WIDTH>(dst, dataB, initialDYUV);
+        return decodeDYUVLineSIMD<TARGET, WIDTH>(dst, dataB, initialDYUV);
 
     if(icm == ImageCodingMethod::RGB555)
     {
         if constexpr(WIDTH == 360 || WIDTH == 384)
         {
-            return decodeRGB555LineSIMD<WIDTH>(dst, dataA, dataB);
+            return decodeRGB555LineSIMD<TARGET, WIDTH>(dst, dataA, dataB);
         }
         else
         {
@@ -49,61 +48,162 @@ uint16_t decodeBitmapLineSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* d
         }
     }
 
-    return decodeCLUTLine<WIDTH>(dst, dataB, CLUTTable, icm);
+    return decodeCLUTLineSIMD<TARGET, WIDTH>(dst, dataB, CLUTTable, icm);
 }
-template uint16_t decodeBitmapLineSIMD<360>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
-template uint16_t decodeBitmapLineSIMD<384>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
-template uint16_t decodeBitmapLineSIMD<720>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
-template uint16_t decodeBitmapLineSIMD<768>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+template uint16_t decodeBitmapLineSIMD<CURRENT_SIMD_TARGET, 360>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+template uint16_t decodeBitmapLineSIMD<CURRENT_SIMD_TARGET, 384>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+template uint16_t decodeBitmapLineSIMD<CURRENT_SIMD_TARGET, 720>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+template uint16_t decodeBitmapLineSIMD<CURRENT_SIMD_TARGET, 768>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+
+inline namespace LIBCEDIMU_SIMD_TARGET
+{
+
+/** \brief Decodes `SIMD::size()` RGB555 pixels, duplicated (normal resolution). */
+template<typename SIMD>
+static inline void decodeRGB555PixelsSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept
+{
+    using SIMDFixedU8 = stdx::fixed_size_simd<uint8_t, SIMD::size()>;
+    using SIMDFixedU64 = stdx::rebind_simd_t<uint64_t, SIMD>;
+
+    const SIMD a = stdx::static_simd_cast<SIMD>(SIMDFixedU8{dataA, stdx::element_aligned});
+    const SIMD b = stdx::static_simd_cast<SIMD>(SIMDFixedU8{dataB, stdx::element_aligned});
+    const SIMD data = a << 8 | b;
+
+    SIMD result32 = (data & 0x8000) << 16;
+    result32 |= data << 9 & 0x00F8'0000;
+    result32 |= data << 6 & 0x0000'F800;
+    result32 |= data << 3 & 0x0000'00F8;
+
+    // Duplicate the pixels.
+    SIMDFixedU64 result64 = stdx::static_simd_cast<SIMDFixedU64>(result32);
+    result64 |= result64 << 32;
+    result64.copy_to(reinterpret_cast<uint64_t*>(dst->AsU32Pointer()), stdx::element_aligned);
+}
+
+} // inline namespace LIBCEDIMU_SIMD_TARGET
 
 /** \brief Decode a RGB555 line to ARGB using SIMD.
- * \tparam WIDTH The number or source pixels to decode.
  * \param dst Where the ARGB data will be written to.
  * \param dataA The plane A data (high order byte of the pixel).
  * \param dataB The plane B data (low order byte of the pixel).
  * \return The number of raw bytes read from each data source.
- * \attention \p dst, \p dataA and \p dataB are written/read in chunks of std::simd::size(). Make sure the buffers can be read and written beyond the actual line length.
+ *
  * The transparency bit is set in the alpha byte (0x80 when the bit is 1, 0 otherwise).
+ * The pixels that do not fill a whole native SIMD are decoded with a smaller fixed-size SIMD, so nothing is read or
+ * written past the line.
  */
-template<uint16_t WIDTH>
+template<SIMDTarget TARGET, uint16_t WIDTH>
 uint16_t decodeRGB555LineSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept
 {
-    // TODO: ensure we do not index out of bound.
-    using SIMDFixedU32 = stdx::rebind_simd_t<uint32_t, SIMDNativeU8>;
-    using SIMDFixedU64 = stdx::rebind_simd_t<uint64_t, SIMDFixedU32>;
+    static_assert(WIDTH == 360 || WIDTH == 384, "RGB555 is only usable in normal resolution");
+
+    constexpr size_t WIDTH_REM = SIMDReminder<WIDTH>::value;
+
+    for(const uint8_t* endA = dataA + (WIDTH - WIDTH_REM); dataA < endA; dataA += SIMD_SIZE, dataB += SIMD_SIZE, dst += SIMD_SIZE * 2)
+        decodeRGB555PixelsSIMD<SIMDNativePixel>(dst, dataA, dataB);
+
+    if constexpr(WIDTH_REM != 0)
+        decodeRGB555PixelsSIMD<SIMDFixedPixel<WIDTH_REM>>(dst, dataA, dataB);
+
+    return WIDTH;
+}
+template uint16_t decodeRGB555LineSIMD<CURRENT_SIMD_TARGET, 360>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept;
+template uint16_t decodeRGB555LineSIMD<CURRENT_SIMD_TARGET, 384>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept;
+
+inline namespace LIBCEDIMU_SIMD_TARGET
+{
+
+/** \brief Decodes `SIMD::size()` CLUT pixels, duplicated if \p DUPLICATE is true (normal resolution). */
+template<typename SIMD, bool DUPLICATE>
+static inline void decodeCLUTPixelsSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, const uint8_t colorMask) noexcept
+{
+    using SIMDFixedU8 = stdx::fixed_size_simd<uint8_t, SIMD::size()>;
+    using SIMDFixedU64 = stdx::rebind_simd_t<uint64_t, SIMD>;
 
-    const uint8_t* endA = dataA + WIDTH;
+    const SIMD indices = stdx::static_simd_cast<SIMD>(SIMDFixedU8{data, stdx::element_aligned} & colorMask);
+    const SIMD colors([&] (auto lane) -> Pixel::ARGB32 { return CLUTTable[indices[lane]]; });
 
-    const SIMDFixedU32 alphaMask{0x8000};
-    for(; dataA < endA; dataA += SIMDNativeU8::size(), dataB += SIMDNativeU8::size(), dst += SIMDNativeU8::size() * 2)
+    if constexpr(DUPLICATE)
     {
-        const SIMDNativeU8 da{dataA, stdx::element_aligned};
-        const SIMDNativeU8 db{dataB, stdx::element_aligned};
+        SIMDFixedU64 result = stdx::static_simd_cast<SIMDFixedU64>(colors);
+        result |= result << 32;
+        result.copy_to(reinterpret_cast<uint64_t*>(dst->AsU32Pointer()), stdx::element_aligned);
+    }
+    else
+        colors.copy_to(dst->AsU32Pointer(), stdx::element_aligned);
+}
+
+/** \brief Decodes `SIZE` CLUT4 bytes, each one being 2 pixels. */
+template<size_t SIZE>
+static inline void decodeCLUT4PixelsSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept
+{
+    // The high nibble is the first pixel.
+    const stdx::fixed_size_simd<uint64_t, SIZE> result([&] (auto lane) -> uint64_t {
+        return CLUTTable[data[lane] >> 4] | static_cast<uint64_t>(CLUTTable[data[lane] & 0xF]) << 32;
+    });
+    result.copy_to(reinterpret_cast<uint64_t*>(dst->AsU32Pointer()), stdx::element_aligned);
+}
+
+} // inline namespace LIBCEDIMU_SIMD_TARGET
+
+/** \brief Decode a CLUT line to ARGB using SIMD.
+ * \tparam WIDTH The number of source pixels to decode.
+ * \param dst Where the ARGB data will be written to.
+ * \param data The source CLUT data.
+ * \param CLUTTable The CLUT to use when decoding.
+ * \param icm The coding method (non-CLUT values are ignored and treated as CLUT7).
+ * \return The number of raw bytes read from data.
+ *
+ * If \p icm is ImageCodingMethod::CLUT77 or the video plane is plane B, then sent `&CLUT[128]` as the \p CLUTTable.
+ *
+ * Each output pixel is looked up with a SIMD gather of the CLUT, the source pixels being duplicated in normal
+ * resolution and split into two nibbles in CLUT4. The pixels that do not fill a whole native SIMD are decoded with a
+ * smaller fixed-size SIMD, so nothing is read or written past the line.
+ */
+template<SIMDTarget TARGET, uint16_t WIDTH>
+uint16_t decodeCLUTLineSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept
+{
+    if(icm == ImageCodingMethod::CLUT4)
+    {
+        // CLUT4 is always double/high resolution, each byte contains 2 pixels.
+        if constexpr(WIDTH == 360 || WIDTH == 384)
+        {
+            return decodeCLUTLine<WIDTH>(dst, data, CLUTTable, icm);
+        }
+        else
+        {
+            constexpr size_t BYTES = WIDTH >> 1;
+            const uint8_t* end = data + (BYTES - SIMDReminder<BYTES>::value);
+            for(; data < end; data += SIMD_SIZE, dst += SIMD_SIZE * 2)
+                decodeCLUT4PixelsSIMD<SIMD_SIZE>(dst, data, CLUTTable);
+
+            if constexpr(SIMDReminder<BYTES>::value != 0)
+                decodeCLUT4PixelsSIMD<SIMDReminder<BYTES>::value>(dst, data, CLUTTable);
 
-        const SIMDFixedU32 a = stdx::static_simd_cast<uint32_t>(da);
-        const SIMDFixedU32 b = stdx::static_simd_cast<uint32_t>(db);
-        const SIMDFixedU32 data = a << 8 | b;
+            return BYTES;
+        }
+    }
 
-        SIMDFixedU32 result32 = (data & alphaMask) << 16;
-        result32 |= data << 9 & 0x00F8'0000;
-        result32 |= data << 6 & 0x0000'F800;
-        result32 |= data << 3 & 0x0000'00F8;
+    constexpr bool DUPLICATE = WIDTH == 360 || WIDTH == 384; // Normal resolution duplicates the pixels.
+    constexpr size_t WIDTH_REM = SIMDReminder<WIDTH>::value;
+    const uint8_t colorMask = icm == ImageCodingMethod::CLUT8 ? 0xFF : 0x7F;
 
-        // Duplicate the pixels.
-        SIMDFixedU64 result64 = stdx::static_simd_cast<uint64_t>(result32);
-        result64 |= result64 << 32;
+    for(const uint8_t* end = data + (WIDTH - WIDTH_REM); data < end; data += SIMD_SIZE, dst += DUPLICATE ? SIMD_SIZE * 2 : SIMD_SIZE)
+        decodeCLUTPixelsSIMD<SIMDNativePixel, DUPLICATE>(dst, data, CLUTTable, colorMask);
 
-        // This reinterpret_cast should be safe, as the overlaligned tag should make the write safe.
-        // Also casting to a uint64_t pointer should not affect endianness.
-        result64.copy_to(reinterpret_cast<uint64_t*>(dst->AsU32Pointer()), stdx::overaligned<alignof(Pixel::ARGB32)>);
-    };
+    if constexpr(WIDTH_REM != 0)
+        decodeCLUTPixelsSIMD<SIMDFixedPixel<WIDTH_REM>, DUPLICATE>(dst, data, CLUTTable, colorMask);
 
     return WIDTH;
 }
-template uint16_t decodeRGB555LineSIMD<320>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept;
-template uint16_t decodeRGB555LineSIMD<384>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept;
-template<> uint16_t decodeRGB555LineSIMD<720>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept = delete;
-template<> uint16_t decodeRGB555LineSIMD<768>(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept = delete;
+template uint16_t decodeCLUTLineSIMD<CURRENT_SIMD_TARGET, 360>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+template uint16_t decodeCLUTLineSIMD<CURRENT_SIMD_TARGET, 384>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+template uint16_t decodeCLUTLineSIMD<CURRENT_SIMD_TARGET, 720>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+template uint16_t decodeCLUTLineSIMD<CURRENT_SIMD_TARGET, 768>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+
+// The helpers are in the namespace of the instruction set, see SIMD.hpp.
+inline namespace LIBCEDIMU_SIMD_TARGET
+{
 
 using SIMDNativeI32 = stdx::native_simd<int32_t>;
 using SIMDFixedU64 = stdx::rebind_simd_t<uint64_t, SIMDNativeI32>;
@@ -112,6 +212,8 @@ static_assert(SIZE == SIMD_SIZE);
 static inline constexpr SIMDNativeI32 U8_MIN{0};
 static inline constexpr SIMDNativeI32 U8_MAX{255};
 
+} // inline namespace LIBCEDIMU_SIMD_TARGET
+
 /** \brief Decode a DYUV line to ARGB using SIMD.
  * \tparam WIDTH The number of source pixels to decode.
  * \param dst Where the ARGB data will be written to.
@@ -122,7 +224,7 @@ static inline constexpr SIMDNativeI32 U8_MAX{255};
  * Because each pixel depends on the previous one, the dequantization and UV interpolation must be done sequentially.
  * However the RGB matrixing can be parallel.
  */
-template<uint16_t WIDTH>
+template<SIMDTarget TARGET, uint16_t WIDTH>
 uint16_t decodeDYUVLineSIMD(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept
 {
     std::array<int32_t, WIDTH> y;
@@ -179,16 +281,14 @@ uint16_t decodeDYUVLineSIMD(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYU
         simdU -= 128;
         simdV -= 128;
 
-        // SIMDNativeI32 simdR = ((simdV * 351) >> 8) + simdY;
-        SIMDNativeI32 simdR = ((simdV * 351) / 256) + simdY;
+        // Each term is truncated on its own to match the matrix LUTs of the scalar decoders.
+        SIMDNativeI32 simdR = simdY + (simdV * 351) / 256;
         simdR = stdx::clamp(simdR, U8_MIN, U8_MAX);
 
-        // SIMDNativeI32 simdG = ((simdU * 86) + (simdV * 179) >> 8) + simdY;
-        SIMDNativeI32 simdG = ((simdU * 86) + (simdV * 179) / 256) + simdY;
+        SIMDNativeI32 simdG = simdY - ((simdU * 86) / 256 + (simdV * 179) / 256);
         simdG = stdx::clamp(simdG, U8_MIN, U8_MAX);
 
-        // SIMDNativeI32 simdB = ((simdU * 444) >> 8) + simdY;
-        SIMDNativeI32 simdB = ((simdU * 444) / 256) + simdY;
+        SIMDNativeI32 simdB = simdY + (simdU * 444) / 256;
         simdB = stdx::clamp(simdB, U8_MIN, U8_MAX);
 
         const SIMDNativeI32 result32 = (simdR << 16) | (simdG << 8) | simdB;
@@ -209,9 +309,117 @@ uint16_t decodeDYUVLineSIMD(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYU
 
     return WIDTH;
 }
-template uint16_t decodeDYUVLineSIMD<360>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
-template uint16_t decodeDYUVLineSIMD<384>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
-template uint16_t decodeDYUVLineSIMD<720>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
-template uint16_t decodeDYUVLineSIMD<768>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+template uint16_t decodeDYUVLineSIMD<CURRENT_SIMD_TARGET, 360>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+template uint16_t decodeDYUVLineSIMD<CURRENT_SIMD_TARGET, 384>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+template uint16_t decodeDYUVLineSIMD<CURRENT_SIMD_TARGET, 720>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+template uint16_t decodeDYUVLineSIMD<CURRENT_SIMD_TARGET, 768>(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+
+inline namespace LIBCEDIMU_SIMD_TARGET
+{
+
+/** \brief Writes a run of pixels using SIMD.
+ * \param dst Where the run starts.
+ * \param count The number of pixels in the run, must not go beyond \p end.
+ * \param end The end of the line, nothing is written beyond it.
+ * \param color1 The color of the even pixels of the run.
+ * \param color2 The color of the odd pixels of the run.
+ *
+ * The last store can write beyond the end of the run (but never beyond \p end), these pixels are overwritten by the
+ * next runs.
+ */
+static inline void fillRunSIMD(Pixel* dst, const size_t count, const Pixel* end, const Pixel::ARGB32 color1, const Pixel::ARGB32 color2) noexcept
+{
+    const Pixel* runEnd = dst + count;
+
+    // Short runs are cheaper to write one by one than with overlapping stores.
+    if(count >= SIMD_SIZE)
+    {
+        const SIMDNativePixel pattern([=] (auto i) { return i & 1 ? color2 : color1; });
+        for(; dst < runEnd && end - dst >= static_cast<ptrdiff_t>(SIMD_SIZE); dst += SIMD_SIZE)
+            pattern.copy_to(dst->AsU32Pointer(), stdx::element_aligned);
+    }
+
+    // SIMD_SIZE is even, so the remaining pixels still start with color1.
+    for(size_t i = 0; dst < runEnd; ++dst, ++i)
+        *dst = i & 1 ? color2 : color1;
+}
+
+} // inline namespace LIBCEDIMU_SIMD_TARGET
+
+/** \brief Decode a Run-length file line using SIMD.
+ * \tparam WIDTH The number of input pixels to decode (must match \p RL3).
+ * \tparam RL3 true when RL3 encoding is used, false for RL7.
+ * \param dst Where the decoded line will be written in ARGB.
+ * \param data The raw input data to be decoded.
+ * \param CLUTTable The CLUT table to use.
+ * \return The number of raw bytes read from data.
+ *
+ * The run headers are read sequentially, then each run is written with SIMD stores of its color (or pair of colors
+ * for RL3). The output is the same as \ref decodeRunLengthLine, except that runs are clamped to the end of the line.
+ */
+template<SIMDTarget TARGET, uint16_t WIDTH, bool RL3>
+uint16_t decodeRunLengthLineSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept
+{
+    static_assert(!RL3 || WIDTH == 720 || WIDTH == 768, "RL3 source width is never normal resolution");
+
+    // Normal resolution RL7 duplicates the pixels.
+    constexpr int PIXEL_REPEAT = WIDTH == 360 || WIDTH == 384 ? 2 : 1;
+    const Pixel* end = dst + WIDTH * PIXEL_REPEAT;
+
+    uint16_t index = 0;
+    for(int x = 0; x < WIDTH;)
+    {
+        const uint8_t format = data[index++];
+
+        if constexpr(RL3)
+        {
+            const Pixel::ARGB32 color1 = CLUTTable[bits<4, 6>(format)];
+            const Pixel::ARGB32 color2 = CLUTTable[bits<0, 2>(format)];
+
+            if(!bit<7>(format)) // single pixel pair
+            {
+                dst[x] = color1;
+                dst[x + 1] = color2;
+                x += 2;
+                continue;
+            }
+
+            int count = data[index++] * 2; // in pixels.
+            if(count == 0 || count > WIDTH - x)
+                count = WIDTH - x;
+
+            fillRunSIMD(&dst[x], count, end, color1, color2);
+            x += count;
+        }
+        else
+        {
+            const Pixel::ARGB32 color = CLUTTable[bits<0, 6>(format)];
+
+            if(!bit<7>(format)) // single pixel
+            {
+                if constexpr(PIXEL_REPEAT == 2)
+                    dst[x * 2 + 1] = color;
+                dst[x * PIXEL_REPEAT] = color;
+                x++;
+                continue;
+            }
+
+            int count = data[index++];
+            if(count == 0 || count > WIDTH - x)
+                count = WIDTH - x;
+
+            fillRunSIMD(&dst[x * PIXEL_REPEAT], count * PIXEL_REPEAT, end, color, color);
+            x += count;
+        }
+    }
+
+    return index;
+}
+template uint16_t decodeRunLengthLineSIMD<CURRENT_SIMD_TARGET, 360, false>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<CURRENT_SIMD_TARGET, 384, false>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<CURRENT_SIMD_TARGET, 720, false>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<CURRENT_SIMD_TARGET, 768, false>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<CURRENT_SIMD_TARGET, 720, true>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+template uint16_t decodeRunLengthLineSIMD<CURRENT_SIMD_TARGET, 768, true>(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
 
 } // namespace Video
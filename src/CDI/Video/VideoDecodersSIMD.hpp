@@ -2,6 +2,7 @@
 #define CDI_COMMON_VIDEOSIMD_HPP
 
 #include "common/utils.hpp"
+#include "SIMDDispatch.hpp"
 #include "VideoCommon.hpp"
 
 #include <cstdint>
@@ -10,7 +11,7 @@
 namespace Video
 {
 
-// Display file decoders.
+// Display file decoders, using the instruction set selected at runtime.
 template<uint16_t WIDTH>
 uint16_t decodeBitmapLineSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
 
@@ -20,6 +21,28 @@ uint16_t decodeRGB555LineSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* d
 template<uint16_t WIDTH>
 uint16_t decodeDYUVLineSIMD(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
 
+template<uint16_t WIDTH>
+uint16_t decodeCLUTLineSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+
+template<uint16_t WIDTH, bool RL3>
+uint16_t decodeRunLengthLineSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+
+// Display file decoders for a specific instruction set.
+template<SIMDTarget TARGET, uint16_t WIDTH>
+LIBCEDIMU_SIMD_ENTRY uint16_t decodeBitmapLineSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB, const uint32_t* CLUTTable, uint32_t initialDYUV, ImageCodingMethod icm) noexcept;
+
+template<SIMDTarget TARGET, uint16_t WIDTH>
+LIBCEDIMU_SIMD_ENTRY uint16_t decodeRGB555LineSIMD(Pixel* dst, const uint8_t* dataA, const uint8_t* dataB) noexcept;
+
+template<SIMDTarget TARGET, uint16_t WIDTH>
+LIBCEDIMU_SIMD_ENTRY uint16_t decodeDYUVLineSIMD(Pixel* dst, const uint8_t* dyuv, uint32_t initialDYUV) noexcept;
+
+template<SIMDTarget TARGET, uint16_t WIDTH>
+LIBCEDIMU_SIMD_ENTRY uint16_t decodeCLUTLineSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable, ImageCodingMethod icm) noexcept;
+
+template<SIMDTarget TARGET, uint16_t WIDTH, bool RL3>
+LIBCEDIMU_SIMD_ENTRY uint16_t decodeRunLengthLineSIMD(Pixel* dst, const uint8_t* data, const uint32_t* CLUTTable) noexcept;
+
 } // namespace Video
 
 #endif // CDI_COMMON_VIDEOSIMD_HPP
@@ -6,7 +6,7 @@
 
 Mono3::Mono3(OS9::BIOS bios, std::span<const uint8_t> nvram, CDIConfig config, Callbacks callbacks, CDIDisc disc, std::string_view boardName)
     : CDI(boardName, config, std::move(callbacks), std::move(disc))
-    , m_mcd212(*this, std::move(bios), config.PAL)
+    , m_mcd212(*this, std::move(bios), config.PAL, config.renderer, config.asyncVideo)
     , m_ciap(*this)
     , m_nvramMaxAddress(config.has32KBNVRAM ? 0x330000 : 0x324000)
 {
@@ -77,27 +77,32 @@ RAMBank Mono3::GetRAMBank2() const
     return m_mcd212.GetRAMBank2();
 }
 
-const Video::Plane& Mono3::GetScreen()
+Video::Plane Mono3::GetScreen()
 {
     return m_mcd212.GetScreen();
 }
 
-const Video::Plane& Mono3::GetPlaneA()
+Video::Plane Mono3::GetPlaneA()
 {
     return m_mcd212.GetPlaneA();
 }
 
-const Video::Plane& Mono3::GetPlaneB()
+Video::Plane Mono3::GetPlaneB()
 {
     return m_mcd212.GetPlaneB();
 }
 
-const Video::Plane& Mono3::GetBackground()
+Video::Plane Mono3::GetBackground()
 {
     return m_mcd212.GetBackground();
 }
 
-const Video::Plane& Mono3::GetCursor()
+Video::Plane Mono3::GetCursor()
 {
     return m_mcd212.GetCursor();
 }
+
+void Mono3::SetVDSCPlanesRetained(const bool retained)
+{
+    m_mcd212.SetPlanesRetained(retained);
+}
@@ -38,11 +38,12 @@ public:
 
     virtual std::vector<InternalRegister> GetVDSCInternalRegisters() override;
     virtual std::vector<InternalRegister> GetVDSCControlRegisters() override;
-    virtual const Video::Plane& GetScreen() override;
-    virtual const Video::Plane& GetPlaneA() override;
-    virtual const Video::Plane& GetPlaneB() override;
-    virtual const Video::Plane& GetBackground() override;
-    virtual const Video::Plane& GetCursor() override;
+    virtual Video::Plane GetScreen() override;
+    virtual Video::Plane GetPlaneA() override;
+    virtual Video::Plane GetPlaneB() override;
+    virtual Video::Plane GetBackground() override;
+    virtual Video::Plane GetCursor() override;
+    virtual void SetVDSCPlanesRetained(bool retained) override;
 
 private:
     MCD212 m_mcd212;
@@ -1,6 +1,8 @@
 #include "Audio.hpp"
 #include "utils.hpp"
 
+#include <algorithm>
+#include <array>
 #include <bit>
 
 namespace Audio
@@ -26,7 +28,7 @@ static uint8_t decodeADPCM(SamplesDelay& delay, int8_t sd[][28], uint8_t* ranges
 {
     for(int su = 0; su < SU; su++)
     {
-        const uint16_t gain = 2 << (GAIN - ranges[su]);
+        const uint16_t gain = ranges[su] <= GAIN ? 2 << (GAIN - ranges[su]) : 0; // Higher ranges are reserved.
         for(uint8_t ss = 0; ss < 28; ss++)
         {
             if(stereo && su & 1)
@@ -49,6 +51,150 @@ static uint8_t decodeADPCM(SamplesDelay& delay, int8_t sd[][28], uint8_t* ranges
     return 28 * SU;
 }
 
+/** \brief Applies the k0/k1 filters to sound units whose samples have already been scaled by their gain.
+ * \tparam SU The number of sound units (4 for level A, 8 for level BC).
+ * \param delay The struct that holds the samples delayed for the k0/k1 filters.
+ * \param scaled The scaled samples, sample-major (the sample \p ss of unit \p su is at `ss * SU + su`).
+ * \param filters The filter of each sound unit.
+ * \param stereo true for stereo, false for mono.
+ * \param left Where the left channel samples are written (used in mono).
+ * \param right Where the right channel samples are written (unused in mono).
+ *
+ * The left and right channels are independent, so in stereo both filters run in the same loop.
+ */
+template<size_t SU>
+static void filterSoundUnits(SamplesDelay& delay, const std::array<int, SU * 28>& scaled, const std::array<uint8_t, SU>& filters, const bool stereo, int16_t* left, int16_t* right) noexcept
+{
+    int l0 = delay.lk0;
+    int l1 = delay.lk1;
+
+    if(stereo)
+    {
+        int r0 = delay.rk0;
+        int r1 = delay.rk1;
+        for(size_t su = 0; su < SU; su += 2)
+        {
+            const int lk0 = K0[filters[su]];
+            const int lk1 = K1[filters[su]];
+            const int rk0 = K0[filters[su + 1]];
+            const int rk1 = K1[filters[su + 1]];
+            for(size_t ss = 0; ss < 28; ss++)
+            {
+                const int16_t l = lims16(scaled[ss * SU + su] + (l0 * lk0 + l1 * lk1) / 256);
+                const int16_t r = lims16(scaled[ss * SU + su + 1] + (r0 * rk0 + r1 * rk1) / 256);
+                l1 = l0;
+                l0 = l;
+                r1 = r0;
+                r0 = r;
+                *left++ = l;
+                *right++ = r;
+            }
+        }
+        delay.rk0 = r0;
+        delay.rk1 = r1;
+    }
+    else
+    {
+        for(size_t su = 0; su < SU; su++)
+        {
+            const int k0 = K0[filters[su]];
+            const int k1 = K1[filters[su]];
+            for(size_t ss = 0; ss < 28; ss++)
+            {
+                const int16_t sample = lims16(scaled[ss * SU + su] + (l0 * k0 + l1 * k1) / 256);
+                l1 = l0;
+                l0 = sample;
+                *left++ = sample;
+            }
+        }
+    }
+
+    delay.lk0 = l0;
+    delay.lk1 = l1;
+}
+
+/** \brief Decodes a sound group.
+ * \tparam SU The number of sound units (4 for level A, 8 for level BC).
+ * \param delay The struct that holds the samples delayed for the k0/k1 filters.
+ * \param stereo true for stereo, false for mono.
+ * \param data The 128 bytes of the sound group.
+ * \param left Where the left channel samples are written (used in mono).
+ * \param right Where the right channel samples are written (unused in mono).
+ *
+ * The parameters and the samples of all the sound units are unpacked and scaled in loops without dependencies that
+ * the compiler vectorizes, only the filters are applied sample by sample.
+ */
+template<size_t SU>
+static void decodeSoundGroup(SamplesDelay& delay, const bool stereo, const uint8_t* data, int16_t* left, int16_t* right) noexcept
+{
+    constexpr bool LEVEL_A = SU == 4;
+    constexpr int GAIN = LEVEL_A ? 8 : 12;
+    constexpr size_t PARAMETERS = LEVEL_A ? 0 : 4;
+
+    std::array<int, SU> gains;
+    std::array<uint8_t, SU> filters;
+    for(size_t su = 0; su < SU; su++)
+    {
+        const uint8_t range = bits<0, 3>(data[PARAMETERS + su]);
+        gains[su] = range <= GAIN ? 2 << (GAIN - range) : 0; // Higher ranges are reserved.
+        filters[su] = bits<4, 5>(data[PARAMETERS + su]);
+    }
+
+    std::array<int, SU * 28> scaled;
+    const uint8_t* samples = data + 16;
+    for(size_t ss = 0; ss < 28; ss++)
+    {
+        if constexpr(LEVEL_A)
+        {
+            for(size_t su = 0; su < SU; su++)
+                scaled[ss * SU + su] = static_cast<int8_t>(samples[ss * 4 + su]) * gains[su];
+        }
+        else
+        {
+            for(size_t i = 0; i < 4; i++)
+            {
+                const uint8_t sb = samples[ss * 4 + i];
+                scaled[ss * SU + 2 * i] = (static_cast<int8_t>(sb << 4) >> 4) * gains[2 * i];
+                scaled[ss * SU + 2 * i + 1] = (static_cast<int8_t>(sb) >> 4) * gains[2 * i + 1];
+            }
+        }
+    }
+
+    filterSoundUnits<SU>(delay, scaled, filters, stereo, left, right);
+}
+
+/** \brief Decodes a raw audio sector into 16-bit PCM.
+ * \param delay The struct that holds the samples delayed for the k0/k1 filters.
+ * \param levelA True if input data is encoded in Level A audio, false if Level B or C.
+ * \param stereo True if input data is stereo, false if mono.
+ * \param data Raw input data from the disc.
+ * \param left Destination left audio channel. If audio is mono, it will contain the decoded data.
+ * \param right Destination right audio channel. Unused in mono.
+ * \return The number of samples written in each channel, or 0 if \p left or \p right is too small.
+ *
+ * A Level A sector has \ref LEVEL_A_SECTOR_SAMPLES and a Level B or C one \ref LEVEL_BC_SECTOR_SAMPLES, split between
+ * the two channels in stereo. The samples are the same as with the std::vector overload.
+ */
+size_t decodeAudioSector(SamplesDelay& delay, const bool levelA, const bool stereo, std::span<const uint8_t, SECTOR_DATA_SIZE> data, std::span<int16_t> left, std::span<int16_t> right) noexcept
+{
+    const size_t samples = (levelA ? LEVEL_A_SECTOR_SAMPLES : LEVEL_BC_SECTOR_SAMPLES) / (stereo ? 2 : 1);
+    if(left.size() < samples || (stereo && right.size() < samples))
+        return 0;
+
+    const size_t groupSamples = samples / 18;
+    for(size_t sg = 0; sg < 18; sg++)
+    {
+        int16_t* l = left.data() + sg * groupSamples;
+        int16_t* r = stereo ? right.data() + sg * groupSamples : nullptr;
+        if(levelA)
+            decodeSoundGroup<4>(delay, stereo, &data[128 * sg], l, r);
+        else
+            decodeSoundGroup<8>(delay, stereo, &data[128 * sg], l, r);
+    }
+
+    return samples;
+}
+
 /** \brief Decode a raw audio sector into 16-bit PCM.
  * \param levelA True if input data is encoded in Level A audio, false if Level B or C.
  * \param stereo True if input data is stereo, false if mono.
@@ -56,6 +202,9 @@ static uint8_t decodeADPCM(SamplesDelay& delay, int8_t sd[][28], uint8_t* ranges
  * \param left Destination left audio channel. If audio is mono, it will contain the decoded data and right will remain untouched.
  * \param right Destination right audio channel. If audio is mono, NULL can be passed safely.
  * \return number of samples decoded (should always be 4032).
+ *
+ * This is the sample by sample reference implementation, that appends to the vectors. The std::span overload is
+ * faster and gives the same samples.
  */
 uint16_t decodeAudioSector(SamplesDelay& delay, const bool levelA, const bool stereo, const uint8_t data[2304], std::vector<int16_t>& left, std::vector<int16_t>& right)
 {
@@ -95,7 +244,7 @@ uint8_t decodeLevelASoundGroup(SamplesDelay& delay, const bool stereo, const uin
     for(uint8_t i = 0; i < 4; i++)
     {
         range[i] = bits<0, 3>(data[i]);
-        filter[i] = bits<4, 7>(data[i]);
+        filter[i] = bits<4, 5>(data[i]);
     }
 
     uint8_t index = 16;
@@ -122,7 +271,7 @@ uint8_t decodeLevelBCSoundGroup(SamplesDelay& delay, const bool stereo, const ui
     for(uint16_t i = 0; i < 8; i++)
     {
         range[i] = bits<0, 3>(data[i + 4]);
-        filter[i] = bits<4, 7>(data[i + 4]);
+        filter[i] = bits<4, 5>(data[i + 4]);
     }
 
     uint8_t index = 16;
@@ -156,70 +305,144 @@ static std::string getAudioLevel(const bool bps, const uint32_t fs)
     return "B";
 }
 
-/** \brief Writes the audio data (16 bit signed PCM) in the given file.
+/** \brief Returns the path of the WAV file of an audio record.
  * \param basename The full path including file name of the output file.
- * \param left The left audio channel.
- * \param right The right audio channel.
- * \param channel The channel number of the data to write.
- * \param record The record number of the data to write.
+ * \param channel The channel number of the record.
+ * \param record The record number.
  * \param bps bits per second flag of the coding information byte.
  * \param sf sampling frequency flag of the coding information byte.
- * \param ms mono/stereo flag of the coding information byte.
- *
- * \p left and \p right are cleared after being written.
+ */
+std::string getWAVPath(const std::string& basename, const uint8_t channel, const size_t record, const uint8_t bps, const uint8_t sf)
+{
+    return basename + '_' + std::to_string(channel) + '_' + std::to_string(record) + '_' + getAudioLevel(bps, sf ? 18900 : 37800) + ".wav";
+}
+
+/** \brief Interleaves the samples of the left and right channels.
+ * \param left The left audio channel.
+ * \param right The right audio channel.
+ * \param dst Where the interleaved samples are written, must be twice as large as the channels.
  *
- * Note: This code only works on little-endian archs.
+ * Only the first min(left.size(), right.size(), dst.size() / 2) samples are interleaved.
+ */
+void interleaveSamples(std::span<const int16_t> left, std::span<const int16_t> right, std::span<int16_t> dst) noexcept
+{
+    const size_t size = std::min({left.size(), right.size(), dst.size() / 2});
+    const int16_t* l = left.data();
+    const int16_t* r = right.data();
+    int16_t* d = dst.data();
+
+    // Compilers turn this loop into vector unpack/zip instructions.
+    for(size_t i = 0; i < size; i++)
+    {
+        d[2 * i] = l[i];
+        d[2 * i + 1] = r[i];
+    }
+}
+
+/** \brief Creates the file and writes its header, see \ref Open. */
+WAVWriter::WAVWriter(const std::filesystem::path& path, const WAVHeader header)
+{
+    Open(path, header);
+}
+
+/** \brief Closes the file, see \ref Close. */
+WAVWriter::~WAVWriter() noexcept
+{
+    Close();
+}
+
+/** \brief Creates a WAV file, closing the file previously opened.
+ * \param path The output file.
+ * \param header The channel number (1 or 2) and sampling frequency.
+ * \return true if the file has been created, false otherwise.
  *
- * Writes the WAV header in the file using {wavHeader}, and then writes the audio data.
- * The file is written in little endian format.
- * If {right} is empty, writes only the content of {left} (mono file).
- * If {right} and {left} have different size, writes only the
- * first min(left.size(), right.size()) samples from both audio channels.
+ * The sizes in the header are left to 0 until \ref Close is called.
  */
-void writeWAV(const std::string& basename, std::vector<int16_t>& left, std::vector<int16_t>& right, uint8_t channel, int record, uint8_t bps, uint8_t sf, uint8_t ms)
+bool WAVWriter::Open(const std::filesystem::path& path, const WAVHeader header)
 {
-    static_assert(std::endian::native == std::endian::little, "Requires little-endian target");
+    Close();
+
+    m_out.open(path, std::ios::binary | std::ios::out);
+    if(!m_out.is_open())
+        return false;
+
+    m_header = header;
+    m_dataSize = 0;
+
+    const uint16_t bytePerBloc = m_header.channelNumber * 2;
+    const uint32_t bytePerSec = m_header.frequency * bytePerBloc;
+    const uint32_t size = 0;
+
+    m_out.write("RIFF", 4);
+    m_out.write(reinterpret_cast<const char*>(&size), 4);
+    m_out.write("WAVE", 4);
+    m_out.write("fmt ", 4);
+    m_out.write("\x10\0\0\0", 4);
+    m_out.write("\1\0", 2); // audio format
+
+    m_out.write(reinterpret_cast<const char*>(&m_header.channelNumber), 2);
+    m_out.write(reinterpret_cast<const char*>(&m_header.frequency), 4);
+    m_out.write(reinterpret_cast<const char*>(&bytePerSec), 4);
+    m_out.write(reinterpret_cast<const char*>(&bytePerBloc), 2);
+    m_out.write("\x10\0", 2);
+    m_out.write("data", 4);
+    m_out.write(reinterpret_cast<const char*>(&size), 4);
 
-    const uint16_t channelNumber = ms + 1;
-    const uint32_t frequency = sf ? 18900 : 37800;
+    return m_out.good();
+}
+
+/** \brief Writes the sizes in the header and closes the file.
+ * \return true if the whole file has been written, false otherwise or if no file is opened.
+ */
+bool WAVWriter::Close() noexcept
+{
+    if(!m_out.is_open())
+        return false;
 
-    const uint16_t bytePerBloc = channelNumber * 2;
-    const uint32_t bytePerSec = frequency * bytePerBloc;
-    const uint32_t dataSize = left.size()*2 + right.size()*2;
-    const uint32_t wavSize = 36 + dataSize;
+    const uint32_t wavSize = HEADER_SIZE - 8 + m_dataSize;
+    m_out.seekp(4);
+    m_out.write(reinterpret_cast<const char*>(&wavSize), 4);
+    m_out.seekp(HEADER_SIZE - 4);
+    m_out.write(reinterpret_cast<const char*>(&m_dataSize), 4);
 
-    std::ofstream out(basename + '_' + std::to_string(channel) + '_' + std::to_string(record) + '_' + getAudioLevel(bps, frequency) + ".wav", std::ios::binary | std::ios::out);
+    const bool good = m_out.good();
+    m_out.close();
+    return good && !m_out.fail();
+}
 
-    out.write("RIFF", 4);
-    out.write(reinterpret_cast<const char*>(&wavSize), 4);
-    out.write("WAVE", 4);
-    out.write("fmt ", 4);
-    out.write("\x10\0\0\0", 4);
-    out.write("\1\0", 2); // audio format
+/** \brief Appends samples to the file.
+ * \param left The left audio channel, or the samples of a mono file.
+ * \param right The right audio channel, unused in mono.
+ * \return true if the samples have been written, false otherwise.
+ *
+ * In stereo, only the first min(left.size(), right.size()) samples from both audio channels are written.
+ */
+bool WAVWriter::Write(std::span<const int16_t> left, std::span<const int16_t> right)
+{
+    static_assert(std::endian::native == std::endian::little, "Requires little-endian target");
 
-    out.write(reinterpret_cast<const char*>(&channelNumber), 2);
-    out.write(reinterpret_cast<const char*>(&frequency), 4);
-    out.write(reinterpret_cast<const char*>(&bytePerSec), 4);
-    out.write(reinterpret_cast<const char*>(&bytePerBloc), 2);
-    out.write("\x10\0", 2);
-    out.write("data", 4);
-    out.write(reinterpret_cast<const char*>(&dataSize), 4);
+    if(!m_out.is_open())
+        return false;
 
-    if(right.size()) // stereo
+    if(m_header.channelNumber == 1)
     {
-        for(uint32_t i = 0; i < left.size() && i < right.size(); i++)
-        {
-            out.write(reinterpret_cast<const char*>(&left[i]), 2);
-            out.write(reinterpret_cast<const char*>(&right[i]), 2);
-        }
+        m_out.write(reinterpret_cast<const char*>(left.data()), left.size_bytes());
+        m_dataSize += left.size_bytes();
+        return m_out.good();
     }
-    else // mono
+
+    const size_t size = std::min(left.size(), right.size());
+    m_interleaved.resize(std::min(size, BLOCK_SAMPLES) * 2);
+    for(size_t i = 0; i < size; i += BLOCK_SAMPLES)
     {
-        out.write(reinterpret_cast<const char*>(&left[0]), left.size() * 2);
+        const size_t count = std::min(size - i, BLOCK_SAMPLES);
+        const std::span<int16_t> block = std::span(m_interleaved).first(count * 2);
+        interleaveSamples(left.subspan(i, count), right.subspan(i, count), block);
+        m_out.write(reinterpret_cast<const char*>(block.data()), block.size_bytes());
+        m_dataSize += block.size_bytes();
     }
 
-    left.clear();
-    right.clear();
+    return m_out.good();
 }
 
 } // namespace Audio
@@ -1,13 +1,24 @@
 #ifndef CDI_COMMON_AUDIO_HPP
 #define CDI_COMMON_AUDIO_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
 #include <fstream>
+#include <span>
+#include <string>
 #include <vector>
 
 namespace Audio
 {
 
+/** \brief The size of the audio data of a sector, made of 18 sound groups. */
+static constexpr size_t SECTOR_DATA_SIZE = 2304;
+/** \brief The number of samples in a Level A sector, both channels included. */
+static constexpr size_t LEVEL_A_SECTOR_SAMPLES = 18 * 4 * 28;
+/** \brief The number of samples in a Level B or C sector, both channels included. */
+static constexpr size_t LEVEL_BC_SECTOR_SAMPLES = 18 * 8 * 28;
+
 /** \brief Stores the samples delayed by the ADPCM decoder. */
 struct SamplesDelay
 {
@@ -23,10 +34,50 @@ struct WAVHeader
     uint32_t frequency;
 };
 
+/** \brief Writes a 16-bit PCM WAV file block by block.
+ *
+ * The samples are written as they are appended, so the memory used does not depend on the length of the file. The
+ * sizes in the header are written when the file is closed.
+ *
+ * This class is not thread-safe.
+ */
+class WAVWriter
+{
+public:
+    static constexpr size_t HEADER_SIZE = 44;
+    static constexpr size_t BLOCK_SAMPLES = 4096; /**< Number of samples per channel interleaved at once. */
+
+    WAVWriter() = default;
+    WAVWriter(const std::filesystem::path& path, WAVHeader header);
+    ~WAVWriter() noexcept;
+
+    WAVWriter(const WAVWriter&) = delete;
+    WAVWriter& operator=(const WAVWriter&) = delete;
+    WAVWriter(WAVWriter&&) = delete;
+    WAVWriter& operator=(WAVWriter&&) = delete;
+
+    bool Open(const std::filesystem::path& path, WAVHeader header);
+    bool Close() noexcept;
+    /** \brief Returns true if a file is opened. */
+    bool IsOpen() const noexcept { return m_out.is_open(); }
+
+    bool Write(std::span<const int16_t> left, std::span<const int16_t> right);
+    /** \brief Returns the number of bytes of samples written. */
+    uint32_t GetDataSize() const noexcept { return m_dataSize; }
+
+private:
+    std::ofstream m_out{};
+    WAVHeader m_header{};
+    uint32_t m_dataSize{0};
+    std::vector<int16_t> m_interleaved{};
+};
+
+size_t decodeAudioSector(SamplesDelay& delay, bool levelA, bool stereo, std::span<const uint8_t, SECTOR_DATA_SIZE> data, std::span<int16_t> left, std::span<int16_t> right) noexcept;
 uint16_t decodeAudioSector(SamplesDelay& delay, bool levelA, bool stereo, const uint8_t data[2304], std::vector<int16_t>& left, std::vector<int16_t>& right);
 uint8_t decodeLevelASoundGroup(SamplesDelay& delay, bool stereo, const uint8_t data[128], std::vector<int16_t>& left, std::vector<int16_t>& right);
 uint8_t decodeLevelBCSoundGroup(SamplesDelay& delay, bool stereo, const uint8_t data[128], std::vector<int16_t>& left, std::vector<int16_t>& right);
-void writeWAV(const std::string& basename, std::vector<int16_t>& left, std::vector<int16_t>& right, uint8_t channel, int record, uint8_t bps, uint8_t sf, uint8_t ms);
+void interleaveSamples(std::span<const int16_t> left, std::span<const int16_t> right, std::span<int16_t> dst) noexcept;
+std::string getWAVPath(const std::string& basename, uint8_t channel, size_t record, uint8_t bps, uint8_t sf);
 
 } // namespace Audio
 
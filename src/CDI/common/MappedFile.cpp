@@ -0,0 +1,101 @@
+#include "MappedFile.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#define LIBCEDIMU_MAPPEDFILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/** \brief Opens the given file.
+ * \param path The file to open.
+ * \see IsOpen to check if the file has been opened.
+ */
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    Open(path);
+}
+
+MappedFile::~MappedFile() noexcept
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if(this != &other)
+    {
+        Close();
+        m_buffer = std::move(other.m_buffer);
+        m_data = other.m_mapped ? other.m_data : std::span<const uint8_t>{m_buffer};
+        m_mapped = std::exchange(other.m_mapped, false);
+        m_open = std::exchange(other.m_open, false);
+        other.m_data = {};
+    }
+    return *this;
+}
+
+/** \brief Opens a file, closing the one previously opened.
+ * \param path The file to open.
+ * \return true if opened successfully, false otherwise.
+ */
+bool MappedFile::Open(const std::filesystem::path& path)
+{
+    Close();
+
+#ifdef LIBCEDIMU_MAPPEDFILE_MMAP
+    const int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data != MAP_FAILED)
+        {
+            close(fd); // The mapping keeps a reference to the file.
+            madvise(data, st.st_size, MADV_SEQUENTIAL);
+            m_data = {static_cast<const uint8_t*>(data), static_cast<size_t>(st.st_size)};
+            m_mapped = true;
+            m_open = true;
+            return true;
+        }
+    }
+    close(fd);
+#endif // LIBCEDIMU_MAPPEDFILE_MMAP
+
+    // Empty files cannot be mapped, and special files may not be, so fall back to reading the file.
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if(!in.is_open())
+        return false;
+
+    m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    m_data = m_buffer;
+    m_open = true;
+    return true;
+}
+
+/** \brief Closes the file, invalidating the data previously returned. */
+void MappedFile::Close() noexcept
+{
+#ifdef LIBCEDIMU_MAPPEDFILE_MMAP
+    if(m_mapped)
+        munmap(const_cast<uint8_t*>(m_data.data()), m_data.size());
+#endif // LIBCEDIMU_MAPPEDFILE_MMAP
+
+    m_data = {};
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_mapped = false;
+    m_open = false;
+}
@@ -0,0 +1,44 @@
+#ifndef CDI_COMMON_MAPPEDFILE_HPP
+#define CDI_COMMON_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+/** \brief Read-only view of a whole file in memory.
+ *
+ * The file is memory-mapped when the platform supports it, so only the pages actually read are loaded. Otherwise the
+ * whole file is read in a buffer when opened.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile() noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::filesystem::path& path);
+    void Close() noexcept;
+    /** \brief Returns true if a file is opened. */
+    bool IsOpen() const noexcept { return m_open; }
+
+    /** \brief Returns the content of the file, valid until the file is closed. */
+    std::span<const uint8_t> GetData() const noexcept { return m_data; }
+    /** \brief Returns the size of the file in bytes. */
+    size_t GetSize() const noexcept { return m_data.size(); }
+
+private:
+    std::span<const uint8_t> m_data{};
+    std::vector<uint8_t> m_buffer{}; /**< The content of the file when it is not mapped. */
+    bool m_mapped{false};
+    bool m_open{false};
+};
+
+#endif // CDI_COMMON_MAPPEDFILE_HPP
@@ -0,0 +1,67 @@
+#ifndef CDI_COMMON_SPSCQUEUE_HPP
+#define CDI_COMMON_SPSCQUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/** \brief Bounded lock-free queue with a single producer thread and a single consumer thread.
+ * \tparam T The element type, must be default constructible and movable.
+ * \tparam SIZE The capacity of the queue, must be a power of 2.
+ *
+ * The producer and the consumer never wait on each other: pushing to a full queue and popping from an empty queue
+ * fail immediately.
+ */
+template<typename T, size_t SIZE>
+class SPSCQueue
+{
+public:
+    static_assert(std::has_single_bit(SIZE), "The queue size must be a power of 2");
+
+    /** \brief Adds an element at the end of the queue, to be called by the producer thread.
+     * \return false if the queue is full, in which case \p value is left untouched.
+     */
+    bool TryPush(T&& value) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_head.load(std::memory_order_acquire) == SIZE)
+            return false;
+
+        m_buffer[tail & INDEX_MASK] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** \brief Removes the first element of the queue, to be called by the consumer thread.
+     * \return The element, or nullopt if the queue is empty.
+     */
+    std::optional<T> TryPop() noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if(head == m_tail.load(std::memory_order_acquire))
+            return std::nullopt;
+
+        std::optional<T> value{std::move(m_buffer[head & INDEX_MASK])};
+        m_head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    /** \brief Returns the number of elements in the queue, which may already be outdated. */
+    size_t Size() const noexcept { return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire); }
+    /** \brief Returns true if the queue is empty, which may already be outdated. */
+    bool Empty() const noexcept { return Size() == 0; }
+
+private:
+    static constexpr size_t INDEX_MASK = SIZE - 1;
+    static constexpr size_t CACHE_LINE_SIZE = 64; // std::hardware_destructive_interference_size warns on GCC.
+
+    std::array<T, SIZE> m_buffer{};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head{0}; /**< Index of the next element to pop, written by the consumer. */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0}; /**< Index of the next element to push, written by the producer. */
+};
+
+#endif // CDI_COMMON_SPSCQUEUE_HPP
@@ -148,6 +148,7 @@ void MCD212::SetByte(const uint32_t addr, const uint8_t data, const BusFlags fla
     if(addr < 0x400000)
     {
         m_memory[addr] = data;
+        CheckControlProgramWrite(addr);
         LOG(if(flags.log && m_cdi.m_callbacks.HasOnLogMemoryAccess()) \
                 m_cdi.m_callbacks.OnLogMemoryAccess({MemoryAccessLocation::RAM, "Set", "Byte", m_cdi.m_cpu.currentPC, addr, data});)
         return;
@@ -182,6 +183,7 @@ void MCD212::SetWord(const uint32_t addr, const uint16_t data, const BusFlags fl
     {
         m_memory[addr]     = bits<8, 15>(data);
         m_memory[addr + 1] = data;
+        CheckControlProgramWrite(addr); // Words are aligned, both bytes are in the same block.
         LOG(if(flags.log && m_cdi.m_callbacks.HasOnLogMemoryAccess()) \
                 m_cdi.m_callbacks.OnLogMemoryAccess({MemoryAccessLocation::RAM, "Set", "Word", m_cdi.m_cpu.currentPC, addr, data});)
         return;
@@ -28,21 +28,21 @@ void MCD212::DrawVideoLine()
             if(m_lineNumber == 0)
             {
                 m_lineNumber = 1;
-                m_renderer.SetDisplayFormat(GetDisplayFormat(), true, Is60FPS());
+                m_renderer->SetDisplayFormat(GetDisplayFormat(), true, Is60FPS());
             }
         }
         else // Odd frames, even lines.
         {
             SetPA();
             if(m_lineNumber == 0)
-                m_renderer.SetDisplayFormat(GetDisplayFormat(), true, Is60FPS());
+                m_renderer->SetDisplayFormat(GetDisplayFormat(), true, Is60FPS());
         }
     }
     else // Non-interlaced, PA is always set.
     {
         SetPA();
         if(m_lineNumber == 0)
-            m_renderer.SetDisplayFormat(GetDisplayFormat(), false, Is60FPS());
+            m_renderer->SetDisplayFormat(GetDisplayFormat(), false, Is60FPS());
     }
 
     if(GetDE())
@@ -50,7 +50,15 @@ void MCD212::DrawVideoLine()
         const uint32_t vsr1 = GetVSR1();
         const uint32_t vsr2 = GetVSR2();
 
-        const std::pair<uint16_t, uint16_t> bytes = m_renderer.DrawLine(&m_memory[vsr1], &m_memory[vsr2], m_lineNumber);
+        std::pair<uint16_t, uint16_t> bytes;
+        if(m_renderThread)
+        {
+            // Only the line size is needed to continue the emulation, the worker thread does the actual drawing.
+            bytes = m_renderer->GetLineSize(&m_memory[vsr1], &m_memory[vsr2]);
+            m_renderThread->PushLine(*m_renderer, &m_memory[vsr1], bytes.first, &m_memory[vsr2], bytes.second, m_lineNumber);
+        }
+        else
+            bytes = m_renderer->DrawLine(&m_memory[vsr1], &m_memory[vsr2], m_lineNumber);
 
         SetVSR1(vsr1 + bytes.first);
         SetVSR2(vsr2 + bytes.second);
@@ -74,6 +82,13 @@ void MCD212::DrawVideoLine()
         m_verticalLines = 0;
         m_lineNumber = 0;
 
-        m_cdi.m_callbacks.OnFrameCompleted(m_renderer.RenderFrame());
+        if(m_renderThread)
+            m_renderThread->PushFrame(*m_renderer);
+        else
+        {
+            m_cdi.m_callbacks.OnFrameCompleted(m_renderer->RenderFrame());
+            TakeSnapshot(*m_renderer);
+            m_cdi.m_frames.Publish(m_renderer->m_screen);
+        }
     }
 }
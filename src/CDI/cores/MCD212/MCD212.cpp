@@ -1,6 +1,11 @@
 #include "MCD212.hpp"
 #include "../../CDI.hpp"
 #include "../../common/utils.hpp"
+#ifdef LIBCEDIMU_ENABLE_RENDERERSIMD
+#include "../../Video/RendererSIMD.hpp"
+#endif
+#include "../../Video/RendererNull.hpp"
+#include "../../Video/RendererSoftware.hpp"
 
 #include <algorithm>
 #include <cstring>
@@ -8,21 +13,129 @@
 #define DCP_POINTER(inst) (inst & 0x003FFFFCu)
 #define ICA_VSR_POINTER(inst) (bits<0, 21>(inst))
 
-MCD212::MCD212(CDI& cdi, OS9::BIOS bios, const bool pal)
+static std::unique_ptr<Video::Renderer> makeRenderer(const Video::RendererBackend backend)
+{
+    switch(backend)
+    {
+    case Video::RendererBackend::SIMD:
+#ifdef LIBCEDIMU_ENABLE_RENDERERSIMD
+        return Video::makeRendererSIMD();
+#else
+        [[fallthrough]];
+#endif
+
+    case Video::RendererBackend::Software:
+        return std::make_unique<Video::RendererSoftware>();
+
+    case Video::RendererBackend::Null:
+        return std::make_unique<Video::RendererNull>();
+    }
+
+    std::unreachable();
+}
+
+MCD212::MCD212(CDI& cdi, OS9::BIOS bios, const bool pal, const Video::RendererBackend backend, const bool asyncVideo)
     : m_bios(std::move(bios))
     , m_cdi(cdi)
     , m_isPAL(pal)
+    , m_renderer(makeRenderer(backend))
     , m_memory(0x280000, 0)
+    , m_controlProgramWatch(m_memory.size() >> CONTROL_WATCH_SHIFT, false)
+{
+    // The null renderer draws nothing, so there is nothing to offload.
+    if(asyncVideo && backend != Video::RendererBackend::Null)
+        m_renderThread = std::make_unique<Video::RenderThread>(makeRenderer(backend), [this] (const Video::Plane& screen) {
+            m_cdi.m_callbacks.OnFrameCompleted(screen);
+            TakeSnapshot(m_renderThread->GetRenderer());
+            m_cdi.m_frames.Publish(screen);
+        });
+}
+
+/** \brief Stops the render thread first, as its frame callback uses the other members. */
+MCD212::~MCD212() noexcept
+{
+    m_renderThread.reset();
+}
+
+/** \brief Returns a copy of the screen of the last completed frame. */
+Video::Plane MCD212::GetScreen() const
+{
+    return GetSnapshotPlane(&PlanesSnapshot::screen);
+}
+
+/** \brief Returns a copy of plane A, empty unless retained, see \ref SetPlanesRetained. */
+Video::Plane MCD212::GetPlaneA() const
+{
+    return GetSnapshotPlane(&PlanesSnapshot::planeA);
+}
+
+/** \brief Returns a copy of plane B, empty unless retained, see \ref SetPlanesRetained. */
+Video::Plane MCD212::GetPlaneB() const
+{
+    return GetSnapshotPlane(&PlanesSnapshot::planeB);
+}
+
+/** \brief Returns a copy of the backdrop plane. */
+Video::Plane MCD212::GetBackground() const
 {
+    return GetSnapshotPlane(&PlanesSnapshot::background);
+}
+
+/** \brief Returns a copy of the cursor plane. */
+Video::Plane MCD212::GetCursor() const
+{
+    return GetSnapshotPlane(&PlanesSnapshot::cursor);
+}
+
+/** \brief Copies the planes of the given renderer if a getter has asked for them since the last snapshot.
+ * \param renderer The renderer that has just completed a frame, only used by the calling thread.
+ *
+ * Called at the end of each frame by the thread that draws it (the render thread or the emulation thread), so the
+ * getters never read planes being drawn or reallocated (see \ref Video::Renderer::SetPlanesRetained).
+ */
+void MCD212::TakeSnapshot(const Video::Renderer& renderer)
+{
+    if(!m_snapshotRequested.exchange(false, std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    m_snapshot.screen = renderer.m_screen;
+    m_snapshot.planeA = renderer.m_plane[PlaneA];
+    m_snapshot.planeB = renderer.m_plane[PlaneB];
+    m_snapshot.background = renderer.m_backdropPlane;
+    m_snapshot.cursor = renderer.m_cursorPlane;
+}
+
+/** \brief Returns a copy of a plane of the last snapshot, and asks for a new one at the end of the next frame.
+ *
+ * The snapshot is only taken when asked, so the planes are not copied on every frame when nobody reads them. The
+ * first call returns an empty plane.
+ */
+Video::Plane MCD212::GetSnapshotPlane(Video::Plane PlanesSnapshot::* const plane) const
+{
+    m_snapshotRequested.store(true, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    return m_snapshot.*plane;
+}
+
+/** \brief Keeps the whole planes A and B, so they are returned by \ref GetPlaneA and \ref GetPlaneB.
+ * \param retained true to keep the whole planes, false to only keep the lines being drawn (the default).
+ */
+void MCD212::SetPlanesRetained(const bool retained) noexcept
+{
+    if(m_renderThread)
+        m_renderThread->SetPlanesRetained(retained);
+    else
+        m_renderer->SetPlanesRetained(retained);
 }
 
 void MCD212::Reset() noexcept
 {
-    m_renderer.m_externalVideo = false; // reset bits 0, 1, 2, 3, 8, 9, 10, 11, 18 (plane A and B off, external video disabled)
-    m_renderer.m_codingMethod[PlaneA] = Video::ImageCodingMethod::OFF;
-    m_renderer.m_codingMethod[PlaneB] = Video::ImageCodingMethod::OFF;
-    m_renderer.SetCursorEnabled(false); // reset bit 23 (cursor disabled)
-    m_renderer.m_backdropColor = 0; // reset bits 0, 1, 2, 3 (black backdrop)
+    m_renderer->m_externalVideo = false; // reset bits 0, 1, 2, 3, 8, 9, 10, 11, 18 (plane A and B off, external video disabled)
+    m_renderer->m_codingMethod[PlaneA] = Video::ImageCodingMethod::OFF;
+    m_renderer->m_codingMethod[PlaneB] = Video::ImageCodingMethod::OFF;
+    m_renderer->SetCursorEnabled(false); // reset bit 23 (cursor disabled)
+    m_renderer->m_backdropColor = 0; // reset bits 0, 1, 2, 3 (black backdrop)
 
     // TODO: reset those too.
     m_internalRegisters[CSR1W] = 0; // DI1, DD1, DD2, TD, DD, ST, BE
@@ -46,7 +159,7 @@ void MCD212::IncrementTime(const double ns)
     const size_t lineDisplayTime = GetLineDisplayTime();
     if(m_timeNs >= lineDisplayTime)
     {
-        m_renderer.IncrementCursorTime(m_timeNs);
+        m_renderer->IncrementCursorTime(m_timeNs);
         DrawVideoLine();
         m_timeNs -= lineDisplayTime;
     }
@@ -57,228 +170,288 @@ void MCD212::ResetMemorySwap() noexcept
     m_memorySwapCount = 0;
 }
 
-template<Video::ImagePlane PLANE>
-void MCD212::ExecuteICA()
+/** \brief Returns true if the control part of an instruction stops the execution of the control area. */
+static constexpr bool isStopControl(const uint8_t control) noexcept
 {
-    const size_t cycles = GetHorizontalCycles() * GetVerticalRetraceLines();
-    uint32_t addr = GetSM() && !GetPA() ? 0x404 : 0x400;
-    if constexpr(PLANE == PlaneB)
-        addr += 0x20'0000;
+    return control == 0 || control == 3 || control == 5; // STOP, RELOAD DCP AND STOP, RELOAD VSR AND STOP
+}
 
-    for(size_t i = 0; i < cycles; i++)
-    {
-        const uint32_t ica = GetControlInstruction(addr);
+/** \brief Returns true if the control instruction stops the execution or jumps, which ends a \ref ControlProgram. */
+template<bool ICA>
+static constexpr bool endsControlProgram(const uint8_t control) noexcept
+{
+    if(isStopControl(control))
+        return true;
 
-        if(m_cdi.m_callbacks.HasOnLogICADCA())
-        {
-            if constexpr(PLANE == PlaneA)
-                m_cdi.m_callbacks.OnLogICADCA(Video::ControlArea::ICA1, {m_totalFrameCount + 1, 0, ica});
-            else
-                m_cdi.m_callbacks.OnLogICADCA(Video::ControlArea::ICA2, {m_totalFrameCount + 1, 0, ica});
-        }
-        addr += 4;
+    switch(control)
+    {
+    case 2: // RELOAD DCP, a jump for the DCA.
+        return !ICA;
 
-        switch(ica >> 28)
-        {
-        case 0: // STOP
-            return;
+    case 4: // RELOAD ICA, a jump for the ICA (RELOAD VSR for the DCA).
+        return ICA;
 
-        case 1: // NOP
-            break;
+    default:
+        return false;
+    }
+}
 
-        case 2: // RELOAD DCP
-            if constexpr(PLANE == PlaneA)
-                SetDCP1(DCP_POINTER(ica));
-            else
-                SetDCP2(DCP_POINTER(ica));
-            break;
+/** \brief Decodes a control instruction.
+ * \tparam PLANE The plane executing the instruction.
+ * \tparam ICA true if the instruction is in the ICA, false in the DCA.
+ */
+template<Video::ImagePlane PLANE, bool ICA>
+constexpr MCD212::ControlOperation MCD212::DecodeControlInstruction(const uint32_t instruction) noexcept
+{
+    using enum ControlParameter;
 
-        case 3: // RELOAD DCP AND STOP
-            if constexpr(PLANE == PlaneA)
-                SetDCP1(DCP_POINTER(ica));
-            else
-                SetDCP2(DCP_POINTER(ica));
-            return;
+    ControlOperation operation{instruction, static_cast<uint8_t>(instruction >> 28), DCP};
+    const uint8_t code = instruction >> 24;
+    switch(code)
+    {
+    case 0x10: // The renderer does nothing with the control instructions.
+    case 0x20:
+    case 0x40:
+    case 0x60:
+        operation.parameter = None;
+        break;
+
+    case 0x70:
+        // This command is implemented in the SCC66470, but the driver still sends it to the MCD212, so just ignore it.
+        if constexpr(ICA)
+            operation.parameter = None;
+        break;
+
+    case 0xCD:
+        if constexpr(PLANE == PlaneA)
+            operation.parameter = CursorPosition;
+        break;
 
-        case 4: // RELOAD ICA
-            addr = ICA_VSR_POINTER(ica);
-            break;
+    case 0xCE:
+        if constexpr(PLANE == PlaneA)
+            operation.parameter = CursorControl;
+        break;
 
-        case 5: // RELOAD VSR AND STOP
-            if constexpr(PLANE == PlaneA)
-                SetVSR1(ICA_VSR_POINTER(ica));
-            else
-                SetVSR2(ICA_VSR_POINTER(ica));
-            return;
+    case 0xCF:
+        if constexpr(PLANE == PlaneA)
+            operation.parameter = CursorPattern;
+        break;
+    }
 
-        case 6: // INTERRUPT
-            if constexpr(PLANE == PlaneA)
-            {
-                SetIT1();
-                if(!GetDI1())
-                    m_cdi.m_cpu.INT1();
-            }
-            else
-            {
-                SetIT2();
-                if(!GetDI2())
-                    m_cdi.m_cpu.INT1();
-            }
-            break;
-        }
+    return operation;
+}
 
-        if constexpr(PLANE == PlaneA)
+/** \brief Returns the decoded control program that starts at the given address.
+ * \tparam PLANE The plane executing the program.
+ * \tparam ICA true if the program is in the ICA, false in the DCA.
+ *
+ * The programs in RAM and in the BIOS are cached, and RAM writes to a cached program invalidate the cache. Anything
+ * else is read through \ref GetControlInstruction, one instruction at a time.
+ */
+template<Video::ImagePlane PLANE, bool ICA>
+const MCD212::ControlProgram& MCD212::GetControlProgram(const uint32_t addr)
+{
+    std::span<const uint8_t> memory;
+    uint32_t offset = 0;
+    if(m_memorySwapCount >= 4) [[likely]] // The memory swap reads must go through GetWord.
+    {
+        if(addr < m_memory.size())
         {
-            const uint8_t code = ica >> 24;
-            switch(code)
-            {
-            case 0x70:
-                // This command is implemented in the SCC66470, but the driver still sends it to the MCD212, so just ignore it.
-                break;
-
-            case 0xCD:
-                m_renderer.SetCursorPosition(bits<0, 9>(ica), bits<12, 21>(ica));
-                break;
-
-            case 0xCE:
-                m_renderer.SetCursorColor(bits<0, 3>(ica));
-                m_renderer.SetCursorEnabled(bit<23>(ica));
-                m_renderer.SetCursorResolution(bit<15>(ica));
-                m_renderer.SetCursorBlink(bit<22>(ica), bits<19, 21>(ica), bits<16, 18>(ica));
-                break;
-
-            case 0xCF:
-                m_renderer.SetCursorPattern(bits<16, 19>(ica), ica);
-                break;
-
-            default:
-                m_renderer.ExecuteDCPInstruction<PlaneA>(ica);
-                break;
-            }
+            memory = m_memory;
+            offset = addr;
         }
-        else // Plane B.
+        else if(addr >= 0x400000 && addr < 0x4FFC00)
         {
-            // This command is implemented in the SCC66470, but the driver still sends it to the MCD212, so just ignore it.
-            if((ica & 0xFF00'0000) != 0x7000'0000)
-                m_renderer.ExecuteDCPInstruction<PlaneB>(ica);
+            memory = {&m_bios[0], std::min<size_t>(m_bios.GetSize(), 0x4FFC00 - 0x400000)};
+            offset = addr - 0x400000;
         }
     }
+
+    const size_t available = offset < memory.size() ? (memory.size() - offset) / 4 : 0;
+    if(available == 0)
+    {
+        m_uncachedControlProgram.operations[0] = DecodeControlInstruction<PLANE, ICA>(GetControlInstruction(addr));
+        m_uncachedControlProgram.size = 1;
+        return m_uncachedControlProgram;
+    }
+
+    // A program may start at the same address in all the areas, and is decoded differently in each of them.
+    const uint32_t key = addr << 2 | (ICA ? 2 : 0) | (PLANE == PlaneB ? 1 : 0);
+    if(const auto it = m_controlPrograms.find(key); it != m_controlPrograms.end())
+        return it->second;
+
+    ControlProgram program{};
+    while(program.size < std::min(available, CONTROL_PROGRAM_MAX_SIZE))
+    {
+        const ControlOperation operation = DecodeControlInstruction<PLANE, ICA>(GET_ARRAY32(memory, offset + program.size * 4));
+        program.operations[program.size++] = operation;
+        if(endsControlProgram<ICA>(operation.control))
+            break;
+    }
+
+    if(addr < m_memory.size())
+    {
+        const size_t end = addr + program.size * 4;
+        for(size_t block = addr >> CONTROL_WATCH_SHIFT; block <= (end - 1) >> CONTROL_WATCH_SHIFT; block++)
+            m_controlProgramWatch[block] = true;
+    }
+
+    return m_controlPrograms.emplace(key, program).first->second;
 }
-template void MCD212::ExecuteICA<MCD212::PlaneA>();
-template void MCD212::ExecuteICA<MCD212::PlaneB>();
 
-template<Video::ImagePlane PLANE>
-void MCD212::ExecuteDCA()
+/** \brief Executes the control part of the instruction (except RELOAD ICA), then its parameter. */
+template<Video::ImagePlane PLANE, bool ICA>
+void MCD212::ExecuteControlOperation(const ControlOperation& operation)
 {
-    for(uint8_t i = 0; i < (GetCF() ? 16 : 8); i++) // Table 5.10
+    const uint32_t instruction = operation.instruction;
+
+    switch(operation.control)
     {
-        uint32_t addr;
+    case 0: // STOP
+        return;
+
+    case 2: // RELOAD DCP
+    case 3: // RELOAD DCP AND STOP
+        if constexpr(PLANE == PlaneA)
+            SetDCP1(DCP_POINTER(instruction));
+        else
+            SetDCP2(DCP_POINTER(instruction));
+        if(operation.control == 3)
+            return;
+        break;
+
+    case 4: // RELOAD ICA (done by ExecuteICA) or RELOAD VSR
+        if constexpr(ICA)
+            break;
+        [[fallthrough]];
+
+    case 5: // RELOAD VSR AND STOP
+        if constexpr(PLANE == PlaneA)
+            SetVSR1(ICA_VSR_POINTER(instruction));
+        else
+            SetVSR2(ICA_VSR_POINTER(instruction));
+        if(operation.control == 5)
+            return;
+        break;
+
+    case 6: // INTERRUPT
         if constexpr(PLANE == PlaneA)
         {
-            addr = GetDCP1();
-            SetDCP1(addr + 4);
+            SetIT1();
+            if(!GetDI1())
+                m_cdi.m_cpu.INT1();
         }
         else
         {
-            addr = GetDCP2();
-            SetDCP2(addr + 4);
+            SetIT2();
+            if(!GetDI2())
+                m_cdi.m_cpu.INT1();
         }
-        const uint32_t dca = GetControlInstruction(addr);
+        break;
+    }
 
-        if(m_cdi.m_callbacks.HasOnLogICADCA())
-        {
-            if constexpr(PLANE == PlaneA)
-                m_cdi.m_callbacks.OnLogICADCA(Video::ControlArea::DCA1, {m_totalFrameCount + 1, m_lineNumber, dca});
-            else
-                m_cdi.m_callbacks.OnLogICADCA(Video::ControlArea::DCA2, {m_totalFrameCount + 1, m_lineNumber, dca});
-        }
+    switch(operation.parameter)
+    {
+    case ControlParameter::None:
+        break;
+
+    case ControlParameter::DCP:
+        m_renderer->ExecuteDCPInstruction<PLANE>(instruction);
+        break;
+
+    case ControlParameter::CursorPosition:
+        m_renderer->SetCursorPosition(bits<0, 9>(instruction), bits<12, 21>(instruction));
+        break;
+
+    case ControlParameter::CursorControl:
+        m_renderer->SetCursorColor(bits<0, 3>(instruction));
+        m_renderer->SetCursorEnabled(bit<23>(instruction));
+        m_renderer->SetCursorResolution(bit<15>(instruction));
+        m_renderer->SetCursorBlink(bit<22>(instruction), bits<19, 21>(instruction), bits<16, 18>(instruction));
+        break;
+
+    case ControlParameter::CursorPattern:
+        m_renderer->SetCursorPattern(bits<16, 19>(instruction), instruction);
+        break;
+    }
+}
 
-        switch(dca >> 28)
-        {
-        case 0: // STOP
-            return;
+template<Video::ImagePlane PLANE>
+void MCD212::ExecuteICA()
+{
+    const size_t cycles = GetHorizontalCycles() * GetVerticalRetraceLines();
+    uint32_t addr = GetSM() && !GetPA() ? 0x404 : 0x400;
+    if constexpr(PLANE == PlaneB)
+        addr += 0x20'0000;
 
-        case 1: // NOP
-            break;
+    for(size_t i = 0; i < cycles;)
+    {
+        const ControlProgram& program = GetControlProgram<PLANE, true>(addr);
+        for(uint8_t op = 0; op < program.size && i < cycles; op++, i++)
+        {
+            const ControlOperation& operation = program.operations[op];
 
-        case 2: // RELOAD DCP
-            if constexpr(PLANE == PlaneA)
-                SetDCP1(DCP_POINTER(dca));
-            else
-                SetDCP2(DCP_POINTER(dca));
-            break;
+            if(m_cdi.m_callbacks.HasOnLogICADCA())
+            {
+                if constexpr(PLANE == PlaneA)
+                    m_cdi.m_callbacks.OnLogICADCA(Video::ControlArea::ICA1, {m_totalFrameCount + 1, 0, operation.instruction});
+                else
+                    m_cdi.m_callbacks.OnLogICADCA(Video::ControlArea::ICA2, {m_totalFrameCount + 1, 0, operation.instruction});
+            }
+            addr += 4;
 
-        case 3: // RELOAD DCP AND STOP
-            if constexpr(PLANE == PlaneA)
-                SetDCP1(DCP_POINTER(dca));
-            else
-                SetDCP2(DCP_POINTER(dca));
-            return;
+            ExecuteControlOperation<PLANE, true>(operation);
+            if(isStopControl(operation.control))
+                return;
 
-        case 4: // RELOAD VSR
-            if constexpr(PLANE == PlaneA)
-                SetVSR1(ICA_VSR_POINTER(dca));
-            else
-                SetVSR2(ICA_VSR_POINTER(dca));
-            break;
+            if(operation.control == 4) // RELOAD ICA, always the last instruction of the program.
+                addr = ICA_VSR_POINTER(operation.instruction);
+        }
+    }
+}
+template void MCD212::ExecuteICA<MCD212::PlaneA>();
+template void MCD212::ExecuteICA<MCD212::PlaneB>();
 
-        case 5: // RELOAD VSR AND STOP
+template<Video::ImagePlane PLANE>
+void MCD212::ExecuteDCA()
+{
+    const uint8_t count = GetCF() ? 16 : 8; // Table 5.10
+    for(uint8_t i = 0; i < count;)
+    {
+        // A RELOAD DCP ends the program, so the next one starts at the new DCP.
+        const ControlProgram& program = GetControlProgram<PLANE, false>(PLANE == PlaneA ? GetDCP1() : GetDCP2());
+        for(uint8_t op = 0; op < program.size && i < count; op++, i++)
+        {
+            const ControlOperation& operation = program.operations[op];
             if constexpr(PLANE == PlaneA)
-                SetVSR1(ICA_VSR_POINTER(dca));
+                SetDCP1(GetDCP1() + 4);
             else
-                SetVSR2(ICA_VSR_POINTER(dca));
-            return;
+                SetDCP2(GetDCP2() + 4);
 
-        case 6: // INTERRUPT
-            if constexpr(PLANE == PlaneA)
+            if(m_cdi.m_callbacks.HasOnLogICADCA())
             {
-                SetIT1();
-                if(!GetDI1())
-                    m_cdi.m_cpu.INT1();
+                if constexpr(PLANE == PlaneA)
+                    m_cdi.m_callbacks.OnLogICADCA(Video::ControlArea::DCA1, {m_totalFrameCount + 1, m_lineNumber, operation.instruction});
+                else
+                    m_cdi.m_callbacks.OnLogICADCA(Video::ControlArea::DCA2, {m_totalFrameCount + 1, m_lineNumber, operation.instruction});
             }
-            else
-            {
-                SetIT2();
-                if(!GetDI2())
-                    m_cdi.m_cpu.INT1();
-            }
-            break;
-        }
 
-        if constexpr(PLANE == PlaneA)
-        {
-            const uint8_t code = dca >> 24;
-            switch(code)
-            {
-            case 0xCD:
-                m_renderer.SetCursorPosition(bits<0, 9>(dca), bits<12, 21>(dca));
-                break;
-
-            case 0xCE:
-                m_renderer.SetCursorColor(bits<0, 3>(dca));
-                m_renderer.SetCursorEnabled(bit<23>(dca));
-                m_renderer.SetCursorResolution(bit<15>(dca));
-                m_renderer.SetCursorBlink(bit<22>(dca), bits<19, 21>(dca), bits<16, 18>(dca));
-                break;
-
-            case 0xCF:
-                m_renderer.SetCursorPattern(bits<16, 19>(dca), dca);
-                break;
-
-            default:
-                m_renderer.ExecuteDCPInstruction<PlaneA>(dca);
-                break;
-            }
-        }
-        else // Plane B.
-        {
-            m_renderer.ExecuteDCPInstruction<PlaneB>(dca);
+            ExecuteControlOperation<PLANE, false>(operation);
+            if(isStopControl(operation.control))
+                return;
         }
     }
 }
 template void MCD212::ExecuteDCA<MCD212::PlaneA>();
 template void MCD212::ExecuteDCA<MCD212::PlaneB>();
 
+/** \brief Drops all the cached control programs. */
+void MCD212::InvalidateControlPrograms() noexcept
+{
+    m_controlPrograms.clear();
+    std::fill(m_controlProgramWatch.begin(), m_controlProgramWatch.end(), false);
+}
+
 RAMBank MCD212::GetRAMBank1() const noexcept
 {
     return {{m_memory.data(), 0x80000}, 0};
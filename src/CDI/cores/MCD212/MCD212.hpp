@@ -5,13 +5,15 @@ class CDI;
 #include "common/utils.hpp"
 #include "common/types.hpp"
 #include "OS9/BIOS.hpp"
-#ifdef LIBCEDIMU_ENABLE_RENDERERSIMD
-#include "Video/RendererSIMD.hpp"
-#endif
-#include "Video/RendererSoftware.hpp"
+#include "Video/Renderer.hpp"
+#include "Video/RenderThread.hpp"
 
 #include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <span>
+#include <unordered_map>
 #include <vector>
 
 class MCD212
@@ -23,7 +25,9 @@ public:
     OS9::BIOS m_bios;
     uint32_t m_totalFrameCount{0};
 
-    MCD212(CDI& cdi, OS9::BIOS bios, bool pal);
+    MCD212(CDI& cdi, OS9::BIOS bios, bool pal, Video::RendererBackend backend = Video::RendererBackend::SIMD, bool asyncVideo = false);
+
+    ~MCD212() noexcept;
 
     MCD212(const MCD212&) = delete;
 
@@ -44,11 +48,12 @@ public:
 
     std::vector<InternalRegister> GetInternalRegisters() const;
     std::vector<InternalRegister> GetControlRegisters() const;
-    const Video::Plane& GetScreen() const noexcept { return m_renderer.m_screen; }
-    const Video::Plane& GetPlaneA() const noexcept { return m_renderer.m_plane[PlaneA]; }
-    const Video::Plane& GetPlaneB() const noexcept { return m_renderer.m_plane[PlaneB]; }
-    const Video::Plane& GetBackground() const noexcept { return m_renderer.m_backdropPlane; }
-    const Video::Plane& GetCursor() const noexcept { return m_renderer.m_cursorPlane; }
+    Video::Plane GetScreen() const;
+    Video::Plane GetPlaneA() const;
+    Video::Plane GetPlaneB() const;
+    Video::Plane GetBackground() const;
+    Video::Plane GetCursor() const;
+    void SetPlanesRetained(bool retained) noexcept;
 
 private:
     CDI& m_cdi;
@@ -56,11 +61,25 @@ private:
     uint8_t m_memorySwapCount{0};
     double m_timeNs{0.0}; // time counter in nano seconds.
 
-#ifdef LIBCEDIMU_ENABLE_RENDERERSIMD
-    Video::RendererSIMD m_renderer{};
-#else
-    Video::RendererSoftware m_renderer{};
-#endif
+    std::unique_ptr<Video::Renderer> m_renderer;
+    std::unique_ptr<Video::RenderThread> m_renderThread; /**< Draws the lines when async video is enabled. */
+
+    /** \brief Copy of the planes of a completed frame, for the debug getters. */
+    struct PlanesSnapshot
+    {
+        Video::Plane screen{0, 0, 0};
+        Video::Plane planeA{0, 0, 0};
+        Video::Plane planeB{0, 0, 0};
+        Video::Plane background{0, 0, 0};
+        Video::Plane cursor{0, 0, 0};
+    };
+
+    mutable std::mutex m_snapshotMutex{};
+    PlanesSnapshot m_snapshot{};
+    mutable std::atomic<bool> m_snapshotRequested{false}; /**< Set by the getters, a snapshot is taken at the end of the next frame. */
+
+    void TakeSnapshot(const Video::Renderer& renderer);
+    Video::Plane GetSnapshotPlane(Video::Plane PlanesSnapshot::* plane) const;
 
     std::vector<uint8_t> m_memory;
 
@@ -74,11 +93,62 @@ private:
     void DrawVideoLine();
 
     // Control Area
+    /** \brief What a control instruction does besides its control part (bits 28-31). */
+    enum class ControlParameter : uint8_t
+    {
+        None,
+        DCP, /**< Executed by the renderer. */
+        CursorPosition,
+        CursorControl,
+        CursorPattern,
+    };
+
+    /** \brief A control instruction decoded once, when its program is cached. */
+    struct ControlOperation
+    {
+        uint32_t instruction;
+        uint8_t control; /**< Bits 28-31 of the instruction. */
+        ControlParameter parameter;
+    };
+
+    static constexpr size_t CONTROL_PROGRAM_MAX_SIZE = 16; /**< The maximum number of DCA instructions in a line. */
+    static constexpr size_t CONTROL_WATCH_SHIFT = 6; /**< RAM is watched for writes by blocks of 64 bytes. */
+
+    /** \brief The decoded control instructions that follow each other from a given address.
+     * The program ends on the first instruction that stops or jumps, or after \ref CONTROL_PROGRAM_MAX_SIZE
+     * instructions.
+     */
+    struct ControlProgram
+    {
+        std::array<ControlOperation, CONTROL_PROGRAM_MAX_SIZE> operations;
+        uint8_t size;
+    };
+
+    std::unordered_map<uint32_t, ControlProgram> m_controlPrograms{}; /**< The key is the start address, the area and the plane. */
+    std::vector<bool> m_controlProgramWatch; /**< The RAM blocks that contain a cached program. */
+    ControlProgram m_uncachedControlProgram{}; /**< Single instruction read through the bus when it can't be cached. */
+
     template<Video::ImagePlane PLANE>
     void ExecuteICA();
     template<Video::ImagePlane PLANE>
     void ExecuteDCA();
 
+    template<Video::ImagePlane PLANE, bool ICA>
+    static constexpr ControlOperation DecodeControlInstruction(uint32_t instruction) noexcept;
+    template<Video::ImagePlane PLANE, bool ICA>
+    const ControlProgram& GetControlProgram(uint32_t addr);
+    template<Video::ImagePlane PLANE, bool ICA>
+    void ExecuteControlOperation(const ControlOperation& operation);
+    void InvalidateControlPrograms() noexcept;
+
+    /** \brief Drops the cached control programs when a RAM write changes one of them. */
+    void CheckControlProgramWrite(const uint32_t addr) noexcept
+    {
+        const size_t block = addr >> CONTROL_WATCH_SHIFT;
+        if(block < m_controlProgramWatch.size() && m_controlProgramWatch[block]) [[unlikely]]
+            InvalidateControlPrograms();
+    }
+
     void ResetMemorySwap() noexcept;
     uint32_t GetControlInstruction(uint32_t addr);
 
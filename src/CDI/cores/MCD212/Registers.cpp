@@ -79,56 +79,57 @@ std::vector<InternalRegister> MCD212::GetInternalRegisters() const
 
 std::vector<InternalRegister> MCD212::GetControlRegisters() const
 {
+    const Video::Renderer& renderer = *m_renderer;
     std::vector<InternalRegister> registers;
 
     for(uint32_t i = 0; i < 256; i++)
-        registers.emplace_back("CLUT Color " + std::to_string(i), i, m_renderer.m_clut[i], "");
-
-    registers.emplace_back("Display format",                    0, as<int>(m_renderer.GetDisplayFormat()), "");
-    registers.emplace_back("Image type Plane A",                0, as<int>(m_renderer.m_imageType[PlaneA]), "");
-    registers.emplace_back("Image type Plane B",                0, as<int>(m_renderer.m_imageType[PlaneB]), "");
-    registers.emplace_back("Pixel repeat factor Plane A",       0, as<int>(m_renderer.m_pixelRepeatFactor[PlaneA]), "");
-    registers.emplace_back("Pixel repeat factor Plane B",       0, as<int>(m_renderer.m_pixelRepeatFactor[PlaneB]), "");
-    registers.emplace_back("Bits per Pixel Plane A",            0, as<int>(m_renderer.m_bps[PlaneA]), "");
-    registers.emplace_back("Bits per Pixel Plane B",            0, as<int>(m_renderer.m_bps[PlaneB]), "");
-
-    registers.emplace_back("Image Coding Method Plane A",       ImageCodingMethod          + 0x80, as<int>(m_renderer.m_codingMethod[PlaneA]), "");
-    registers.emplace_back("Image Coding Method Plane B",       ImageCodingMethod          + 0x80, as<int>(m_renderer.m_codingMethod[PlaneB]), "");
-    registers.emplace_back("External Video",                    ImageCodingMethod          + 0x80, m_renderer.m_externalVideo, "");
-    registers.emplace_back("Number of regions",                 ImageCodingMethod          + 0x80, m_renderer.m_matteNumber, "");
-    registers.emplace_back("CLUT Select",                       ImageCodingMethod          + 0x80, m_renderer.m_clutSelectHigh, "");
-    registers.emplace_back("Transparency Control Plane A",      TransparencyControl        + 0x80, m_renderer.m_transparencyControl[PlaneA], "");
-    registers.emplace_back("Transparency Control Plane B",      TransparencyControl        + 0x80, m_renderer.m_transparencyControl[PlaneB], "");
-    registers.emplace_back("Mixing",                            TransparencyControl        + 0x80, m_renderer.m_mix, "");
-    registers.emplace_back("Plane Order",                       PlaneOrder                 + 0x80, m_renderer.m_planeOrder, "");
-    registers.emplace_back("CLUT Bank",                         CLUTBank                   + 0x80, m_renderer.m_clutBank, "");
-    registers.emplace_back("Transparent Color For Plane A",     TransparentColorForPlaneA  + 0x80, m_renderer.m_transparentColorRgb[PlaneA], "");
-    registers.emplace_back("Transparent Color For Plane B",     TransparentColorForPlaneB  + 0x80, m_renderer.m_transparentColorRgb[PlaneB], "");
-    registers.emplace_back("Mask Color For Plane A",            MaskColorForPlaneA         + 0x80, m_renderer.m_maskColorRgb[PlaneA], "");
-    registers.emplace_back("Mask Color For Plane B",            MaskColorForPlaneB         + 0x80, m_renderer.m_maskColorRgb[PlaneB], "");
-    registers.emplace_back("DYUV Abs Start Value For Plane A",  DYUVAbsStartValueForPlaneA + 0x80, m_renderer.m_dyuvInitialValue[PlaneA], "");
-    registers.emplace_back("DYUV Abs Start Value For Plane B",  DYUVAbsStartValueForPlaneB + 0x80, m_renderer.m_dyuvInitialValue[PlaneB], "");
-    registers.emplace_back("Cursor X Position",                 CursorPosition             + 0x80, m_renderer.m_cursorX, "");
-    registers.emplace_back("Cursor Y Position",                 CursorPosition             + 0x80, m_renderer.m_cursorY, "");
-    registers.emplace_back("Cursor Enabled",                    CursorControl              + 0x80, m_renderer.m_cursorEnabled, "");
-    registers.emplace_back("Cursor double resolution",          CursorControl              + 0x80, m_renderer.m_cursorDoubleResolution, "");
-    registers.emplace_back("Cursor color",                      CursorControl              + 0x80, m_renderer.m_cursorColor, "");
-    registers.emplace_back("Cursor blink type",                 CursorControl              + 0x80, m_renderer.m_cursorBlinkType, "");
-    registers.emplace_back("Cursor blink ON",                   CursorControl              + 0x80, m_renderer.m_cursorBlinkOn, "");
-    registers.emplace_back("Cursor blink OFF",                  CursorControl              + 0x80, m_renderer.m_cursorBlinkOff, "");
-
-    for(size_t i = 0; i < m_renderer.m_cursorPatterns.size(); i++)
-        registers.emplace_back("Cursor Pattern " + std::to_string(i), CursorPattern + 0x80, m_renderer.m_cursorPatterns[i], "");
-    for(uint32_t i = 0; i < m_renderer.m_matteControl.size(); i++)
-        registers.emplace_back("Region Control " + std::to_string(i), RegionControl + 0x80 + i, m_renderer.m_matteControl[i], "");
-
-    registers.emplace_back("Backdrop Color",                    BackdropColor              + 0x80, m_renderer.m_backdropColor, "");
-    registers.emplace_back("Mosaic Pixel Hold enabled Plane A", MosaicPixelHoldForPlaneA   + 0x80, m_renderer.m_holdEnabled[PlaneA], "");
-    registers.emplace_back("Mosaic Pixel Hold factor Plane A",  MosaicPixelHoldForPlaneA   + 0x80, m_renderer.m_holdFactor[PlaneA], "");
-    registers.emplace_back("Mosaic Pixel Hold enabled Plane B", MosaicPixelHoldForPlaneB   + 0x80, m_renderer.m_holdEnabled[PlaneB], "");
-    registers.emplace_back("Mosaic Pixel Hold factor Plane B",  MosaicPixelHoldForPlaneB   + 0x80, m_renderer.m_holdFactor[PlaneB], "");
-    registers.emplace_back("Weight Factor For Plane A",         WeightFactorForPlaneA      + 0x80, m_renderer.m_icf[PlaneA], "");
-    registers.emplace_back("Weight Factor For Plane B",         WeightFactorForPlaneB      + 0x80, m_renderer.m_icf[PlaneB], "");
+        registers.emplace_back("CLUT Color " + std::to_string(i), i, renderer.m_clut[i], "");
+
+    registers.emplace_back("Display format",                    0, as<int>(renderer.GetDisplayFormat()), "");
+    registers.emplace_back("Image type Plane A",                0, as<int>(renderer.m_imageType[PlaneA]), "");
+    registers.emplace_back("Image type Plane B",                0, as<int>(renderer.m_imageType[PlaneB]), "");
+    registers.emplace_back("Pixel repeat factor Plane A",       0, as<int>(renderer.m_pixelRepeatFactor[PlaneA]), "");
+    registers.emplace_back("Pixel repeat factor Plane B",       0, as<int>(renderer.m_pixelRepeatFactor[PlaneB]), "");
+    registers.emplace_back("Bits per Pixel Plane A",            0, as<int>(renderer.m_bps[PlaneA]), "");
+    registers.emplace_back("Bits per Pixel Plane B",            0, as<int>(renderer.m_bps[PlaneB]), "");
+
+    registers.emplace_back("Image Coding Method Plane A",       ImageCodingMethod          + 0x80, as<int>(renderer.m_codingMethod[PlaneA]), "");
+    registers.emplace_back("Image Coding Method Plane B",       ImageCodingMethod          + 0x80, as<int>(renderer.m_codingMethod[PlaneB]), "");
+    registers.emplace_back("External Video",                    ImageCodingMethod          + 0x80, renderer.m_externalVideo, "");
+    registers.emplace_back("Number of regions",                 ImageCodingMethod          + 0x80, renderer.m_matteNumber, "");
+    registers.emplace_back("CLUT Select",                       ImageCodingMethod          + 0x80, renderer.m_clutSelectHigh, "");
+    registers.emplace_back("Transparency Control Plane A",      TransparencyControl        + 0x80, renderer.m_transparencyControl[PlaneA], "");
+    registers.emplace_back("Transparency Control Plane B",      TransparencyControl        + 0x80, renderer.m_transparencyControl[PlaneB], "");
+    registers.emplace_back("Mixing",                            TransparencyControl        + 0x80, renderer.m_mix, "");
+    registers.emplace_back("Plane Order",                       PlaneOrder                 + 0x80, renderer.m_planeOrder, "");
+    registers.emplace_back("CLUT Bank",                         CLUTBank                   + 0x80, renderer.m_clutBank, "");
+    registers.emplace_back("Transparent Color For Plane A",     TransparentColorForPlaneA  + 0x80, renderer.m_transparentColorRgb[PlaneA], "");
+    registers.emplace_back("Transparent Color For Plane B",     TransparentColorForPlaneB  + 0x80, renderer.m_transparentColorRgb[PlaneB], "");
+    registers.emplace_back("Mask Color For Plane A",            MaskColorForPlaneA         + 0x80, renderer.m_maskColorRgb[PlaneA], "");
+    registers.emplace_back("Mask Color For Plane B",            MaskColorForPlaneB         + 0x80, renderer.m_maskColorRgb[PlaneB], "");
+    registers.emplace_back("DYUV Abs Start Value For Plane A",  DYUVAbsStartValueForPlaneA + 0x80, renderer.m_dyuvInitialValue[PlaneA], "");
+    registers.emplace_back("DYUV Abs Start Value For Plane B",  DYUVAbsStartValueForPlaneB + 0x80, renderer.m_dyuvInitialValue[PlaneB], "");
+    registers.emplace_back("Cursor X Position",                 CursorPosition             + 0x80, renderer.m_cursorX, "");
+    registers.emplace_back("Cursor Y Position",                 CursorPosition             + 0x80, renderer.m_cursorY, "");
+    registers.emplace_back("Cursor Enabled",                    CursorControl              + 0x80, renderer.m_cursorEnabled, "");
+    registers.emplace_back("Cursor double resolution",          CursorControl              + 0x80, renderer.m_cursorDoubleResolution, "");
+    registers.emplace_back("Cursor color",                      CursorControl              + 0x80, renderer.m_cursorColor, "");
+    registers.emplace_back("Cursor blink type",                 CursorControl              + 0x80, renderer.m_cursorBlinkType, "");
+    registers.emplace_back("Cursor blink ON",                   CursorControl              + 0x80, renderer.m_cursorBlinkOn, "");
+    registers.emplace_back("Cursor blink OFF",                  CursorControl              + 0x80, renderer.m_cursorBlinkOff, "");
+
+    for(size_t i = 0; i < renderer.m_cursorPatterns.size(); i++)
+        registers.emplace_back("Cursor Pattern " + std::to_string(i), CursorPattern + 0x80, renderer.m_cursorPatterns[i], "");
+    for(uint32_t i = 0; i < renderer.m_matteControl.size(); i++)
+        registers.emplace_back("Region Control " + std::to_string(i), RegionControl + 0x80 + i, renderer.m_matteControl[i], "");
+
+    registers.emplace_back("Backdrop Color",                    BackdropColor              + 0x80, renderer.m_backdropColor, "");
+    registers.emplace_back("Mosaic Pixel Hold enabled Plane A", MosaicPixelHoldForPlaneA   + 0x80, renderer.m_holdEnabled[PlaneA], "");
+    registers.emplace_back("Mosaic Pixel Hold factor Plane A",  MosaicPixelHoldForPlaneA   + 0x80, renderer.m_holdFactor[PlaneA], "");
+    registers.emplace_back("Mosaic Pixel Hold enabled Plane B", MosaicPixelHoldForPlaneB   + 0x80, renderer.m_holdEnabled[PlaneB], "");
+    registers.emplace_back("Mosaic Pixel Hold factor Plane B",  MosaicPixelHoldForPlaneB   + 0x80, renderer.m_holdFactor[PlaneB], "");
+    registers.emplace_back("Weight Factor For Plane A",         WeightFactorForPlaneA      + 0x80, renderer.m_icf[PlaneA], "");
+    registers.emplace_back("Weight Factor For Plane B",         WeightFactorForPlaneB      + 0x80, renderer.m_icf[PlaneB], "");
 
     return registers;
 }
@@ -80,8 +80,13 @@ void SCC68070::Interpreter()
         if(find(breakpoints.begin(), breakpoints.end(), currentPC) != breakpoints.end())
             m_loop = false;
 
-        start += std::chrono::duration<double, std::nano>(executionCycles * m_speedDelay);
-        std::this_thread::sleep_until(start);
+        if(m_speedDelay > 0.0)
+        {
+            start += std::chrono::duration<double, std::nano>(executionCycles * m_speedDelay);
+            std::this_thread::sleep_until(start);
+        }
+        else // Unthrottled, keep the reference up to date in case the speed is limited again.
+            start = std::chrono::steady_clock::now();
     } while(m_loop);
 
     m_isRunning = false;
@@ -65,6 +65,7 @@ bool SCC68070::IsRunning() const
  * This method only changes the emulation speed, not the clock frequency.
  * A multiplier of 2 will make the CPU runs twice as fast, the GPU to run at twice the framerate,
  * the timekeeper to increment twice as fast, etc.
+ * An infinite multiplier (\ref UNTHROTTLED) runs the emulation as fast as the host can.
  */
 void SCC68070::SetEmulationSpeed(const double speed)
 {
@@ -9,6 +9,7 @@ class CDI;
 #include <atomic>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <map>
 #include <mutex>
 #include <queue>
@@ -132,6 +133,8 @@ public:
 
     std::vector<uint32_t> breakpoints;
 
+    static constexpr double UNTHROTTLED = std::numeric_limits<double>::infinity(); /**< Speed that disables the emulation speed limit. */
+
     SCC68070(CDI& idc, uint32_t clockFrequency);
     ~SCC68070();
 
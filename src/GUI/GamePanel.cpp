@@ -23,7 +23,14 @@ GamePanel::GamePanel(MainFrame* parent, CeDImu& cedimu)
 {
     SetDoubleBuffered(true);
 
-    m_cedimu.SetOnFrameCompleted([this] (const Video::Plane& plane) {
+    // The frame itself is acquired from CDI::m_frames when painting, so the emulation thread does not wait on the GUI.
+    m_cedimu.SetOnFrameCompleted([this] (const Video::Plane& frame) {
+        {
+            std::lock_guard<std::mutex> lock(m_recorderMutex);
+            if(m_recorder)
+                m_recorder->PushFrame(frame);
+        }
+
         if(m_mainFrame->m_cpuViewer != nullptr)
             m_mainFrame->m_cpuViewer->m_flushInstructions = true;
 
@@ -36,18 +43,14 @@ GamePanel::GamePanel(MainFrame* parent, CeDImu& cedimu)
             this->m_mainFrame->m_pauseMenuItem->Check();
         }
 
-        std::lock_guard<std::mutex> __(this->m_screenMutex);
-        if(this->m_screen.Create(plane.m_width, plane.m_height))
-        {
-            splitARGB(plane.GetSpan(), nullptr, this->m_screen.GetData());
-            this->Refresh();
-        }
+        this->Refresh();
     });
 }
 
 GamePanel::~GamePanel()
 {
     m_cedimu.SetOnFrameCompleted(nullptr);
+    StopRecording();
 }
 
 void GamePanel::Reset()
@@ -63,12 +66,57 @@ bool GamePanel::SaveScreenshot(const std::string& file)
     if(!m_cedimu.m_cdi)
         return false;
 
+    UpdateScreen();
     std::lock_guard<std::mutex> lock2(m_screenMutex);
     return m_screen.SaveFile(file, wxBITMAP_TYPE_PNG);
 }
 
+bool GamePanel::StartRecording(const std::string& file, const Video::RecordingFormat format)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_cedimu.m_cdiMutex);
+    if(!m_cedimu.m_cdi)
+        return false;
+
+    const bool pal = m_cedimu.m_cdi->m_config.PAL;
+    std::unique_ptr<Video::FrameRecorder> recorder = std::make_unique<Video::FrameRecorder>(file, format, pal ? 50 : 60000, pal ? 1 : 1001);
+    if(!recorder->IsGood())
+        return false;
+
+    std::lock_guard<std::mutex> lock2(m_recorderMutex);
+    m_recorder = std::move(recorder);
+    return true;
+}
+
+std::unique_ptr<Video::FrameRecorder> GamePanel::StopRecording()
+{
+    std::unique_ptr<Video::FrameRecorder> recorder;
+    {
+        std::lock_guard<std::mutex> lock(m_recorderMutex);
+        recorder = std::move(m_recorder);
+    }
+
+    // The pending frames are written without blocking the emulation thread.
+    if(recorder)
+        recorder->Stop();
+    return recorder;
+}
+
+void GamePanel::UpdateScreen()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_cedimu.m_cdiMutex);
+    if(!m_cedimu.m_cdi || !m_cedimu.m_cdi->m_frames.HasNewFrame())
+        return;
+
+    const Video::Plane& frame = m_cedimu.m_cdi->m_frames.Acquire();
+    std::lock_guard<std::mutex> lock2(m_screenMutex);
+    if(m_screen.Create(frame.m_width, frame.m_height))
+        splitARGB(frame.GetSpan(), nullptr, m_screen.GetData());
+}
+
 void GamePanel::DrawScreen(wxDC& dc)
 {
+    UpdateScreen();
+
     dc.Clear();
     std::lock_guard<std::mutex> lock(m_screenMutex);
     if(m_screen.IsOk())
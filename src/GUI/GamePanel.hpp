@@ -3,11 +3,13 @@
 
 class MainFrame;
 #include "../CeDImu.hpp"
+#include "../CDI/Video/FrameRecorder.hpp"
 
 #include <wx/image.h>
 #include <wx/dc.h>
 #include <wx/panel.h>
 
+#include <memory>
 #include <mutex>
 
 class GamePanel : public wxPanel
@@ -18,6 +20,8 @@ public:
     std::mutex m_screenMutex;
     wxImage m_screen;
     bool m_stopOnNextFrame;
+    std::mutex m_recorderMutex;
+    std::unique_ptr<Video::FrameRecorder> m_recorder;
 
     GamePanel() = delete;
     GamePanel(MainFrame* parent, CeDImu& cedimu);
@@ -25,7 +29,10 @@ public:
 
     void Reset();
     bool SaveScreenshot(const std::string& file);
+    bool StartRecording(const std::string& file, Video::RecordingFormat format);
+    std::unique_ptr<Video::FrameRecorder> StopRecording();
 
+    void UpdateScreen();
     void DrawScreen(wxDC& dc);
     void OnPaintEvent(wxPaintEvent&);
 
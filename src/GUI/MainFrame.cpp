@@ -15,6 +15,7 @@
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
 
+#include <array>
 #include <filesystem>
 
 wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
@@ -23,6 +24,7 @@ wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_MENU(IDMainFrameOnOpenDisc, MainFrame::OnOpenDisc)
     EVT_MENU(IDMainFrameOnCloseDisc, MainFrame::OnCloseDisc)
     EVT_MENU(IDMainFrameOnScreenshot, MainFrame::OnScreenshot)
+    EVT_MENU(IDMainFrameOnRecord, MainFrame::OnRecord)
     EVT_MENU(wxID_EXIT, MainFrame::OnExit)
     EVT_MENU(IDMainFrameOnPause, MainFrame::OnPause)
     EVT_MENU(IDMainFrameOnSingleStep, MainFrame::OnSingleStep)
@@ -77,6 +79,7 @@ void MainFrame::CreateMenuBar()
     m_fileMenu->Append(IDMainFrameOnCloseDisc, "Close disc\tCtrl+C");
     m_fileMenu->AppendSeparator();
     m_fileMenu->Append(IDMainFrameOnScreenshot, "Take screenshot\tCtrl+Shift+S", "Save to file the current frame");
+    m_recordMenuItem = m_fileMenu->AppendCheckItem(IDMainFrameOnRecord, "Record video\tCtrl+Shift+R", "Save to file every frame until unchecked");
     m_fileMenu->AppendSeparator();
     m_fileMenu->Append(wxID_EXIT, "Exit", "Exits CeDImu");
     menuBar->Append(m_fileMenu, "File");
@@ -236,6 +239,34 @@ void MainFrame::OnScreenshot(wxCommandEvent&)
         m_cedimu.StartEmulation();
 }
 
+void MainFrame::OnRecord(wxCommandEvent&)
+{
+    if(!m_recordMenuItem->IsChecked())
+    {
+        std::unique_ptr<Video::FrameRecorder> recorder = m_gamePanel->StopRecording();
+        if(recorder)
+            SetStatusText("Recorded " + std::to_string(recorder->GetWrittenFrames()) + " frames (" + std::to_string(recorder->GetDroppedFrames()) + " dropped)");
+        return;
+    }
+
+    m_recordMenuItem->Check(false);
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_cedimu.m_cdiMutex);
+        if(!m_cedimu.m_cdi)
+            return;
+    }
+
+    constexpr std::array<Video::RecordingFormat, 3> formats{Video::RecordingFormat::Y4M, Video::RecordingFormat::Raw, Video::RecordingFormat::DeltaRLE};
+    wxFileDialog fileDlg(this, wxFileSelectorPromptStr, wxEmptyString, "recording", "YUV4MPEG2 (*.y4m)|*.y4m|Raw BGRA32 with .idx index (*.raw)|*.raw|Lossless delta-RLE (*.drle)|*.drle", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if(fileDlg.ShowModal() != wxID_OK)
+        return;
+
+    if(m_gamePanel->StartRecording(fileDlg.GetPath().ToStdString(), formats.at(fileDlg.GetFilterIndex())))
+        m_recordMenuItem->Check();
+    else
+        wxMessageBox("Failed to start recording");
+}
+
 void MainFrame::OnExit(wxCommandEvent&)
 {
     Close();
@@ -24,6 +24,7 @@ public:
     wxMenuItem* m_startBiosMenuItem;
     wxMenuItem* m_reloadCoreMenuItem;
     wxMenuItem* m_pauseMenuItem;
+    wxMenuItem* m_recordMenuItem;
 
     GamePanel* m_gamePanel;
     CPUViewer* m_cpuViewer;
@@ -48,6 +49,7 @@ public:
     void OnOpenDisc(wxCommandEvent&);
     void OnCloseDisc(wxCommandEvent&);
     void OnScreenshot(wxCommandEvent&);
+    void OnRecord(wxCommandEvent&);
     void OnExit(wxCommandEvent&);
     void OnClose(wxCloseEvent&);
 
@@ -358,6 +358,11 @@ void VDSCViewer::OnClose(wxCloseEvent&)
 {
     m_updateTimer.Stop();
     m_cedimu.SetOnLogICADCA(nullptr);
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_cedimu.m_cdiMutex);
+        if(m_cedimu.m_cdi)
+            m_cedimu.m_cdi->SetVDSCPlanesRetained(false);
+    }
     Destroy();
 }
 
@@ -478,6 +483,10 @@ void VDSCViewer::UpdatePanels()
     if(!m_cedimu.m_cdi)
         return;
 
+    // Requested on every update because the CDI may have been recreated since the viewer has been opened.
+    // The planes are available from the next frame.
+    m_cedimu.m_cdi->SetVDSCPlanesRetained(true);
+
     std::lock_guard<std::mutex> lock2(m_imgMutex);
 
     const Video::Plane& planeA = m_cedimu.m_cdi->GetPlaneA();
@@ -8,6 +8,7 @@ enum
     IDMainFrameOnOpenDisc = wxID_HIGHEST + 1,
     IDMainFrameOnCloseDisc,
     IDMainFrameOnScreenshot,
+    IDMainFrameOnRecord,
     IDMainFrameOnPause,
     IDMainFrameOnSingleStep,
     IDMainFrameOnFrameAdvance,
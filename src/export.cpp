@@ -1,5 +1,6 @@
 #include "export.hpp"
 #include "CDI/common/utils.hpp"
+#include "Video/PixelFormats.hpp"
 #include "Video/VideoDecoders.hpp"
 
 #include <wx/bitmap.h>
@@ -25,32 +26,11 @@ static constexpr Video::ImageCodingMethod codingLookUp[16] = {
  */
 void splitARGB(std::span<const Video::Pixel> pixels, uint8_t* alpha, uint8_t* rgb)
 {
-    if(alpha != nullptr && rgb != nullptr)
-    {
-        for(const Video::Pixel& pixel : pixels)
-        {
-            *alpha++ = pixel.a;
-            *rgb++ = pixel.r;
-            *rgb++ = pixel.g;
-            *rgb++ = pixel.b;
-        }
-    }
-    else if(alpha != nullptr)
-    {
-        for(const Video::Pixel& pixel : pixels)
-        {
-            *alpha++ = pixel.a;
-        }
-    }
-    else if(rgb != nullptr)
-    {
-        for(const Video::Pixel& pixel : pixels)
-        {
-            *rgb++ = pixel.r;
-            *rgb++ = pixel.g;
-            *rgb++ = pixel.b;
-        }
-    }
+    if(alpha != nullptr)
+        Video::convertToAlpha8(pixels, alpha);
+
+    if(rgb != nullptr)
+        Video::convertToRGB24(pixels, rgb);
 }
 
 /** \brief Tries to decode the video data of the sectors to a file.
@@ -76,7 +56,7 @@ void exportVideo(CDIDisc& disc, std::string exportDir)
         std::array<VideoInfo, MAX_CHANNEL_NUMBER> video{};
         std::array<uint32_t, 256> CLUT{};
 
-        file.ForEachSector([&] (const CDISector& sector) {
+        file.ForEachSector([&] (const SectorView& sector) {
             if(sector.subheader.submode & cdid) // Get CLUT table from a sector before the video data.
             {
                 const char* clut = as<const char*>(subarrayOfArray(sector.data.data(), sector.data.size(), "cluts", 5));
@@ -0,0 +1,171 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <common/Audio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+/** \brief Returns a sector of pseudo-random data, including reserved ranges and filters. */
+static std::array<uint8_t, Audio::SECTOR_DATA_SIZE> makeSector(uint32_t& seed)
+{
+    std::array<uint8_t, Audio::SECTOR_DATA_SIZE> sector{};
+    for(uint8_t& byte : sector)
+    {
+        seed = seed * 1'103'515'245 + 12'345;
+        byte = seed >> 16;
+    }
+    return sector;
+}
+
+static void checkDecoder(const bool levelA, const bool stereo)
+{
+    uint32_t seed = 1;
+    Audio::SamplesDelay referenceDelay{};
+    Audio::SamplesDelay delay{};
+    std::vector<int16_t> referenceLeft;
+    std::vector<int16_t> referenceRight;
+    std::array<int16_t, Audio::LEVEL_BC_SECTOR_SAMPLES> left{};
+    std::array<int16_t, Audio::LEVEL_BC_SECTOR_SAMPLES> right{};
+
+    for(size_t s = 0; s < 64; ++s)
+    {
+        const std::array<uint8_t, Audio::SECTOR_DATA_SIZE> sector = makeSector(seed);
+        referenceLeft.clear();
+        referenceRight.clear();
+        Audio::decodeAudioSector(referenceDelay, levelA, stereo, sector.data(), referenceLeft, referenceRight);
+
+        const size_t samples = Audio::decodeAudioSector(delay, levelA, stereo, sector, left, right);
+        REQUIRE(samples == referenceLeft.size());
+        REQUIRE(std::equal(referenceLeft.begin(), referenceLeft.end(), left.begin()));
+        if(stereo)
+        {
+            REQUIRE(samples == referenceRight.size());
+            REQUIRE(std::equal(referenceRight.begin(), referenceRight.end(), right.begin()));
+        }
+    }
+}
+
+TEST_CASE("ADPCM decoder", "[Audio]")
+{
+    SECTION("Level A mono")
+    {
+        checkDecoder(true, false);
+    }
+
+    SECTION("Level A stereo")
+    {
+        checkDecoder(true, true);
+    }
+
+    SECTION("Level B/C mono")
+    {
+        checkDecoder(false, false);
+    }
+
+    SECTION("Level B/C stereo")
+    {
+        checkDecoder(false, true);
+    }
+
+    SECTION("Too small destination")
+    {
+        uint32_t seed = 1;
+        Audio::SamplesDelay delay{};
+        std::array<int16_t, Audio::LEVEL_A_SECTOR_SAMPLES / 2> left{};
+        std::array<int16_t, Audio::LEVEL_A_SECTOR_SAMPLES / 2> right{};
+        REQUIRE(Audio::decodeAudioSector(delay, true, true, makeSector(seed), left, right) == left.size());
+        REQUIRE(Audio::decodeAudioSector(delay, true, false, makeSector(seed), left, right) == 0);
+        REQUIRE(Audio::decodeAudioSector(delay, false, true, makeSector(seed), left, right) == 0);
+    }
+}
+
+/** \brief Returns the content of a file. */
+static std::vector<uint8_t> readFile(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+template<typename T>
+static T readLE(const std::vector<uint8_t>& data, const size_t offset)
+{
+    T value = 0;
+    for(size_t i = 0; i < sizeof(T); ++i)
+        value |= static_cast<T>(data[offset + i]) << (i * 8);
+    return value;
+}
+
+TEST_CASE("WAV writer", "[Audio]")
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "cedimu_test_audio.wav";
+
+    // More than a block, written in several parts.
+    std::vector<int16_t> left(Audio::WAVWriter::BLOCK_SAMPLES * 2 + 100);
+    std::vector<int16_t> right(left.size());
+    for(size_t i = 0; i < left.size(); ++i)
+    {
+        left[i] = i;
+        right[i] = -static_cast<int16_t>(i);
+    }
+
+    SECTION("Interleave")
+    {
+        std::vector<int16_t> interleaved(left.size() * 2);
+        Audio::interleaveSamples(left, right, interleaved);
+        for(size_t i = 0; i < left.size(); ++i)
+        {
+            REQUIRE(interleaved[2 * i] == left[i]);
+            REQUIRE(interleaved[2 * i + 1] == right[i]);
+        }
+    }
+
+    SECTION("Stereo")
+    {
+        {
+            Audio::WAVWriter wav(path, {2, 37800});
+            REQUIRE(wav.IsOpen());
+            REQUIRE(wav.Write(std::span(left).first(10), std::span(right).first(10)));
+            REQUIRE(wav.Write(std::span(left).subspan(10), std::span(right).subspan(10)));
+            REQUIRE(wav.GetDataSize() == left.size() * 4);
+            REQUIRE(wav.Close());
+            REQUIRE_FALSE(wav.IsOpen());
+        }
+
+        const std::vector<uint8_t> data = readFile(path);
+        REQUIRE(data.size() == Audio::WAVWriter::HEADER_SIZE + left.size() * 4);
+        REQUIRE(std::memcmp(data.data(), "RIFF", 4) == 0);
+        REQUIRE(readLE<uint32_t>(data, 4) == data.size() - 8);
+        REQUIRE(readLE<uint16_t>(data, 22) == 2);
+        REQUIRE(readLE<uint32_t>(data, 24) == 37800);
+        REQUIRE(readLE<uint32_t>(data, 28) == 37800 * 4);
+        REQUIRE(readLE<uint32_t>(data, 40) == left.size() * 4);
+        for(size_t i = 0; i < left.size(); ++i)
+        {
+            REQUIRE(readLE<uint16_t>(data, Audio::WAVWriter::HEADER_SIZE + i * 4) == static_cast<uint16_t>(left[i]));
+            REQUIRE(readLE<uint16_t>(data, Audio::WAVWriter::HEADER_SIZE + i * 4 + 2) == static_cast<uint16_t>(right[i]));
+        }
+    }
+
+    SECTION("Mono")
+    {
+        {
+            Audio::WAVWriter wav(path, {1, 18900});
+            REQUIRE(wav.Write(left, {}));
+        } // Closed by the destructor.
+
+        const std::vector<uint8_t> data = readFile(path);
+        REQUIRE(data.size() == Audio::WAVWriter::HEADER_SIZE + left.size() * 2);
+        REQUIRE(readLE<uint32_t>(data, 4) == data.size() - 8);
+        REQUIRE(readLE<uint16_t>(data, 22) == 1);
+        REQUIRE(readLE<uint32_t>(data, 40) == left.size() * 2);
+        for(size_t i = 0; i < left.size(); ++i)
+            REQUIRE(readLE<uint16_t>(data, Audio::WAVWriter::HEADER_SIZE + i * 2) == static_cast<uint16_t>(left[i]));
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <CDDrive.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+static constexpr uint32_t SECTOR_COUNT = 100;
+static constexpr double PERIOD = CDDrive::SECTOR_PERIOD;
+
+/** \brief Advances the time of the drive by a sector period until it delivers a sector.
+ * \return true if the sector was late.
+ */
+static bool deliver(CDDrive& drive)
+{
+    bool late = false;
+    while(!drive.IncrementTime(PERIOD))
+    {
+        late = true;
+        std::this_thread::yield();
+    }
+    return late;
+}
+
+/** \brief Lets the reader thread fill the ring. */
+static void waitReadAhead()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+TEST_CASE("CD drive", "[CDDrive]")
+{
+    // Each sector is filled with its number.
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "cedimu_test_drive.bin";
+    {
+        std::ofstream out(path, std::ios::out | std::ios::binary);
+        for(uint32_t lbn = 0; lbn < SECTOR_COUNT; lbn++)
+        {
+            std::array<char, SECTOR_SIZE> sector;
+            sector.fill(lbn);
+            out.write(sector.data(), sector.size());
+        }
+    }
+
+    CDDrive drive;
+    REQUIRE(drive.Open(path));
+    REQUIRE_FALSE(drive.IsPlaying());
+    REQUIRE_FALSE(drive.IncrementTime(PERIOD));
+
+    const auto requireSector = [&drive] (const uint32_t lbn) {
+        const DriveSector* sector = drive.GetCurrentSector();
+        REQUIRE(sector != nullptr);
+        REQUIRE(sector->lbn == lbn);
+        REQUIRE(sector->data[0] == lbn);
+        REQUIRE(sector->data[SECTOR_SIZE - 1] == lbn);
+    };
+
+    SECTION("Delivery timing")
+    {
+        drive.Play(0);
+        REQUIRE(drive.IsPlaying());
+        const uint64_t underruns = deliver(drive);
+        requireSector(0);
+        waitReadAhead();
+
+        REQUIRE_FALSE(drive.IncrementTime(PERIOD / 2));
+        REQUIRE(drive.IncrementTime(PERIOD / 2));
+        requireSector(1);
+
+        for(uint32_t lbn = 2; lbn < 10; lbn++)
+        {
+            REQUIRE(drive.IncrementTime(PERIOD));
+            requireSector(lbn);
+        }
+
+        drive.SetSpeed(DriveSpeed::Double);
+        REQUIRE(drive.IncrementTime(PERIOD / 2));
+        requireSector(10);
+
+        drive.Pause();
+        REQUIRE_FALSE(drive.IncrementTime(PERIOD));
+        requireSector(10);
+
+        REQUIRE(drive.GetUnderruns() == underruns);
+    }
+
+    SECTION("Seek discard")
+    {
+        drive.Play(0);
+        deliver(drive);
+        requireSector(0);
+        waitReadAhead(); // The ring is full of the sectors after 0.
+
+        drive.Play(50);
+        REQUIRE(drive.GetCurrentSector() == nullptr);
+        deliver(drive);
+        requireSector(50);
+        deliver(drive);
+        requireSector(51);
+
+        // Resuming where the drive has been paused is not a seek.
+        drive.Pause();
+        drive.Play(52);
+        requireSector(51);
+        deliver(drive);
+        requireSector(52);
+
+        // The drive stops after the last sector.
+        drive.Play(SECTOR_COUNT - 1);
+        deliver(drive);
+        requireSector(SECTOR_COUNT - 1);
+        REQUIRE_FALSE(drive.IncrementTime(PERIOD));
+        REQUIRE_FALSE(drive.IsPlaying());
+    }
+
+    SECTION("Underruns")
+    {
+        // Right after a seek the reader thread has most likely not read the sector yet.
+        uint64_t underruns = 0;
+        for(uint32_t lbn = 0; lbn < SECTOR_COUNT; lbn += 10)
+        {
+            drive.Play(lbn);
+            underruns += deliver(drive); // A late sector is counted once, however many times the time is advanced.
+            requireSector(lbn);
+            REQUIRE(drive.GetUnderruns() == underruns);
+
+            // A late sector starts a new period.
+            REQUIRE_FALSE(drive.IncrementTime(PERIOD / 2));
+        }
+    }
+
+    drive.Close();
+    REQUIRE_FALSE(drive.IsOpen());
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <DiscImage.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+static constexpr uint32_t SECTOR_COUNT = 20;
+
+/** \brief Writes a raw disc image, each sector is filled with its number and some noise. */
+static std::vector<uint8_t> writeRawImage(const std::filesystem::path& path, const size_t size)
+{
+    std::vector<uint8_t> image(size);
+    uint32_t noise = 0x1234'5678;
+    for(size_t i = 0; i < size; i++)
+    {
+        noise = noise * 1'103'515'245 + 12'345;
+        const size_t lbn = i / SECTOR_SIZE;
+        image[i] = lbn % 2 ? noise >> 24 : lbn; // Odd sectors do not compress.
+    }
+
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    out.write(reinterpret_cast<const char*>(image.data()), image.size());
+    return image;
+}
+
+/** \brief Writes a compressed image header. */
+static void writeHeader(const std::filesystem::path& path, const uint32_t hunkSectors, const uint32_t hunkCount, const uint64_t imageSize)
+{
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    out.write(DiscImage::COMPRESSED_MAGIC.data(), DiscImage::COMPRESSED_MAGIC.size());
+    const auto write = [&out] (const uint64_t value, const size_t size) {
+        for(size_t i = 0; i < size; i++)
+            out.put(value >> (i * 8));
+    };
+    write(hunkSectors, 4);
+    write(hunkCount, 4);
+    write(imageSize, 8);
+    write(DiscImage::COMPRESSED_MAGIC.size() + 24, 8); // Table right after the header.
+    for(uint32_t i = 0; i < hunkCount; i++)
+        write(0, 12);
+}
+
+TEST_CASE("Raw disc image", "[DiscImage]")
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "cedimu_test_raw.bin";
+    const std::vector<uint8_t> data = writeRawImage(path, SECTOR_COUNT * SECTOR_SIZE + 100);
+
+    DiscImage image;
+    REQUIRE(image.Open(path));
+    REQUIRE_FALSE(image.IsCompressed());
+    REQUIRE(image.GetSize() == data.size());
+    REQUIRE(image.GetSectorCount() == SECTOR_COUNT); // The trailing partial sector is ignored.
+    REQUIRE(image.GetSector(SECTOR_COUNT).empty());
+
+    const std::span<const uint8_t> sector = image.GetSector(3);
+    REQUIRE(std::equal(sector.begin(), sector.end(), &data[3 * SECTOR_SIZE]));
+
+    image.Close();
+    std::filesystem::remove(path);
+}
+
+#ifdef LIBCEDIMU_ENABLE_ZLIB
+TEST_CASE("Compressed disc image", "[DiscImage]")
+{
+    const std::filesystem::path rawPath = std::filesystem::temp_directory_path() / "cedimu_test_compress.bin";
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "cedimu_test_compress.cdiz";
+
+    SECTION("Round trip")
+    {
+        for(const uint32_t hunkSectors : {1u, 3u, DiscImage::DEFAULT_HUNK_SECTORS})
+        {
+            const std::vector<uint8_t> data = writeRawImage(rawPath, SECTOR_COUNT * SECTOR_SIZE + 100);
+            REQUIRE(compressDiscImage(rawPath, path, hunkSectors));
+
+            DiscImage image;
+            REQUIRE(image.Open(path));
+            REQUIRE(image.IsCompressed());
+            REQUIRE(image.GetSize() == data.size());
+            REQUIRE(image.GetSectorCount() == SECTOR_COUNT);
+
+            // Backwards so the read-ahead is not used, then in order.
+            for(uint32_t lbn = SECTOR_COUNT; lbn-- > 0;)
+            {
+                const std::span<const uint8_t> sector = image.GetSector(lbn);
+                REQUIRE(sector.size() == SECTOR_SIZE);
+                REQUIRE(std::equal(sector.begin(), sector.end(), &data[lbn * SECTOR_SIZE]));
+            }
+            for(uint32_t lbn = 0; lbn < SECTOR_COUNT; lbn++)
+            {
+                const std::span<const uint8_t> sector = image.GetSector(lbn);
+                REQUIRE(sector.size() == SECTOR_SIZE);
+                REQUIRE(std::equal(sector.begin(), sector.end(), &data[lbn * SECTOR_SIZE]));
+            }
+
+            // Across hunks and up to the trailing partial sector.
+            std::vector<uint8_t> bytes(3 * SECTOR_SIZE + 200);
+            REQUIRE(image.Read(data.size() - bytes.size(), bytes));
+            REQUIRE(std::equal(bytes.begin(), bytes.end(), data.end() - bytes.size()));
+            REQUIRE_FALSE(image.Read(data.size() - 10, bytes));
+        }
+    }
+
+    SECTION("LRU cache")
+    {
+        writeRawImage(rawPath, SECTOR_COUNT * SECTOR_SIZE);
+        REQUIRE(compressDiscImage(rawPath, path, 1));
+
+        // Cache of READ_AHEAD_HUNKS hunks.
+        DiscImage image;
+        REQUIRE(image.Open(path, 0));
+
+        std::array<const uint8_t*, DiscImage::READ_AHEAD_HUNKS> sectors;
+        for(uint32_t lbn = 0; lbn < sectors.size(); lbn++)
+            sectors[lbn] = image.GetSector(lbn).data();
+
+        // Reading a cached sector does not decompress it again and makes it the most recently used.
+        REQUIRE(image.GetSector(0).data() == sectors[0]);
+        for(uint32_t lbn = sectors.size(); lbn < sectors.size() + sectors.size() - 1; lbn++)
+            image.GetSector(lbn);
+        REQUIRE(image.GetSector(0).data() == sectors[0]);
+    }
+
+    SECTION("Invalid headers")
+    {
+        const uint32_t hunkSize = DiscImage::DEFAULT_HUNK_SECTORS * SECTOR_SIZE;
+        DiscImage image;
+
+        writeHeader(path, 0, 1, hunkSize);
+        REQUIRE_FALSE(image.Open(path));
+
+        writeHeader(path, DiscImage::MAX_HUNK_SECTORS + 1, 1, SECTOR_SIZE);
+        REQUIRE_FALSE(image.Open(path));
+
+        const uint64_t tooBig = (DiscImage::MAX_SECTORS + 1ull) * SECTOR_SIZE;
+        writeHeader(path, DiscImage::MAX_HUNK_SECTORS, (tooBig + DiscImage::MAX_HUNK_SECTORS * SECTOR_SIZE - 1) / (DiscImage::MAX_HUNK_SECTORS * SECTOR_SIZE), tooBig);
+        REQUIRE_FALSE(image.Open(path));
+
+        writeHeader(path, DiscImage::DEFAULT_HUNK_SECTORS, 2, hunkSize); // Wrong hunk count.
+        REQUIRE_FALSE(image.Open(path));
+
+        writeHeader(path, DiscImage::DEFAULT_HUNK_SECTORS, 1, hunkSize); // Empty hunk.
+        REQUIRE_FALSE(image.Open(path));
+    }
+
+    std::filesystem::remove(rawPath);
+    std::filesystem::remove(path);
+}
+#endif // LIBCEDIMU_ENABLE_ZLIB
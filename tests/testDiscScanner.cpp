@@ -0,0 +1,229 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <CDIDisc.hpp>
+#include <DiscScanner.hpp>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/** \brief Returns a catalogue of one disc with one file. */
+static std::vector<DiscCatalogueEntry> makeCatalogue(const std::string& gameName, const std::string& fileName)
+{
+    DiscCatalogueEntry entry{};
+    entry.path = "disc.bin";
+    entry.fileSize = 2352;
+    entry.opened = true;
+    entry.gameName = gameName;
+    entry.mainModule = "cdi_main";
+    entry.sectors = {1, 1, 0, 0, 0, 0, 0, 0, 1};
+    entry.files.push_back({fileName, 20, 2048, 0x1F, 1});
+    return {entry};
+}
+
+/** \brief Writes a minimal CD-I disc image: a volume descriptor, a path table, the root directory with the main
+ * module and a subdirectory with an audio file.
+ */
+static void writeCDIImage(const std::filesystem::path& path)
+{
+    constexpr size_t DATA_OFFSET = 24;
+    std::vector<std::array<uint8_t, 2352>> sectors(22);
+    const auto setSubmode = [&sectors] (const size_t lbn, const uint8_t submode) {
+        sectors[lbn][15] = 2; // Mode 2.
+        sectors[lbn][18] = sectors[lbn][22] = submode;
+    };
+    const auto putString = [] (uint8_t* dst, const std::string& str, const size_t size) {
+        std::fill_n(dst, size, ' ');
+        std::copy(str.begin(), str.end(), dst);
+    };
+    const auto putLong = [] (uint8_t* dst, const uint32_t value) {
+        dst[0] = value >> 24;
+        dst[1] = value >> 16;
+        dst[2] = value >> 8;
+        dst[3] = value;
+    };
+    const auto putRecord = [&putLong] (uint8_t* dst, const uint32_t lbn, const uint32_t size, const std::string& name, const uint16_t attributes, const uint8_t number) {
+        putLong(dst + 6, lbn);
+        putLong(dst + 14, size);
+        dst[32] = name.size();
+        std::copy(name.begin(), name.end(), dst + 33);
+        const size_t end = 33 + name.size() + (name.size() % 2 == 0); // Padded to an even offset.
+        dst[end + 4] = attributes >> 8;
+        dst[end + 5] = attributes;
+        dst[end + 8] = number;
+        dst[0] = end + 10; // Record length.
+        return dst + dst[0];
+    };
+    const auto putDirectory = [] (uint8_t* dst) {
+        dst[0] = dst[34] = 34; // The current and parent directories.
+        return dst + 68;
+    };
+
+    // Volume descriptor.
+    uint8_t* data = sectors[16].data() + DATA_OFFSET;
+    putLong(data + 148, 17);
+    putString(data + 190, "Test Disc", 128);
+    putString(data + 574, "cdi_main", 128);
+    setSubmode(16, cdid | cdieor);
+
+    // Path table, the root directory has an empty name.
+    data = sectors[17].data() + DATA_OFFSET;
+    data[0] = 1;
+    putLong(data + 2, 18);
+    data[7] = 1; // Parent.
+    setSubmode(17, cdid | cdieof);
+
+    data = putDirectory(sectors[18].data() + DATA_OFFSET);
+    data = putRecord(data, 20, 2048, "cdi_main", 0x0111, 1);
+    putRecord(data, 19, 2048, "AUDIO", 0x8000, 0);
+    setSubmode(18, cdid | cdieof);
+
+    data = putDirectory(sectors[19].data() + DATA_OFFSET);
+    putRecord(data, 21, 2324, "music", 0x0111, 2);
+    setSubmode(19, cdid | cdieof);
+
+    setSubmode(20, cdid | cdieof);
+    setSubmode(21, cdia | cdiform | cdirt | cdieor | cdieof);
+
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    for(const std::array<uint8_t, 2352>& sector : sectors)
+        out.write(reinterpret_cast<const char*>(sector.data()), sector.size());
+}
+
+TEST_CASE("Catalogue JSON", "[DiscScanner]")
+{
+    const auto write = [] (const std::string& gameName) {
+        std::ostringstream out;
+        writeCatalogueJSON(out, makeCatalogue(gameName, "CMDS/cdi_main"));
+        return out.str();
+    };
+
+    SECTION("Format")
+    {
+        REQUIRE(write("Game") ==
+            "[\n"
+            "  {\n"
+            "    \"path\": \"disc.bin\",\n"
+            "    \"fileSize\": 2352,\n"
+            "    \"opened\": true,\n"
+            "    \"gameName\": \"Game\",\n"
+            "    \"mainModule\": \"cdi_main\",\n"
+            "    \"sectors\": {\"total\": 1, \"data\": 1, \"audio\": 0, \"video\": 0, \"empty\": 0, \"form2\": 0, \"realTime\": 0, \"endOfRecord\": 0, \"endOfFile\": 1},\n"
+            "    \"files\": [\n"
+            "      {\"path\": \"CMDS/cdi_main\", \"lbn\": 20, \"size\": 2048, \"attributes\": 31, \"number\": 1}\n"
+            "    ]\n"
+            "  }\n"
+            "]\n");
+
+        std::ostringstream out;
+        writeCatalogueJSON(out, {});
+        REQUIRE(out.str() == "[]\n");
+    }
+
+    SECTION("Strings")
+    {
+        const auto gameName = [&write] (const std::string& name) {
+            const std::string json = write(name);
+            const size_t begin = json.find("\"gameName\": ") + 12;
+            return json.substr(begin, json.find(",\n", begin) - begin);
+        };
+
+        REQUIRE(gameName("A \"B\" \\ C") == "\"A \\\"B\\\" \\\\ C\"");
+        REQUIRE(gameName("A\nB\x1F\x7F") == "\"A\\u000AB\\u001F\x7F\"");
+
+        // Valid UTF-8 is kept, other bytes are ISO 8859-1.
+        REQUIRE(gameName("Caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x8E\xAE") == "\"Caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x8E\xAE\"");
+        REQUIRE(gameName("Caf\xE9") == "\"Caf\\u00E9\"");
+        REQUIRE(gameName("\xC3") == "\"\\u00C3\"");
+        REQUIRE(gameName("\xC0\xAF") == "\"\\u00C0\\u00AF\""); // Overlong.
+        REQUIRE(gameName("\xED\xA0\x80") == "\"\\u00ED\\u00A0\\u0080\""); // Surrogate.
+    }
+}
+
+TEST_CASE("Catalogue CSV", "[DiscScanner]")
+{
+    std::ostringstream out;
+    writeCatalogueCSV(out, makeCatalogue("Game, \"The\"", "CMDS/cdi_main"));
+    REQUIRE(out.str() ==
+        "path,fileSize,opened,gameName,mainModule,files,sectors,data,audio,video,empty,form2,realTime,endOfRecord,endOfFile\n"
+        "disc.bin,2352,1,\"Game, \"\"The\"\"\",cdi_main,1,1,1,0,0,0,0,0,0,1\n");
+}
+
+TEST_CASE("Disc library scan", "[DiscScanner]")
+{
+    // Images that are not CD-I discs are reported as not opened, each image is reported for each of its paths.
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "cedimu_test_scanner";
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path image = directory / "blank.bin";
+    {
+        std::ofstream out(image, std::ios::out | std::ios::binary);
+        const std::array<char, 2352> sector{};
+        for(int i = 0; i < 20; i++)
+            out.write(sector.data(), sector.size());
+    }
+
+    const std::vector<std::filesystem::path> paths{image, directory / "missing.bin", directory / "." / "blank.bin", image};
+    const std::vector<DiscCatalogueEntry> catalogue = scanDiscLibrary(paths, 2);
+    REQUIRE(catalogue.size() == paths.size());
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        REQUIRE(catalogue[i].path == paths[i]);
+        REQUIRE_FALSE(catalogue[i].opened);
+    }
+    REQUIRE(catalogue[0].fileSize == 20 * 2352);
+    REQUIRE(catalogue[1].fileSize == 0);
+    REQUIRE(catalogue[2].fileSize == 20 * 2352);
+    REQUIRE(catalogue[3].fileSize == 20 * 2352);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Disc scan", "[DiscScanner]")
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "cedimu_test_scan";
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path image = directory / "disc.bin";
+    const std::filesystem::path indexPath = image.string() + ".sectors";
+    writeCDIImage(image);
+
+    for(const bool saveSectorIndex : {false, true})
+    {
+        const DiscCatalogueEntry entry = scanDisc(image, saveSectorIndex);
+        REQUIRE(entry.path == image);
+        REQUIRE(entry.fileSize == 22 * 2352);
+        REQUIRE(entry.opened);
+        REQUIRE(entry.gameName == "Test Disc");
+        REQUIRE(entry.mainModule == "cdi_main");
+
+        REQUIRE(entry.files.size() == 2);
+        REQUIRE(entry.files[0].path == "cdi_main");
+        REQUIRE(entry.files[0].lbn == 20);
+        REQUIRE(entry.files[0].size == 2048);
+        REQUIRE(entry.files[0].attributes == 0x0111);
+        REQUIRE(entry.files[0].number == 1);
+        REQUIRE(entry.files[1].path == "AUDIO/music");
+        REQUIRE(entry.files[1].lbn == 21);
+        REQUIRE(entry.files[1].size == 2324);
+        REQUIRE(entry.files[1].number == 2);
+
+        const DiscSectorStats& stats = entry.sectors;
+        REQUIRE(stats.total == 22);
+        REQUIRE(stats.data == 5);
+        REQUIRE(stats.audio == 1);
+        REQUIRE(stats.video == 0);
+        REQUIRE(stats.empty == 16);
+        REQUIRE(stats.form2 == 1);
+        REQUIRE(stats.realTime == 1);
+        REQUIRE(stats.endOfRecord == 2);
+        REQUIRE(stats.endOfFile == 5);
+
+        // The sector index is only saved next to the image when requested.
+        REQUIRE(std::filesystem::exists(indexPath) == saveSectorIndex);
+    }
+
+    std::filesystem::remove_all(directory);
+}
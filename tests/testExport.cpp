@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <CDIDisc.hpp>
+#include <common/Audio.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+static constexpr uint32_t SECTOR_COUNT = 48;
+
+/** \brief Returns the samples of a WAV file, interleaved if stereo. */
+static std::vector<int16_t> readWAVSamples(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    const std::vector<char> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    if(bytes.size() < Audio::WAVWriter::HEADER_SIZE)
+        return {};
+
+    std::vector<int16_t> samples((bytes.size() - Audio::WAVWriter::HEADER_SIZE) / 2);
+    std::copy_n(bytes.begin() + Audio::WAVWriter::HEADER_SIZE, samples.size() * 2, reinterpret_cast<char*>(samples.data()));
+    return samples;
+}
+
+/** \brief Decodes a stream serially, and returns the samples of each record as written in its WAV file. */
+static std::vector<std::vector<int16_t>> decodeStream(const std::vector<std::array<uint8_t, Audio::SECTOR_DATA_SIZE>>& payloads, const AudioStream& stream)
+{
+    std::vector<std::vector<int16_t>> records;
+    Audio::SamplesDelay delay{};
+    std::vector<int16_t> left(Audio::LEVEL_BC_SECTOR_SAMPLES);
+    std::vector<int16_t> right(Audio::LEVEL_BC_SECTOR_SAMPLES);
+
+    for(const AudioStream::Record& record : stream.records)
+    {
+        std::vector<int16_t>& samples = records.emplace_back();
+        for(const uint32_t lbn : record.sectors)
+        {
+            const size_t count = Audio::decodeAudioSector(delay, record.bps, record.ms, payloads[lbn], left, right);
+            for(size_t i = 0; i < count; i++)
+            {
+                samples.push_back(left[i]);
+                if(record.ms)
+                    samples.push_back(right[i]);
+            }
+        }
+    }
+
+    return records;
+}
+
+TEST_CASE("Audio streams export", "[Export]")
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "cedimu_test_export";
+    const std::filesystem::path imagePath = directory / "disc.bin";
+    std::filesystem::create_directories(directory);
+
+    // Pseudo-random audio payloads.
+    std::vector<std::array<uint8_t, Audio::SECTOR_DATA_SIZE>> payloads(SECTOR_COUNT);
+    {
+        std::ofstream out(imagePath, std::ios::out | std::ios::binary);
+        uint32_t seed = 0x1234'5678;
+        for(std::array<uint8_t, Audio::SECTOR_DATA_SIZE>& payload : payloads)
+        {
+            for(uint8_t& byte : payload)
+            {
+                seed = seed * 1'103'515'245 + 12'345;
+                byte = seed >> 16;
+            }
+
+            std::array<char, SECTOR_SIZE> sector{};
+            std::copy(payload.begin(), payload.end(), sector.begin() + 24);
+            out.write(sector.data(), sector.size());
+        }
+    }
+
+    DiscImage image;
+    REQUIRE(image.Open(imagePath));
+
+    // Two interleaved channels, the first one with a record longer than the blocks written at once.
+    std::vector<AudioStream> streams(2);
+    streams[0] = {(directory / "file").string(), 0, {{0, 0, 0, {}}, {1, 1, 1, {}}}};
+    streams[1] = {(directory / "file").string(), 1, {{0, 0, 1, {}}}};
+    for(uint32_t lbn = 0; lbn < 40; lbn += 2)
+        streams[0].records[0].sectors.push_back(lbn);
+    streams[0].records[1].sectors = {40, 42, 44};
+    for(uint32_t lbn = 1; lbn < SECTOR_COUNT; lbn += 2)
+        streams[1].records[0].sectors.push_back(lbn);
+
+    SECTION("Output")
+    {
+        exportAudioStreams(image, streams);
+
+        for(const AudioStream& stream : streams)
+        {
+            const std::vector<std::vector<int16_t>> expected = decodeStream(payloads, stream);
+            for(size_t record = 0; record < stream.records.size(); record++)
+            {
+                const AudioStream::Record& r = stream.records[record];
+                const std::vector<int16_t> samples = readWAVSamples(Audio::getWAVPath(stream.basename, stream.channel, record, r.bps, r.sf));
+                REQUIRE(!samples.empty());
+                REQUIRE(samples == expected[record]);
+            }
+        }
+    }
+
+    SECTION("Exception in a thread")
+    {
+        // The exception of the thread that decodes the stream is rethrown to the caller.
+        streams[1].basename = (directory / "missing" / "file").string();
+
+        bool thrown = false;
+        try
+        {
+            exportAudioStreams(image, streams);
+        }
+        catch(const std::filesystem::filesystem_error&)
+        {
+            thrown = true;
+        }
+        REQUIRE(thrown);
+    }
+
+    image.Close();
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <CDI.hpp>
+#include <cores/MCD212/MCD212.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+static constexpr uint32_t WHITE = 0xFF'FF'FF'FF;
+static constexpr uint32_t BLUE = 0xFF'00'00'FF;
+static constexpr uint32_t RED = 0xFF'FF'00'00;
+
+/** \brief Runs the MCD212 until the end of the current frame, and returns the given pixel of its screen. */
+static uint32_t runFrame(CDI& cdi, MCD212& mcd212, const size_t line, const size_t x)
+{
+    uint32_t pixel = 0;
+    cdi.m_callbacks.SetOnFrameCompleted([&] (const Video::Plane& screen) {
+        pixel = screen.GetLinePointer(line)[x].AsU32();
+    });
+
+    const uint32_t frame = mcd212.m_totalFrameCount;
+    while(mcd212.m_totalFrameCount == frame)
+        mcd212.IncrementTime(64'000); // One line.
+
+    cdi.m_callbacks.SetOnFrameCompleted(nullptr);
+    return pixel;
+}
+
+/** \brief Runs the MCD212 until the end of the current frame, and returns a copy of its screen. */
+static Video::Plane runFrame(CDI& cdi, MCD212& mcd212)
+{
+    Video::Plane screen;
+    cdi.m_callbacks.SetOnFrameCompleted([&] (const Video::Plane& frame) {
+        screen = frame;
+    });
+
+    const uint32_t frame = mcd212.m_totalFrameCount;
+    while(mcd212.m_totalFrameCount == frame)
+        mcd212.IncrementTime(64'000); // One line.
+
+    cdi.m_callbacks.SetOnFrameCompleted(nullptr);
+    return screen;
+}
+
+/** \brief Writes a control instruction in RAM as two words, like the CPU does. */
+static void setInstruction(MCD212& mcd212, const uint32_t addr, const uint32_t instruction)
+{
+    mcd212.SetWord(addr, instruction >> 16, BUS_NORMAL);
+    mcd212.SetWord(addr + 2, instruction, BUS_NORMAL);
+}
+
+TEST_CASE("Control program write", "[MCD212]")
+{
+    // The control programs are cached, modifying them in RAM must be seen on the next frame.
+    const std::vector<uint8_t> bios(512 * 1024);
+    std::unique_ptr<CDI> cdi = CDI::NewMono3(OS9::BIOS(bios), {});
+    MCD212 mcd212(*cdi, OS9::BIOS(bios), true, Video::RendererBackend::Software);
+
+    for(int i = 0; i < 4; i++) // The first reads after reset are from the BIOS (memory swap).
+        mcd212.GetWord(0, BUS_NORMAL);
+
+    SECTION("ICA")
+    {
+        mcd212.SetWord(0x4FFFF2, 0x8200, BUS_NORMAL); // DCR1: display enabled, ICA 1 enabled.
+        setInstruction(mcd212, 0x400, 0xD800'000F); // Backdrop white.
+        setInstruction(mcd212, 0x404, 0); // Stop.
+
+        REQUIRE(runFrame(*cdi, mcd212, 0, 100) == WHITE);
+        REQUIRE(runFrame(*cdi, mcd212, 0, 100) == WHITE); // Executed from the cache.
+
+        mcd212.SetWord(0x402, 0x0009, BUS_NORMAL); // Backdrop blue.
+        REQUIRE(runFrame(*cdi, mcd212, 0, 100) == BLUE);
+
+        mcd212.SetByte(0x403, 0x0C, BUS_NORMAL); // Backdrop red.
+        REQUIRE(runFrame(*cdi, mcd212, 0, 100) == RED);
+    }
+
+    SECTION("DCA")
+    {
+        mcd212.SetWord(0x4FFFF2, 0x8300, BUS_NORMAL); // DCR1: display enabled, ICA 1 and DCA 1 enabled.
+        setInstruction(mcd212, 0x400, 0x2000'0800); // Reload DCP 0x800.
+        setInstruction(mcd212, 0x404, 0xD800'000F); // Backdrop white.
+        setInstruction(mcd212, 0x408, 0); // Stop.
+        setInstruction(mcd212, 0x800, 0xD800'0009); // Backdrop blue.
+        setInstruction(mcd212, 0x804, 0x2000'0800); // Reload DCP 0x800, the same DCA on every line.
+
+        // The DCA is executed at the end of each line.
+        REQUIRE(runFrame(*cdi, mcd212, 0, 100) == WHITE);
+        REQUIRE(runFrame(*cdi, mcd212, 10, 100) == BLUE);
+
+        mcd212.SetByte(0x803, 0x0C, BUS_NORMAL); // Backdrop red.
+        REQUIRE(runFrame(*cdi, mcd212, 10, 100) == RED);
+
+        setInstruction(mcd212, 0x800, 0x1000'0000); // No operation, the backdrop set by the ICA is kept.
+        REQUIRE(runFrame(*cdi, mcd212, 10, 100) == WHITE);
+    }
+}
+
+TEST_CASE("Interlaced fields", "[MCD212]")
+{
+    // Each field only draws every other line, the other field must be kept from the previous frame.
+    const std::vector<uint8_t> bios(512 * 1024);
+    std::unique_ptr<CDI> cdi = CDI::NewMono3(OS9::BIOS(bios), {});
+    MCD212 mcd212(*cdi, OS9::BIOS(bios), true, Video::RendererBackend::Software);
+
+    for(int i = 0; i < 4; i++) // The first reads after reset are from the BIOS (memory swap).
+        mcd212.GetWord(0, BUS_NORMAL);
+
+    mcd212.SetWord(0x4FFFF2, 0x9200, BUS_NORMAL); // DCR1: display enabled, interlaced, ICA 1 enabled.
+    setInstruction(mcd212, 0x404, 0); // Stop.
+
+    // Both fields white. The screen size is only set by the even field.
+    setInstruction(mcd212, 0x400, 0xD800'000F);
+    for(int i = 0; i < 3; i++)
+        runFrame(*cdi, mcd212);
+    Video::Plane previous = runFrame(*cdi, mcd212);
+
+    const std::array<uint16_t, 4> colors{0x9, 0xC, 0xA, 0xF}; // Blue, red, green, white.
+    for(size_t i = 0; i < 2 * colors.size(); i++)
+    {
+        setInstruction(mcd212, 0x400, 0xD800'0000 | colors[i % colors.size()]);
+        const Video::Plane screen = runFrame(*cdi, mcd212);
+        REQUIRE(screen.m_height > 100);
+
+        // The backdrop changes on every frame, so only the field drawn in this frame differs from the previous one.
+        const bool evenChanged = screen.GetLinePointer(100)[100] != previous.GetLinePointer(100)[100];
+        const bool oddChanged = screen.GetLinePointer(101)[100] != previous.GetLinePointer(101)[100];
+        if(i > 0)
+            REQUIRE(evenChanged != oddChanged);
+        else
+            REQUIRE_FALSE(evenChanged && oddChanged);
+
+        previous = screen;
+    }
+}
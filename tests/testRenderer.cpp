@@ -1,6 +1,10 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <Video/FrameExchange.hpp>
+#include <Video/FrameRecorder.hpp>
+#include <Video/RendererNull.hpp>
 #include <Video/RendererSoftware.hpp>
+#include <Video/RenderThread.hpp>
 #if LIBCEDIMU_ENABLE_RENDERERSIMD
 #   include <Video/RendererSIMD.hpp>
 #   define IF_SIMD(code) code;
@@ -10,6 +14,14 @@
 
 #include <algorithm>
 #include <array>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
 using CursorLine = std::array<Video::Pixel, 16>;
 inline constexpr Video::Pixel BLACK = Video::Renderer::BLACK_PIXEL;
@@ -139,6 +151,43 @@ TEST_CASE("Cursor blink", "[Video]")
         REQUIRE(std::equal(rendererSoft.m_cursorPlane.begin(), rendererSoft.m_cursorPlane.begin() + 16, EXPECTED_COMPLEMENT.data()));
         IF_SIMD(REQUIRE(std::equal(rendererSIMD.m_cursorPlane.begin(), rendererSIMD.m_cursorPlane.begin() + 16, EXPECTED_COMPLEMENT.data())))
     }
+
+    SECTION("Overlay")
+    {
+        // No need to test SIMD, as the overlay code is in Renderer.
+        constexpr std::array<uint8_t, 384> LINE{}; // Both planes are OFF.
+        rendererSoft.SetDisplayFormat(Video::Renderer::DisplayFormat::PAL, false, false);
+        rendererSoft.m_backdropColor = 0b1001; // Blue.
+        rendererSoft.SetCursorEnabled(true);
+        rendererSoft.SetCursorBlink(false, 1, 1);
+        rendererSoft.SetCursorPattern(0, 0xAA55);
+        rendererSoft.SetCursorColor(0b1011); // Cyan
+        rendererSoft.SetCursorPosition(100, 0);
+
+        constexpr CursorLine EXPECTED_ON{
+            CYAN, BLUE, CYAN, BLUE, CYAN, BLUE, CYAN, BLUE,
+            BLUE, CYAN, BLUE, CYAN, BLUE, CYAN, BLUE, CYAN,
+        };
+        rendererSoft.DrawLine(LINE.data(), LINE.data(), 0);
+        rendererSoft.RenderFrame();
+        REQUIRE(rendererSoft.m_screen.GetLinePointer(0)[99] == BLUE);
+        REQUIRE(std::equal(EXPECTED_ON.cbegin(), EXPECTED_ON.cend(), rendererSoft.m_screen.GetLinePointer(0) + 100));
+        REQUIRE(rendererSoft.m_screen.GetLinePointer(0)[116] == BLUE);
+
+        // Nothing is drawn during the OFF period.
+        rendererSoft.IncrementCursorTime(Video::Renderer::DELTA_50FPS);
+        rendererSoft.DrawLine(LINE.data(), LINE.data(), 0);
+        rendererSoft.RenderFrame();
+        REQUIRE(std::all_of(rendererSoft.m_screen.GetLinePointer(0), rendererSoft.m_screen.GetLinePointer(1), [] (Video::Pixel p) { return p == BLUE; }));
+
+        // The cursor is clipped at the right of the screen.
+        rendererSoft.IncrementCursorTime(Video::Renderer::DELTA_50FPS);
+        rendererSoft.SetCursorPosition(760, 0);
+        rendererSoft.DrawLine(LINE.data(), LINE.data(), 0);
+        rendererSoft.RenderFrame();
+        REQUIRE(std::equal(EXPECTED_ON.cbegin(), EXPECTED_ON.cbegin() + 8, rendererSoft.m_screen.GetLinePointer(0) + 760));
+        REQUIRE(rendererSoft.m_screen.GetLinePointer(0)[759] == BLUE);
+    }
 }
 
 static constexpr uint32_t makeCommand(uint32_t op, bool mf, uint32_t icf, uint32_t pos) noexcept
@@ -198,6 +247,7 @@ static void configureCLUT(Video::Renderer& renderer) noexcept
     renderer.SetDisplayFormat(Video::Renderer::DisplayFormat::PAL, false, false);
     renderer.m_clut[0] = RED.AsU32();
     renderer.m_clut[128] = GREEN.AsU32();
+    renderer.SetPlanesRetained(true); // The tests check the planes.
 }
 
 static constexpr std::array<uint8_t, 384> INPUT_A = [] () {
@@ -430,9 +480,91 @@ TEST_CASE("Matte lower position", "[Video]")
     }
 }
 
+TEST_CASE("Matte beyond the line", "[Video]")
+{
+    // The matte positions go up to 1023, the commands beyond the line must not be executed.
+    Video::RendererSoftware rendererSoft;
+    IF_SIMD(Video::RendererSIMD rendererSIMD)
+
+    const auto drawLines = [&] (Video::Renderer& renderer) {
+        configureCLUT(renderer);
+        renderer.SetDisplayFormat(Video::Renderer::DisplayFormat::NTSCMonitor, false, false); // 720 pixels.
+        renderer.m_transparencyControl[PLANEA] = 0b0100; // Matte flag 1 = true.
+        renderer.m_transparencyControl[PLANEB] = 0b1000; // Never.
+        renderer.m_mix = false;
+        renderer.m_matteNumber = false;
+        renderer.m_icf[PLANEA] = 63;
+        renderer.m_icf[PLANEB] = 63;
+
+        renderer.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
+        renderer.DrawLine(INPUT_A.data(), INPUT_B.data(), 1);
+
+        renderer.m_matteControl[0] = makeCommand(0b1001, true, 0, 0); // Set matte flag 1, plane A hidden.
+        renderer.m_matteControl[1] = makeCommand(0b1000, true, 0, 1000); // Reset matte flag 1 beyond the line.
+        renderer.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
+    };
+
+    drawLines(rendererSoft);
+    IF_SIMD(drawLines(rendererSIMD))
+
+    constexpr std::array<Video::Pixel, 720> EXPECTED_A_0 = [] () {
+        std::array<Video::Pixel, 720> array;
+        std::ranges::fill(array, HIDDEN_RED);
+        return array;
+    }();
+    constexpr std::array<Video::Pixel, 720> EXPECTED_A_1 = [] () {
+        std::array<Video::Pixel, 720> array;
+        std::ranges::fill(array, RED);
+        return array;
+    }();
+
+    REQUIRE(rendererSoft.m_screen.m_width == 720);
+    REQUIRE(std::equal(EXPECTED_A_0.cbegin(), EXPECTED_A_0.cend(), rendererSoft.m_plane[PLANEA].GetLinePointer(0)));
+    IF_SIMD(REQUIRE(std::equal(EXPECTED_A_0.cbegin(), EXPECTED_A_0.cend(), rendererSIMD.m_plane[PLANEA].GetLinePointer(0))))
+
+    // The next line is not modified.
+    REQUIRE(std::equal(EXPECTED_A_1.cbegin(), EXPECTED_A_1.cend(), rendererSoft.m_plane[PLANEA].GetLinePointer(1)));
+    IF_SIMD(REQUIRE(std::equal(EXPECTED_A_1.cbegin(), EXPECTED_A_1.cend(), rendererSIMD.m_plane[PLANEA].GetLinePointer(1))))
+
+    REQUIRE(std::all_of(rendererSoft.m_screen.GetLinePointer(0), rendererSoft.m_screen.GetLinePointer(1), [] (Video::Pixel p) { return p == GREEN; }));
+    IF_SIMD(REQUIRE(std::all_of(rendererSIMD.m_screen.GetLinePointer(0), rendererSIMD.m_screen.GetLinePointer(1), [] (Video::Pixel p) { return p == GREEN; })))
+    REQUIRE(std::all_of(rendererSoft.m_screen.GetLinePointer(1), rendererSoft.m_screen.GetLinePointer(2), [] (Video::Pixel p) { return p == RED; }));
+    IF_SIMD(REQUIRE(std::all_of(rendererSIMD.m_screen.GetLinePointer(1), rendererSIMD.m_screen.GetLinePointer(2), [] (Video::Pixel p) { return p == RED; })))
+}
+
+TEST_CASE("Plane retention", "[Video]")
+{
+    Video::RendererSoftware rendererRetained;
+    Video::RendererSoftware rendererCompact;
+
+    configureOneMatte(rendererRetained);
+    configureOneMatte(rendererCompact);
+    configureCLUT(rendererRetained);
+    configureCLUT(rendererCompact);
+    rendererCompact.SetPlanesRetained(false);
+
+    rendererRetained.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
+    rendererCompact.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
+
+    REQUIRE(rendererRetained.m_plane[PLANEA].size() == Video::Plane::MAX_SIZE);
+    REQUIRE(rendererRetained.m_plane[PLANEA].PixelCount() == 768 * 280);
+    REQUIRE(rendererCompact.m_plane[PLANEA].empty());
+    REQUIRE(rendererCompact.m_plane[PLANEB].empty());
+    REQUIRE(rendererCompact.m_plane[PLANEA].PixelCount() == 0);
+    REQUIRE(std::equal(rendererRetained.m_screen.GetLinePointer(0), rendererRetained.m_screen.GetLinePointer(1), rendererCompact.m_screen.GetLinePointer(0)));
+
+    // Only applied at the beginning of the next frame.
+    rendererRetained.SetPlanesRetained(false);
+    rendererRetained.DrawLine(INPUT_A.data(), INPUT_B.data(), 1);
+    REQUIRE(rendererRetained.m_plane[PLANEA].size() == Video::Plane::MAX_SIZE);
+    rendererRetained.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
+    REQUIRE(rendererRetained.m_plane[PLANEA].empty());
+}
+
 TEST_CASE("Decoding length", "[Video]")
 {
     Video::RendererSoftware rendererSoft;
+    Video::RendererNull rendererNull;
     IF_SIMD(Video::RendererSIMD rendererSIMD)
 
     SECTION("RGB555")
@@ -449,10 +581,13 @@ TEST_CASE("Decoding length", "[Video]")
         };
 
         configure(rendererSoft);
+        configure(rendererNull);
         IF_SIMD(configure(rendererSIMD))
 
         std::pair<uint16_t, uint16_t> resSoft = rendererSoft.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSoft == std::make_pair(INPUT_A.size(), INPUT_B.size()));
+        REQUIRE(rendererSoft.GetLineSize(INPUT_A.data(), INPUT_B.data()) == resSoft);
+        REQUIRE(rendererNull.DrawLine(INPUT_A.data(), INPUT_B.data(), 0) == resSoft);
 #if LIBCEDIMU_ENABLE_RENDERERSIMD
         std::pair<uint16_t, uint16_t> resSIMD = rendererSIMD.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSIMD == std::make_pair(INPUT_A.size(), INPUT_B.size()));
@@ -473,10 +608,13 @@ TEST_CASE("Decoding length", "[Video]")
         };
 
         configure(rendererSoft);
+        configure(rendererNull);
         IF_SIMD(configure(rendererSIMD))
 
         std::pair<uint16_t, uint16_t> resSoft = rendererSoft.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSoft == std::make_pair(INPUT_A.size() / 2, INPUT_B.size() / 2)); // Pixels are duplicated in high res DYUV.
+        REQUIRE(rendererSoft.GetLineSize(INPUT_A.data(), INPUT_B.data()) == resSoft);
+        REQUIRE(rendererNull.DrawLine(INPUT_A.data(), INPUT_B.data(), 0) == resSoft);
 #if LIBCEDIMU_ENABLE_RENDERERSIMD
         std::pair<uint16_t, uint16_t> resSIMD = rendererSIMD.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSIMD == std::make_pair(INPUT_A.size() / 2, INPUT_B.size() / 2));
@@ -497,10 +635,13 @@ TEST_CASE("Decoding length", "[Video]")
         };
 
         configure(rendererSoft);
+        configure(rendererNull);
         IF_SIMD(configure(rendererSIMD))
 
         std::pair<uint16_t, uint16_t> resSoft = rendererSoft.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSoft == std::make_pair(INPUT_A.size(), INPUT_B.size()));
+        REQUIRE(rendererSoft.GetLineSize(INPUT_A.data(), INPUT_B.data()) == resSoft);
+        REQUIRE(rendererNull.DrawLine(INPUT_A.data(), INPUT_B.data(), 0) == resSoft);
 #if LIBCEDIMU_ENABLE_RENDERERSIMD
         std::pair<uint16_t, uint16_t> resSIMD = rendererSIMD.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSIMD == std::make_pair(INPUT_A.size(), INPUT_B.size()));
@@ -521,10 +662,13 @@ TEST_CASE("Decoding length", "[Video]")
         };
 
         configure(rendererSoft);
+        configure(rendererNull);
         IF_SIMD(configure(rendererSIMD))
 
         std::pair<uint16_t, uint16_t> resSoft = rendererSoft.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSoft == std::make_pair(INPUT_A.size() / 2, INPUT_B.size() / 2)); // Two pixels per byte.
+        REQUIRE(rendererSoft.GetLineSize(INPUT_A.data(), INPUT_B.data()) == resSoft);
+        REQUIRE(rendererNull.DrawLine(INPUT_A.data(), INPUT_B.data(), 0) == resSoft);
 #if LIBCEDIMU_ENABLE_RENDERERSIMD
         std::pair<uint16_t, uint16_t> resSIMD = rendererSIMD.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSIMD == std::make_pair(INPUT_A.size() / 2, INPUT_B.size() / 2));
@@ -544,13 +688,343 @@ TEST_CASE("Decoding length", "[Video]")
         };
 
         configure(rendererSoft);
+        configure(rendererNull);
         IF_SIMD(configure(rendererSIMD))
 
         std::pair<uint16_t, uint16_t> resSoft = rendererSoft.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSoft == std::make_pair(INPUT_A.size(), INPUT_B.size()));
+        REQUIRE(rendererSoft.GetLineSize(INPUT_A.data(), INPUT_B.data()) == resSoft);
+        REQUIRE(rendererNull.DrawLine(INPUT_A.data(), INPUT_B.data(), 0) == resSoft);
 #if LIBCEDIMU_ENABLE_RENDERERSIMD
         std::pair<uint16_t, uint16_t> resSIMD = rendererSIMD.DrawLine(INPUT_A.data(), INPUT_B.data(), 0);
         REQUIRE(resSIMD == std::make_pair(INPUT_A.size(), INPUT_B.size()));
 #endif
     }
 }
+
+TEST_CASE("Null renderer", "[Video]")
+{
+    Video::RendererNull rendererNull;
+    configureCLUT(rendererNull);
+    rendererNull.SetCursorEnabled(true);
+    rendererNull.SetCursorPattern(0, 0xFFFF);
+    rendererNull.SetCursorColor(0b1011);
+
+    for(uint16_t line = 0; line < 280; line++)
+        REQUIRE(rendererNull.DrawLine(INPUT_A.data(), INPUT_B.data(), line) == std::make_pair<uint16_t, uint16_t>(384, 384));
+
+    // The frame has the size of the display but nothing is drawn, not even the cursor.
+    const Video::Plane& screen = rendererNull.RenderFrame();
+    REQUIRE(screen.m_width == 768);
+    REQUIRE(screen.m_height == 280);
+    REQUIRE(std::all_of(screen.begin(), screen.begin() + screen.PixelCount(), [] (Video::Pixel p) { return p.AsU32() == 0; }));
+}
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+/** \brief Returns a random Run-length line whose runs end exactly at the end of the line. */
+static std::vector<uint8_t> makeRunLengthLine(std::mt19937& rng, const uint16_t width, const bool rl3)
+{
+    std::vector<uint8_t> line;
+    const uint16_t step = rl3 ? 2 : 1; // RL3 counts pairs of pixels.
+    for(uint16_t x = 0; x < width;)
+    {
+        const uint8_t color = rng() & (rl3 ? 0x77 : 0x7F);
+        const uint16_t remaining = (width - x) / step;
+        const uint16_t count = std::min<uint16_t>(rng() % 40 + 1, remaining);
+        if(count == 1)
+            line.push_back(color);
+        else
+        {
+            line.push_back(color | 0x80);
+            line.push_back(count == remaining ? 0 : count); // 0 is until the end of the line.
+        }
+        x += count * step;
+    }
+    return line;
+}
+
+TEST_CASE("SIMD dispatch", "[Video]")
+{
+    using ImageType = Video::Renderer::ImageType;
+    using BitsPerPixel = Video::Renderer::BitsPerPixel;
+    using DisplayFormat = Video::Renderer::DisplayFormat;
+
+    struct Configuration
+    {
+        Video::ImageCodingMethod icmA;
+        Video::ImageCodingMethod icmB;
+        ImageType typeB;
+        BitsPerPixel bpsB;
+        DisplayFormat format;
+        bool mix;
+        std::array<uint8_t, 2> transparency;
+        bool twoMattes;
+    };
+
+    constexpr std::array<Configuration, 6> CONFIGURATIONS{{
+        {ICM(CLUT7), ICM(CLUT7), ImageType::Normal, BitsPerPixel::Normal8, DisplayFormat::PAL, true, {0b0001, 0b1000}, false},
+        {ICM(DYUV), ICM(CLUT7), ImageType::Normal, BitsPerPixel::Normal8, DisplayFormat::NTSCMonitor, false, {0b1100, 0b1011}, true},
+        {ICM(CLUT4), ICM(DYUV), ImageType::Normal, BitsPerPixel::Normal8, DisplayFormat::NTSCTV, false, {0b0101, 0b0011}, false},
+        {ICM(OFF), ICM(RGB555), ImageType::Normal, BitsPerPixel::Normal8, DisplayFormat::PAL, true, {0b0000, 0b1001}, false},
+        {ICM(CLUT8), ICM(CLUT7), ImageType::RunLength, BitsPerPixel::Normal8, DisplayFormat::NTSCMonitor, true, {0b0110, 0b0001}, true},
+        {ICM(CLUT77), ICM(CLUT7), ImageType::RunLength, BitsPerPixel::Double4, DisplayFormat::PAL, false, {0b1001, 0b0011}, false},
+    }};
+
+    std::mt19937 rng{0xCED1};
+    std::array<uint32_t, 256> clut;
+    std::ranges::generate(clut, [&] { return rng() & 0xFF'FF'FF; });
+
+    const auto configure = [&] (Video::Renderer& renderer, const Configuration& config) {
+        if(config.twoMattes)
+            configureTwoMattes(renderer);
+        else
+            configureOneMatte(renderer);
+        renderer.m_clut = clut;
+        renderer.m_backdropColor = 0b1010;
+        renderer.m_codingMethod = {config.icmA, config.icmB};
+        renderer.m_imageType[PLANEB] = config.typeB;
+        renderer.m_bps[PLANEB] = config.bpsB;
+        renderer.m_dyuvInitialValue = {0x00'80'10'80, 0x00'10'80'80};
+        renderer.m_mix = config.mix;
+        renderer.m_transparencyControl = config.transparency;
+        renderer.m_transparentColorRgb = {clut[3], clut[130]};
+        renderer.m_maskColorRgb = {0x00'04'00'00, 0};
+        renderer.SetDisplayFormat(config.format, false, false);
+        renderer.SetPlanesRetained(true);
+    };
+
+    for(const Video::SIMDTarget target : {Video::SIMDTarget::Default, Video::SIMDTarget::SSE42, Video::SIMDTarget::AVX2})
+    {
+        if(target > Video::getSIMDTarget())
+            continue; // Not supported by the CPU or not built.
+
+        for(const Configuration& config : CONFIGURATIONS)
+        {
+            Video::RendererSoftware rendererSoft;
+            std::unique_ptr<Video::Renderer> rendererSIMD = Video::makeRendererSIMD(target);
+            configure(rendererSoft, config);
+            configure(*rendererSIMD, config);
+
+            for(uint16_t line = 0; line < 4; line++)
+            {
+                std::vector<uint8_t> lineA(1536);
+                std::ranges::generate(lineA, [&] { return static_cast<uint8_t>(rng()); });
+                std::vector<uint8_t> lineB(1536);
+                if(config.typeB == ImageType::RunLength)
+                    lineB = makeRunLengthLine(rng, config.bpsB == BitsPerPixel::Double4 ? 768 : 384, config.bpsB == BitsPerPixel::Double4);
+                else
+                    std::ranges::generate(lineB, [&] { return static_cast<uint8_t>(rng()); });
+
+                const std::pair<uint16_t, uint16_t> resSoft = rendererSoft.DrawLine(lineA.data(), lineB.data(), line);
+                REQUIRE(rendererSIMD->DrawLine(lineA.data(), lineB.data(), line) == resSoft);
+
+                const uint16_t width = rendererSoft.m_screen.m_width;
+                REQUIRE(rendererSIMD->m_screen.m_width == width);
+                REQUIRE(std::equal(rendererSoft.m_plane[PLANEA].GetLinePointer(line), rendererSoft.m_plane[PLANEA].GetLinePointer(line) + width, rendererSIMD->m_plane[PLANEA].GetLinePointer(line)));
+                REQUIRE(std::equal(rendererSoft.m_plane[PLANEB].GetLinePointer(line), rendererSoft.m_plane[PLANEB].GetLinePointer(line) + width, rendererSIMD->m_plane[PLANEB].GetLinePointer(line)));
+                REQUIRE(std::equal(rendererSoft.m_screen.GetLinePointer(line), rendererSoft.m_screen.GetLinePointer(line) + width, rendererSIMD->m_screen.GetLinePointer(line)));
+            }
+        }
+    }
+}
+#endif // LIBCEDIMU_ENABLE_RENDERERSIMD
+
+TEST_CASE("Render thread matte ICF", "[Video]")
+{
+    // The ICF set by a matte command is kept on the next lines until the DCP loads it again,
+    // the render thread must draw the same frame as the synchronous renderer.
+    constexpr uint16_t LINES = 4;
+    const auto configure = [] (Video::Renderer& renderer) {
+        renderer.m_transparencyControl[PLANEA] = 0b1000; // Never.
+        renderer.m_transparencyControl[PLANEB] = 0b1000; // Never.
+        renderer.m_mix = false;
+        renderer.m_planeOrder = false; // A in front of B.
+        renderer.m_matteNumber = false;
+        renderer.m_icf[PLANEA] = 63;
+        renderer.m_icf[PLANEB] = 63;
+        renderer.m_matteControl[0] = makeCommand(0b0100, false, 31, 100); // ICF A 31.
+        configureCLUT(renderer);
+    };
+    constexpr uint32_t LOAD_ICF_A = 0xDB00'003F; // ICF A 63.
+
+    Video::RendererSoftware rendererSync;
+    configure(rendererSync);
+    for(uint16_t line = 0; line < LINES; line++)
+    {
+        rendererSync.DrawLine(INPUT_A.data(), INPUT_B.data(), line);
+        if(line == 1)
+            rendererSync.ExecuteDCPInstruction<PLANEA>(LOAD_ICF_A);
+    }
+    rendererSync.RenderFrame();
+
+    REQUIRE(rendererSync.m_screen.GetLinePointer(0)[0] == RED);
+    REQUIRE(rendererSync.m_screen.GetLinePointer(0)[100] == HALF_RED);
+    REQUIRE(rendererSync.m_screen.GetLinePointer(1)[0] == HALF_RED); // Kept from the previous line.
+    REQUIRE(rendererSync.m_screen.GetLinePointer(2)[0] == RED); // Loaded by the DCP.
+    REQUIRE(rendererSync.m_screen.GetLinePointer(3)[0] == HALF_RED);
+
+    Video::Plane screen{};
+    {
+        Video::RenderThread renderThread{std::make_unique<Video::RendererSoftware>(), [&screen] (const Video::Plane& frame) {
+            screen = frame;
+        }};
+
+        Video::RendererSoftware producer;
+        configure(producer);
+        for(uint16_t line = 0; line < LINES; line++)
+        {
+            renderThread.PushLine(producer, INPUT_A.data(), INPUT_A.size(), INPUT_B.data(), INPUT_B.size(), line);
+            if(line == 1)
+                producer.ExecuteDCPInstruction<PLANEA>(LOAD_ICF_A);
+        }
+        renderThread.PushFrame(producer);
+        renderThread.Flush();
+    }
+
+    REQUIRE(screen.m_width == rendererSync.m_screen.m_width);
+    for(uint16_t line = 0; line < LINES; line++)
+        REQUIRE(std::equal(screen.GetLinePointer(line), screen.GetLinePointer(line + 1), rendererSync.m_screen.GetLinePointer(line)));
+}
+
+TEST_CASE("Frame exchange", "[Video]")
+{
+    Video::FrameExchange exchange;
+
+    SECTION("Latest frame")
+    {
+        REQUIRE_FALSE(exchange.HasNewFrame());
+        REQUIRE(exchange.Acquire().PixelCount() == 0);
+
+        Video::Plane screen{16, 16};
+        for(const Video::Pixel color : {RED, GREEN, BLUE})
+        {
+            std::fill_n(screen.begin(), screen.PixelCount(), color);
+            exchange.Publish(screen);
+            REQUIRE(screen[0] == color); // The producer keeps its frame.
+        }
+
+        REQUIRE(exchange.HasNewFrame());
+        const Video::Plane& frame = exchange.Acquire();
+        REQUIRE_FALSE(exchange.HasNewFrame());
+        REQUIRE(frame.PixelCount() == 16 * 16);
+        REQUIRE(std::all_of(frame.GetSpan().begin(), frame.GetSpan().end(), [] (Video::Pixel p) { return p == BLUE; }));
+
+        // The acquired frame is not modified by the producer.
+        std::fill_n(screen.begin(), screen.PixelCount(), RED);
+        exchange.Publish(screen);
+        REQUIRE(std::all_of(frame.GetSpan().begin(), frame.GetSpan().end(), [] (Video::Pixel p) { return p == BLUE; }));
+        REQUIRE(exchange.Acquire()[0] == RED);
+    }
+
+    SECTION("Concurrent")
+    {
+        constexpr uint32_t FRAMES = 10'000;
+
+        std::thread producer([&exchange] () {
+            Video::Plane screen{64, 64};
+            for(uint32_t f = 1; f <= FRAMES; ++f)
+            {
+                std::fill_n(screen.begin(), screen.PixelCount(), Video::Pixel{f});
+                exchange.Publish(screen);
+            }
+        });
+
+        // Every acquired frame must be complete, and more recent than the previous one.
+        uint32_t last = 0;
+        bool consistent = true;
+        while(last < FRAMES)
+        {
+            const Video::Plane& frame = exchange.Acquire();
+            if(frame.PixelCount() == 0)
+                continue;
+
+            const uint32_t f = frame[0].AsU32();
+            consistent &= f >= last;
+            consistent &= std::all_of(frame.GetSpan().begin(), frame.GetSpan().end(), [f] (Video::Pixel p) { return p.AsU32() == f; });
+            last = f;
+        }
+        producer.join();
+
+        REQUIRE(consistent);
+    }
+}
+
+TEST_CASE("Frame recorder", "[Video]")
+{
+    Video::Plane frame{16, 8};
+    std::fill_n(frame.begin(), frame.PixelCount(), BLUE);
+    std::fill_n(frame.begin() + 20, 5, RED);
+    frame[40] = GREEN;
+
+    SECTION("Delta-RLE")
+    {
+        std::vector<uint8_t> data;
+        Video::encodeDeltaRLE(frame.GetSpan(), {}, data);
+        REQUIRE(data.size() < frame.PixelCount() * sizeof(Video::Pixel));
+
+        Video::Plane decoded{16, 8};
+        REQUIRE(Video::decodeDeltaRLE(data, {decoded.data(), decoded.PixelCount()}));
+        REQUIRE(std::equal(decoded.GetSpan().begin(), decoded.GetSpan().end(), frame.GetSpan().begin()));
+
+        // Only the changed pixels are stored.
+        Video::Plane next = frame;
+        next[3] = GREEN;
+        next[4] = MAGENTA;
+        data.clear();
+        Video::encodeDeltaRLE(next.GetSpan(), frame.GetSpan(), data);
+        REQUIRE(data.size() == 3 * 2 + 2 * sizeof(Video::Pixel)); // Skip, literal, skip.
+
+        REQUIRE(Video::decodeDeltaRLE(data, {decoded.data(), decoded.PixelCount()}));
+        REQUIRE(std::equal(decoded.GetSpan().begin(), decoded.GetSpan().end(), next.GetSpan().begin()));
+
+        data.pop_back();
+        REQUIRE_FALSE(Video::decodeDeltaRLE(data, {decoded.data(), decoded.PixelCount()}));
+    }
+
+    SECTION("Y4M")
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "cedimu_test_recorder.y4m";
+        {
+            Video::FrameRecorder recorder{path, Video::RecordingFormat::Y4M, 50, 1};
+            REQUIRE(recorder.IsGood());
+            REQUIRE(recorder.PushFrame(frame));
+            recorder.Stop();
+            REQUIRE(recorder.GetWrittenFrames() == 1);
+            REQUIRE_FALSE(recorder.PushFrame(frame));
+        }
+
+        std::ifstream file{path, std::ios::binary};
+        const std::string content{std::istreambuf_iterator<char>{file}, {}};
+        const std::string header{"YUV4MPEG2 W16 H8 F50:1 Ip A0:0 C420jpeg XCOLORRANGE=LIMITED\nFRAME\n"};
+        REQUIRE(content.starts_with(header));
+        REQUIRE(content.size() == header.size() + 16 * 8 * 3 / 2);
+        file.close();
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Raw")
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "cedimu_test_recorder.raw";
+        constexpr uint64_t FRAMES = 100;
+        uint64_t pushed = 0;
+        {
+            Video::FrameRecorder recorder{path, Video::RecordingFormat::Raw, 50, 1};
+            for(uint64_t f = 0; f < FRAMES; ++f)
+                pushed += recorder.PushFrame(frame);
+            recorder.Stop();
+            REQUIRE(recorder.GetWrittenFrames() == pushed);
+            REQUIRE(recorder.GetDroppedFrames() == FRAMES - pushed);
+        }
+
+        REQUIRE(std::filesystem::file_size(path) == pushed * frame.PixelCount() * sizeof(Video::Pixel));
+
+        std::ifstream index{path.string() + ".idx"};
+        std::string line;
+        std::getline(index, line);
+        std::getline(index, line);
+        REQUIRE(line == "0 0 16 8");
+        index.close();
+        std::filesystem::remove(path);
+        std::filesystem::remove(path.string() + ".idx");
+    }
+}
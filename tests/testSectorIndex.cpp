@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <CDIDisc.hpp>
+#include <DiscImage.hpp>
+#include <SectorIndex.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+/** \brief Writes a raw disc image whose sectors have the given subheaders. */
+static std::filesystem::path writeImage(const std::string& name, const std::vector<SectorInfo>& sectors)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    for(const SectorInfo& info : sectors)
+    {
+        std::array<char, SECTOR_SIZE> sector{};
+        sector[15] = 2; // Mode 2.
+        sector[16] = sector[20] = info.fileNumber;
+        sector[17] = sector[21] = info.channelNumber;
+        sector[18] = sector[22] = info.submode;
+        sector[19] = sector[23] = info.codingInformation;
+        out.write(sector.data(), sector.size());
+    }
+    return path;
+}
+
+TEST_CASE("Sector index", "[SectorIndex]")
+{
+    // File 1 interleaved with file 2, on two channels.
+    const std::vector<SectorInfo> sectors{
+        {0, 0, 0, 0},
+        {1, 0, cdid, 0},
+        {2, 1, cdia, 0},
+        {1, 1, cdiv, 0},
+        {2, 0, cdia | cdieof, 0},
+        {1, 0, cdid, 0},
+        {1, 1, cdiv | cdieor, 0},
+        {1, 0, cdid | cdieof, 0},
+    };
+    const std::filesystem::path imagePath = writeImage("cedimu_test_sector_index.bin", sectors);
+    const std::filesystem::path indexPath = imagePath.string() + ".sectors";
+
+    DiscImage image;
+    REQUIRE(image.Open(imagePath));
+
+    SectorIndex index;
+    index.Build(image);
+    REQUIRE(index.GetSectorCount() == sectors.size());
+    for(uint32_t lbn = 0; lbn < sectors.size(); lbn++)
+        REQUIRE(index[lbn].submode == sectors[lbn].submode);
+
+    SECTION("NextSector")
+    {
+        REQUIRE(index.NextSector(0, 1) == 1);
+        REQUIRE(index.NextSector(1, 1) == 3);
+        REQUIRE(index.NextSector(7, 1) == std::nullopt);
+        REQUIRE(index.NextSector(0, 2) == 2);
+        REQUIRE(index.NextSector(2, 2) == 4);
+        REQUIRE(index.NextSector(0, std::nullopt) == 1);
+
+        REQUIRE(index.NextSector(1, 1, 1) == 3);
+        REQUIRE(index.NextSector(3, 1, 1) == 6);
+        REQUIRE(index.NextSector(3, 1, 0) == 5);
+        REQUIRE(index.NextSector(6, 1, 1) == std::nullopt);
+        REQUIRE(index.NextSector(0, std::nullopt, 1) == 2);
+
+        REQUIRE(index.NextSector(0, 1, std::nullopt, cdiv) == 3);
+        REQUIRE(index.NextSector(3, 1, std::nullopt, cdieor | cdieof) == 6);
+        REQUIRE(index.NextSector(0, std::nullopt, std::nullopt, cdia) == 2);
+    }
+
+    SECTION("NextEndOfFile")
+    {
+        REQUIRE(index.NextEndOfFile(0) == 4);
+        REQUIRE(index.NextEndOfFile(4) == 7);
+        REQUIRE(index.NextEndOfFile(7) == std::nullopt);
+    }
+
+    SECTION("Load and save")
+    {
+        const uint64_t hash = SectorIndex::ComputeImageHash(image, imagePath);
+        REQUIRE(index.Save(indexPath, hash));
+
+        SectorIndex loaded;
+        REQUIRE(loaded.Load(indexPath, hash));
+        REQUIRE(loaded.GetSectorCount() == sectors.size());
+        for(uint32_t lbn = 0; lbn < sectors.size(); lbn++)
+        {
+            REQUIRE(loaded[lbn].fileNumber == sectors[lbn].fileNumber);
+            REQUIRE(loaded[lbn].channelNumber == sectors[lbn].channelNumber);
+            REQUIRE(loaded[lbn].submode == sectors[lbn].submode);
+            REQUIRE(loaded[lbn].codingInformation == sectors[lbn].codingInformation);
+        }
+        REQUIRE(loaded.NextSector(3, 1, 1) == 6);
+        REQUIRE(loaded.NextEndOfFile(0) == 4);
+
+        REQUIRE_FALSE(loaded.Load(indexPath, hash + 1));
+        REQUIRE(loaded.IsEmpty());
+
+        std::filesystem::remove(indexPath);
+    }
+
+    SECTION("Image hash")
+    {
+        // The same image keeps its index, a modified one invalidates it.
+        const uint64_t hash = SectorIndex::ComputeImageHash(image, imagePath);
+        REQUIRE(SectorIndex::ComputeImageHash(image, imagePath) == hash);
+
+        std::vector<SectorInfo> bigSectors(1000, SectorInfo{1, 0, cdid, 0});
+        const std::filesystem::path bigPath = writeImage("cedimu_test_sector_hash.bin", bigSectors);
+        const std::filesystem::file_time_type time = std::filesystem::last_write_time(bigPath);
+        DiscImage big;
+        REQUIRE(big.Open(bigPath));
+        const uint64_t bigHash = SectorIndex::ComputeImageHash(big, bigPath);
+        REQUIRE(bigHash != hash);
+        big.Close();
+
+        // Only the modification time tells a change past the first sectors.
+        bigSectors[999].submode |= cdieof;
+        writeImage("cedimu_test_sector_hash.bin", bigSectors);
+        std::filesystem::last_write_time(bigPath, time);
+        REQUIRE(big.Open(bigPath));
+        REQUIRE(SectorIndex::ComputeImageHash(big, bigPath) == bigHash);
+        big.Close();
+
+        std::filesystem::last_write_time(bigPath, time + std::chrono::seconds(1));
+        REQUIRE(big.Open(bigPath));
+        REQUIRE(SectorIndex::ComputeImageHash(big, bigPath) != bigHash);
+        big.Close();
+
+        bigSectors[0].fileNumber = 2;
+        writeImage("cedimu_test_sector_hash.bin", bigSectors);
+        std::filesystem::last_write_time(bigPath, time);
+        REQUIRE(big.Open(bigPath));
+        REQUIRE(SectorIndex::ComputeImageHash(big, bigPath) != bigHash);
+        big.Close();
+
+        std::filesystem::remove(bigPath);
+    }
+
+    image.Close();
+    std::filesystem::remove(imagePath);
+}
@@ -1,10 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <Video/PixelFormats.hpp>
 #include <Video/VideoDecoders.hpp>
 #include <Video/VideoDecodersSIMD.hpp>
 
 #include <algorithm>
 #include <array>
+#include <cstring>
+#include <vector>
 
 static constexpr std::array<uint32_t, 256> CLUT = [] {
     std::array<uint32_t, 256> clut{};
@@ -43,6 +46,12 @@ TEST_CASE("RunLength 7", "[Video]")
 
         Video::decodeRunLengthLine<384, false>(DST.data(), SRC_RL7_1_PIXEL_384.data(), CLUT.data());
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeRunLengthLineSIMD<384, false>(DST.data(), SRC_RL7_1_PIXEL_384.data(), CLUT.data());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
     }
 
     SECTION("1 pixel 768")
@@ -57,6 +66,12 @@ TEST_CASE("RunLength 7", "[Video]")
 
         Video::decodeRunLengthLine<WIDTH, false>(DST.data(), SRC_RL7_1_PIXEL_768.data(), CLUT.data());
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeRunLengthLineSIMD<WIDTH, false>(DST.data(), SRC_RL7_1_PIXEL_768.data(), CLUT.data());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
     }
 
     SECTION("384 pixels - 28 pixels continuously increasing width")
@@ -93,6 +108,12 @@ TEST_CASE("RunLength 7", "[Video]")
 
         Video::decodeRunLengthLine<384, false>(DST.data(), SRC_RL7_28_PIXEL_384.data(), CLUT.data());
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeRunLengthLineSIMD<384, false>(DST.data(), SRC_RL7_28_PIXEL_384.data(), CLUT.data());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
     }
 
     SECTION("768 pixels - 39 pixels continuously increasing width")
@@ -126,6 +147,12 @@ TEST_CASE("RunLength 7", "[Video]")
 
         Video::decodeRunLengthLine<WIDTH, false>(DST.data(), SRC_RL7_39_PIXEL_768.data(), CLUT.data());
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeRunLengthLineSIMD<WIDTH, false>(DST.data(), SRC_RL7_39_PIXEL_768.data(), CLUT.data());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
     }
 
     SECTION("384 individual pixels")
@@ -152,6 +179,12 @@ TEST_CASE("RunLength 7", "[Video]")
 
         Video::decodeRunLengthLine<384, false>(DST.data(), SRC_RL7_384_PIXEL_384.data(), CLUT.data());
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeRunLengthLineSIMD<384, false>(DST.data(), SRC_RL7_384_PIXEL_384.data(), CLUT.data());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
     }
 
     SECTION("768 individual pixels")
@@ -176,6 +209,34 @@ TEST_CASE("RunLength 7", "[Video]")
 
         Video::decodeRunLengthLine<WIDTH, false>(DST.data(), SRC_RL7_768_PIXEL_768.data(), CLUT.data());
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeRunLengthLineSIMD<WIDTH, false>(DST.data(), SRC_RL7_768_PIXEL_768.data(), CLUT.data());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
+    }
+    SECTION("Run beyond the line")
+    {
+        // The second run is longer than what remains of the line, nothing must be written after the line.
+        constexpr std::array<uint8_t, 4> SRC_RL7_BEYOND{0x85, 200, 0x86, 200};
+        using GuardedArray = std::array<Video::Pixel, WIDTH + 512>;
+        constexpr GuardedArray EXPECTED = [] {
+            GuardedArray array{};
+            std::fill(array.begin(), array.begin() + 400, 0x0005'0505);
+            std::fill(array.begin() + 400, array.begin() + WIDTH, 0x0006'0606);
+            return array;
+        }();
+        GuardedArray DST{};
+
+        REQUIRE(Video::decodeRunLengthLine<384, false>(DST.data(), SRC_RL7_BEYOND.data(), CLUT.data()) == SRC_RL7_BEYOND.size());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = GuardedArray{};
+        REQUIRE(Video::decodeRunLengthLineSIMD<384, false>(DST.data(), SRC_RL7_BEYOND.data(), CLUT.data()) == SRC_RL7_BEYOND.size());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
     }
 }
 
@@ -197,6 +258,12 @@ TEST_CASE("RunLength 3", "[Video]")
 
         Video::decodeRunLengthLine<WIDTH, true>(DST.data(), SRC_RL3_1_PIXEL.data(), CLUT.data());
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeRunLengthLineSIMD<WIDTH, true>(DST.data(), SRC_RL3_1_PIXEL.data(), CLUT.data());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
     }
 
     SECTION("28 pixels continuously increasing width")
@@ -234,6 +301,12 @@ TEST_CASE("RunLength 3", "[Video]")
 
         Video::decodeRunLengthLine<WIDTH, true>(DST.data(), SRC_RL3_28_PIXEL.data(), CLUT.data());
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeRunLengthLineSIMD<WIDTH, true>(DST.data(), SRC_RL3_28_PIXEL.data(), CLUT.data());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
     }
 
     SECTION("768 individual pixels")
@@ -261,6 +334,42 @@ TEST_CASE("RunLength 3", "[Video]")
 
         Video::decodeRunLengthLine<WIDTH, true>(DST.data(), SRC_RL3_768_PIXEL.data(), CLUT.data());
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeRunLengthLineSIMD<WIDTH, true>(DST.data(), SRC_RL3_768_PIXEL.data(), CLUT.data());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
+    }
+    SECTION("Run beyond the line")
+    {
+        // The second run is longer than what remains of the line, nothing must be written after the line.
+        constexpr std::array<uint8_t, 4> SRC_RL3_BEYOND{0x91, 200, 0xA3, 200};
+        using GuardedArray = std::array<Video::Pixel, WIDTH + 512>;
+        constexpr GuardedArray EXPECTED = [] {
+            GuardedArray array{};
+            for(size_t i = 0; i < 400; i += 2)
+            {
+                array.at(i) = 0x0001'0101;
+                array.at(i + 1) = 0x0001'0101;
+            }
+            for(size_t i = 400; i < WIDTH; i += 2)
+            {
+                array.at(i) = 0x0002'0202;
+                array.at(i + 1) = 0x0003'0303;
+            }
+            return array;
+        }();
+        GuardedArray DST{};
+
+        REQUIRE(Video::decodeRunLengthLine<WIDTH, true>(DST.data(), SRC_RL3_BEYOND.data(), CLUT.data()) == SRC_RL3_BEYOND.size());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = GuardedArray{};
+        REQUIRE(Video::decodeRunLengthLineSIMD<WIDTH, true>(DST.data(), SRC_RL3_BEYOND.data(), CLUT.data()) == SRC_RL3_BEYOND.size());
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.data()));
+#endif
     }
 }
 
@@ -330,6 +439,12 @@ TEST_CASE("CLUT4", "[Video]")
 
     Video::decodeCLUTLine<768>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT4));
     REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+    DST = PixelArray{};
+    Video::decodeCLUTLineSIMD<768>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT4));
+    REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+#endif
 }
 
 TEST_CASE("CLUT7", "[Video]")
@@ -356,6 +471,12 @@ TEST_CASE("CLUT7", "[Video]")
 
         Video::decodeCLUTLine<384>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT7));
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeCLUTLineSIMD<384>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT7));
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+#endif
     }
 
     SECTION("High Resolution")
@@ -380,6 +501,12 @@ TEST_CASE("CLUT7", "[Video]")
 
         Video::decodeCLUTLine<768>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT7));
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeCLUTLineSIMD<768>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT7));
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+#endif
     }
 }
 
@@ -409,6 +536,12 @@ TEST_CASE("CLUT8", "[Video]")
 
         Video::decodeCLUTLine<384>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT8));
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeCLUTLineSIMD<384>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT8));
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+#endif
     }
 
     SECTION("High resolution")
@@ -433,6 +566,12 @@ TEST_CASE("CLUT8", "[Video]")
 
         Video::decodeCLUTLine<768>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT8));
         REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeCLUTLineSIMD<768>(DST.data(), SRC.data(), CLUT.data(), ICM(CLUT8));
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+#endif
     }
 }
 
@@ -472,6 +611,31 @@ TEST_CASE("DYUV", "[Video]")
 #endif
     }
 
+    SECTION("Every chroma delta matches the reference decoder | 768 bytes")
+    {
+        constexpr std::array<uint8_t, 768> SRC = [] {
+            std::array<uint8_t, 768> array;
+            for(size_t i = 0; i < array.size(); ++i)
+            {
+                array.at(i) = i * 37;
+            }
+            return array;
+        }();
+        PixelArray EXPECTED{};
+        PixelArray DST{};
+
+        Video::decodeDYUVLine<768>(EXPECTED.data(), SRC.data(), 0x0010'8080);
+
+        Video::decodeDYUVLineLUT<768>(DST.data(), SRC.data(), 0x0010'8080);
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+        DST = PixelArray{};
+        Video::decodeDYUVLineSIMD<768>(DST.data(), SRC.data(), 0x0010'8080);
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+#endif
+    }
+
 //     SECTION("RGB incrementing by dequantizer | 384 pixels")
 //     {
 //         constexpr std::array<uint8_t, 384> SRC = [] {
@@ -509,3 +673,193 @@ TEST_CASE("DYUV", "[Video]")
 // #endif
 //     }
 }
+
+#if LIBCEDIMU_ENABLE_RENDERERSIMD
+TEST_CASE("SIMD decoders at 360 and 720 pixels", "[Video]")
+{
+    // The SIMD decoders must match the scalar ones, and not write after the line, for the 360 and 720 widths too.
+    using GuardedArray = std::array<Video::Pixel, WIDTH + 512>;
+    GuardedArray EXPECTED{};
+    GuardedArray DST{};
+
+    std::array<uint8_t, 2 * WIDTH> SRC{};
+    std::array<uint8_t, 2 * WIDTH> SRC_RL{}; // Single pixels and short runs, so the line is not ended early.
+    uint32_t seed = 0x1234'5678;
+    const auto next = [&seed] {
+        seed = seed * 1'103'515'245 + 12'345;
+        return static_cast<uint8_t>(seed >> 16);
+    };
+    for(uint8_t& byte : SRC)
+        byte = next();
+    for(size_t i = 0; i < SRC_RL.size();)
+    {
+        const uint8_t color = next();
+        if(color & 0x80 && i + 1 < SRC_RL.size())
+        {
+            SRC_RL[i++] = color;
+            SRC_RL[i++] = 1 + next() % 5;
+        }
+        else
+            SRC_RL[i++] = color & 0x7F;
+    }
+
+    const auto requireSame = [&] (const uint16_t expected, const uint16_t result) {
+        REQUIRE(result == expected);
+        REQUIRE(std::equal(DST.cbegin(), DST.cend(), EXPECTED.cbegin()));
+        EXPECTED = GuardedArray{};
+        DST = GuardedArray{};
+    };
+
+    SECTION("RunLength 7")
+    {
+        requireSame(Video::decodeRunLengthLine<360, false>(EXPECTED.data(), SRC_RL.data(), CLUT.data()),
+                    Video::decodeRunLengthLineSIMD<360, false>(DST.data(), SRC_RL.data(), CLUT.data()));
+        requireSame(Video::decodeRunLengthLine<720, false>(EXPECTED.data(), SRC_RL.data(), CLUT.data()),
+                    Video::decodeRunLengthLineSIMD<720, false>(DST.data(), SRC_RL.data(), CLUT.data()));
+    }
+
+    SECTION("RunLength 3")
+    {
+        requireSame(Video::decodeRunLengthLine<720, true>(EXPECTED.data(), SRC_RL.data(), CLUT.data()),
+                    Video::decodeRunLengthLineSIMD<720, true>(DST.data(), SRC_RL.data(), CLUT.data()));
+    }
+
+    SECTION("RGB555")
+    {
+        requireSame(Video::decodeRGB555Line<360>(EXPECTED.data(), SRC.data(), SRC.data() + 360),
+                    Video::decodeRGB555LineSIMD<360>(DST.data(), SRC.data(), SRC.data() + 360));
+    }
+
+    SECTION("CLUT")
+    {
+        for(const Video::ImageCodingMethod icm : {ICM(CLUT4), ICM(CLUT7), ICM(CLUT8)})
+        {
+            requireSame(Video::decodeCLUTLine<360>(EXPECTED.data(), SRC.data(), CLUT.data(), icm),
+                        Video::decodeCLUTLineSIMD<360>(DST.data(), SRC.data(), CLUT.data(), icm));
+            requireSame(Video::decodeCLUTLine<720>(EXPECTED.data(), SRC.data(), CLUT.data(), icm),
+                        Video::decodeCLUTLineSIMD<720>(DST.data(), SRC.data(), CLUT.data(), icm));
+        }
+    }
+
+    SECTION("DYUV")
+    {
+        requireSame(Video::decodeDYUVLine<360>(EXPECTED.data(), SRC.data(), 0x0010'8080),
+                    Video::decodeDYUVLineSIMD<360>(DST.data(), SRC.data(), 0x0010'8080));
+        requireSame(Video::decodeDYUVLine<720>(EXPECTED.data(), SRC.data(), 0x0010'8080),
+                    Video::decodeDYUVLineSIMD<720>(DST.data(), SRC.data(), 0x0010'8080));
+    }
+}
+#endif // LIBCEDIMU_ENABLE_RENDERERSIMD
+
+TEST_CASE("Pixel formats", "[Video]")
+{
+    // 7 pixels to also cover the tail of the grouped loops.
+    constexpr std::array<Video::Pixel, 7> PIXELS{
+        0x80FF'0000, 0x0000'FF00, 0xFF00'00FF, 0x1234'5678, 0x00FF'FFFF, 0x0000'0000, 0xFF9A'BCDE,
+    };
+
+    SECTION("Packed")
+    {
+        std::array<uint8_t, PIXELS.size() * 4> dst{};
+        Video::convertToRGB24(PIXELS, dst.data());
+        for(size_t i = 0; i < PIXELS.size(); ++i)
+        {
+            REQUIRE(dst[i * 3] == PIXELS[i].r);
+            REQUIRE(dst[i * 3 + 1] == PIXELS[i].g);
+            REQUIRE(dst[i * 3 + 2] == PIXELS[i].b);
+        }
+
+        Video::convertToRGBA32(PIXELS, dst.data());
+        for(size_t i = 0; i < PIXELS.size(); ++i)
+        {
+            REQUIRE(dst[i * 4] == PIXELS[i].r);
+            REQUIRE(dst[i * 4 + 1] == PIXELS[i].g);
+            REQUIRE(dst[i * 4 + 2] == PIXELS[i].b);
+            REQUIRE(dst[i * 4 + 3] == PIXELS[i].a);
+        }
+
+        Video::convertToBGRA32(PIXELS, dst.data());
+        for(size_t i = 0; i < PIXELS.size(); ++i)
+        {
+            REQUIRE(dst[i * 4] == PIXELS[i].b);
+            REQUIRE(dst[i * 4 + 1] == PIXELS[i].g);
+            REQUIRE(dst[i * 4 + 2] == PIXELS[i].r);
+            REQUIRE(dst[i * 4 + 3] == PIXELS[i].a);
+        }
+
+        Video::convertToAlpha8(PIXELS, dst.data());
+        for(size_t i = 0; i < PIXELS.size(); ++i)
+            REQUIRE(dst[i] == PIXELS[i].a);
+
+        std::array<uint16_t, PIXELS.size()> rgb565{};
+        Video::convertToRGB565(PIXELS, rgb565.data());
+        REQUIRE(rgb565[0] == 0xF800);
+        REQUIRE(rgb565[1] == 0x07E0);
+        REQUIRE(rgb565[2] == 0x001F);
+        REQUIRE(rgb565[3] == ((0x34 >> 3) << 11 | (0x56 >> 2) << 5 | 0x78 >> 3));
+        REQUIRE(rgb565[4] == 0xFFFF);
+        REQUIRE(rgb565[5] == 0x0000);
+    }
+
+    SECTION("Scaling")
+    {
+        Video::Plane plane{3, 2, 6};
+        std::copy_n(PIXELS.cbegin(), plane.size(), plane.begin());
+
+        for(uint8_t scale = 1; scale <= Video::MAX_CONVERSION_SCALE; ++scale)
+        {
+            const size_t width = plane.m_width * scale;
+            std::vector<uint8_t> dst(Video::getConvertedPlaneSize(Video::PixelFormat::BGRA32, plane.m_width, plane.m_height, scale));
+            REQUIRE(dst.size() == width * plane.m_height * scale * 4);
+
+            Video::convertPlane(plane, Video::PixelFormat::BGRA32, dst, scale);
+            for(size_t y = 0; y < plane.m_height * scale; ++y)
+            {
+                for(size_t x = 0; x < width; ++x)
+                {
+                    Video::Pixel pixel;
+                    std::memcpy(&pixel, &dst[(y * width + x) * 4], sizeof pixel);
+                    REQUIRE(pixel == plane.GetLinePointer(y / scale)[x / scale]);
+                }
+            }
+        }
+    }
+
+    SECTION("YUV")
+    {
+        // A 2x2 block of white, a column of red and a line of black.
+        Video::Plane plane{3, 3, 9};
+        plane[0] = 0x00FF'FFFF; plane[1] = 0x00FF'FFFF; plane[2] = 0x00FF'0000;
+        plane[3] = 0x00FF'FFFF; plane[4] = 0x00FF'FFFF; plane[5] = 0x00FF'0000;
+        plane[6] = 0x0000'0000; plane[7] = 0x0000'0000; plane[8] = 0x0000'0000;
+
+        const size_t size = Video::getConvertedPlaneSize(Video::PixelFormat::YUV420, 3, 3);
+        REQUIRE(size == 9 + 2 * 4);
+        REQUIRE(Video::getConvertedPlaneSize(Video::PixelFormat::NV12, 3, 3) == size);
+
+        std::vector<uint8_t> yuv(size);
+        Video::convertPlane(plane, Video::PixelFormat::YUV420, yuv);
+        constexpr std::array<uint8_t, 17> EXPECTED_YUV420{
+            235, 235, 82, 235, 235, 82, 16, 16, 16, // Y
+            128, 90, 128, 128, // U
+            128, 240, 128, 128, // V
+        };
+        REQUIRE(std::equal(yuv.cbegin(), yuv.cend(), EXPECTED_YUV420.cbegin()));
+
+        std::vector<uint8_t> nv12(size);
+        Video::convertPlane(plane, Video::PixelFormat::NV12, nv12);
+        constexpr std::array<uint8_t, 17> EXPECTED_NV12{
+            235, 235, 82, 235, 235, 82, 16, 16, 16, // Y
+            128, 128, 90, 240, 128, 128, 128, 128, // UV
+        };
+        REQUIRE(std::equal(nv12.cbegin(), nv12.cend(), EXPECTED_NV12.cbegin()));
+
+        // Scaling by 2 gives 2x2 blocks of a single input pixel.
+        yuv.resize(Video::getConvertedPlaneSize(Video::PixelFormat::YUV420, 3, 3, 2));
+        Video::convertPlane(plane, Video::PixelFormat::YUV420, yuv, 2);
+        REQUIRE(yuv.size() == 36 + 2 * 9);
+        REQUIRE(yuv[36 + 2] == 90); // U of red.
+        REQUIRE(yuv[45 + 2] == 240); // V of red.
+        REQUIRE(yuv[36 + 8] == 128); // U of black.
+    }
+}